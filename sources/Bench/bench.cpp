@@ -0,0 +1,454 @@
+/**
+ * @file: Bench/bench.cpp
+ * Implementation and entry point for benchmarking of SCL (Simple Compiler) libraries
+ */
+/*
+ * Copyright (C) 2012  Boris Shurygin
+ */
+#include "bench_impl.h"
+
+#if defined(_WIN32)
+#  include <windows.h>
+#  include <psapi.h>
+#else
+#  include <time.h>
+#  include <unistd.h>
+#  include <sys/resource.h>
+#endif
+
+/**
+ * Benchmarks of SCL libraries
+ *
+ * Every benchmark prints one line per measurement in the form
+ * @code
+ bench,<name>,<elements>,<ns_per_op>,<bytes_per_node>,<peak_rss_kb>
+ @endcode
+ * which is meant to be grepped and compared between the runs.
+ * The bytes per node value is the growth of resident memory while building the graph
+ * of the given size divided by the number of nodes, so it accounts for the edges too.
+ * It is left empty for the rows that can't measure it.
+ */
+namespace Bench
+{
+    using namespace Graph;
+
+    /** Smallest number of elements */
+    const UInt64 BENCH_MIN_ELEMENTS = 100000;
+
+    /** Default largest number of elements */
+    const UInt64 BENCH_MAX_ELEMENTS = 100000000;
+
+    /** Largest number of operations in the function that is printed and read back */
+    const UInt64 BENCH_READ_MAX_ELEMENTS = 10000000;
+
+    /** Largest number of objects in the liveness benchmark, the sets take a bit per object and node */
+    const UInt64 BENCH_LIVENESS_MAX_ELEMENTS = 1000000;
+
+    /** Number of CF nodes in the liveness benchmark */
+    const UInt32 BENCH_LIVENESS_NODES = 64;
+
+    /** Sink for the values computed in the benchmarks, prevents the loops from being optimized out */
+    volatile UInt64 sink = 0;
+
+    /** Current time in nanoseconds */
+    static UInt64 timeNs()
+    {
+#if defined(_WIN32)
+        LARGE_INTEGER freq;
+        LARGE_INTEGER cnt;
+        QueryPerformanceFrequency( &freq);
+        QueryPerformanceCounter( &cnt);
+        return (UInt64)( (double)cnt.QuadPart * 1e9 / (double)freq.QuadPart);
+#else
+        struct timespec ts;
+        clock_gettime( CLOCK_MONOTONIC, &ts);
+        return (UInt64)ts.tv_sec * 1000000000 + (UInt64)ts.tv_nsec;
+#endif
+    }
+
+    /** Current resident memory size in bytes */
+    static UInt64 currentRss()
+    {
+#if defined(_WIN32)
+        PROCESS_MEMORY_COUNTERS pmc;
+        GetProcessMemoryInfo( GetCurrentProcess(), &pmc, sizeof( pmc));
+        return (UInt64)pmc.WorkingSetSize;
+#else
+        UInt64 pages = 0;
+        UInt64 resident = 0;
+        FILE *f = fopen( "/proc/self/statm", "r");
+
+        if ( isNullP( f))
+            return 0;
+        if ( fscanf( f, "%llu %llu", &pages, &resident) != 2)
+        {
+            resident = 0;
+        }
+        fclose( f);
+        return resident * (UInt64)sysconf( _SC_PAGESIZE);
+#endif
+    }
+
+    /** Peak resident memory size in kilobytes */
+    static UInt64 peakRssKb()
+    {
+#if defined(_WIN32)
+        PROCESS_MEMORY_COUNTERS pmc;
+        GetProcessMemoryInfo( GetCurrentProcess(), &pmc, sizeof( pmc));
+        return (UInt64)pmc.PeakWorkingSetSize / 1024;
+#else
+        struct rusage usage;
+        getrusage( RUSAGE_SELF, &usage);
+        return (UInt64)usage.ru_maxrss;
+#endif
+    }
+
+    /** Print one measurement, the negative bytes per node value leaves the column empty */
+    static void report( const char *name, UInt64 elements, UInt64 time_ns, UInt64 ops, double bytes_per_node)
+    {
+        char bytes[ 64] = "";
+
+        if ( bytes_per_node >= 0)
+        {
+            sprintf( bytes, "%.1f", bytes_per_node);
+        }
+        printf( "bench,%s,%llu,%.2f,%s,%llu\n",
+                name,
+                elements,
+                ops == 0 ? 0.0 : (double)time_ns / (double)ops,
+                bytes,
+                peakRssKb());
+        fflush( stdout);
+    }
+
+    /**
+     * Graph library benchmarks on AGraph with n nodes. Every node i has edges to nodes i + 1 and i + 2
+     */
+    static void benchGraph( UInt64 n)
+    {
+        std::vector< ANode *> nodes( (size_t)n);
+        UInt64 rss_before = currentRss();
+        AGraph *graph = new AGraph;
+        UInt64 start;
+        UInt64 ops;
+
+        /** Node creation */
+        start = timeNs();
+        for ( UInt64 i = 0; i < n; i++)
+        {
+            nodes[ (size_t)i] = graph->newNode();
+        }
+        UInt64 node_time = timeNs() - start;
+
+        /** Edge creation */
+        start = timeNs();
+        ops = 0;
+        for ( UInt64 i = 0; i + 1 < n; i++)
+        {
+            graph->newEdge( nodes[ (size_t)i], nodes[ (size_t)i + 1]);
+            ops++;
+            if ( i + 2 < n)
+            {
+                graph->newEdge( nodes[ (size_t)i], nodes[ (size_t)i + 2]);
+                ops++;
+            }
+        }
+        UInt64 edge_time = timeNs() - start;
+        double bytes_per_node = (double)( currentRss() - rss_before) / (double)n;
+
+        report( "graph_new_node", n, node_time, n, bytes_per_node);
+        report( "graph_new_edge", n, edge_time, ops, bytes_per_node);
+
+        /** Successor and predecessor iteration, nodes are visited in list order */
+        ANode *node;
+        AEdge *edge;
+        UInt64 sum = 0;
+
+        start = timeNs();
+        ops = 0;
+        foreachNode( node, graph)
+        {
+            foreachSucc( edge, node)
+            {
+                sum += (UInt64)edge->succ()->dummy;
+                ops++;
+            }
+        }
+        report( "graph_succ_iter", n, timeNs() - start, ops, bytes_per_node);
+
+        start = timeNs();
+        ops = 0;
+        foreachNode( node, graph)
+        {
+            foreachPred( edge, node)
+            {
+                sum += (UInt64)edge->pred()->dummy;
+                ops++;
+            }
+        }
+        report( "graph_pred_iter", n, timeNs() - start, ops, bytes_per_node);
+
+        /** Whole graph node traversal in list and in memory order */
+        start = timeNs();
+        foreachNode( node, graph)
+        {
+            sum += (UInt64)node->dummy;
+        }
+        report( "graph_node_list_iter", n, timeNs() - start, n, bytes_per_node);
+
+        start = timeNs();
+        for ( AGraph::NodeIter it = graph->nodesBegin(), end = graph->nodesEnd(); it != end; ++it)
+        {
+            sum += (UInt64)(*it)->dummy;
+        }
+        report( "graph_node_pool_iter", n, timeNs() - start, n, bytes_per_node);
+
+        /** Markers: acquire, mark every node, check every node, free */
+        start = timeNs();
+        Marker m = graph->newMarker();
+        for ( UInt64 i = 0; i < n; i++)
+        {
+            nodes[ (size_t)i]->mark( m);
+        }
+        for ( UInt64 i = 0; i < n; i++)
+        {
+            sum += nodes[ (size_t)i]->isMarked( m) ? 1 : 0;
+        }
+        graph->freeMarker( m);
+        report( "graph_marker", n, timeNs() - start, 2 * n, bytes_per_node);
+
+        /** Numerations: acquire, number every node, read every number, free */
+        start = timeNs();
+        Numeration num = graph->newNum();
+        for ( UInt64 i = 0; i < n; i++)
+        {
+            nodes[ (size_t)i]->setNumber( num, (GraphNum)i);
+        }
+        for ( UInt64 i = 0; i < n; i++)
+        {
+            sum += nodes[ (size_t)i]->number( num);
+        }
+        graph->freeNum( num);
+        report( "graph_numeration", n, timeNs() - start, 2 * n, bytes_per_node);
+
+        /** Node insertion on every successor edge of every second node */
+        start = timeNs();
+        ops = 0;
+        for ( UInt64 i = 0; i < n; i += 2)
+        {
+            nodes[ (size_t)i]->firstSucc()->insertNode();
+            ops++;
+        }
+        report( "graph_insert_node", n, timeNs() - start, ops, bytes_per_node);
+
+        /** Node deletion along with the adjacent edges */
+        start = timeNs();
+        ops = graph->numNodes();
+        for ( UInt64 i = 0; i < n; i++)
+        {
+            graph->deleteNode( nodes[ (size_t)i]);
+        }
+        report( "graph_delete_node", n, timeNs() - start, ops - graph->numNodes(), bytes_per_node);
+
+        delete graph;
+        sink = sink + sum;
+    }
+
+    /**
+     * Optimizer IR with n operations in one function. Every operation is an addition of the result
+     * of the previous one and an immediate. The memory per node is taken from the function's pools
+     * rather than from the resident memory which reuses the memory freed by the previous benchmarks.
+     * It includes the operation, its operand array and its result object.
+     * The function is printed and read back into another module, for reading the bytes per node
+     * are the bytes of the text per operation, so the throughput is their ratio to the time per operation.
+     * The same is done for the binary IR: it is written and the function is loaded from it lazily.
+     * The whole function is deleted at the end
+     */
+    static void benchIR( UInt64 n)
+    {
+        Opt::Module *module = new Opt::Module;
+        Opt::Function *f = module->newFunction( "bench");
+        Opt::Obj *prev = f->newObject( Opt::Reg);
+        Opt::Oper *oper = NULL;
+        UInt64 start;
+
+        start = timeNs();
+        for ( UInt64 i = 0; i < n; i++)
+        {
+            Opt::Obj *res = f->newObject( Opt::Reg);
+
+            oper = isNullP( oper) ? f->newOper( Opt::Add) : f->newOperAfter( Opt::Add, oper);
+            oper->setArgObj( 0, prev);
+            oper->setArgImm( 1, (Int64)i);
+            oper->setResObj( 0, res);
+            if ( i == 0)
+            {
+                f->setFirstOper( oper);
+            }
+            prev = res;
+        }
+        UInt64 build_time = timeNs() - start;
+        double bytes_per_node = (double)( f->memStats().bytes() + f->arena().bytes()) / (double)n;
+
+        report( "ir_new_oper", n, build_time, n, bytes_per_node);
+
+        if ( n <= BENCH_READ_MAX_ELEMENTS)
+        {
+            std::ostringstream os;
+            os << f;
+
+            string text = os.str();
+            Opt::Module *read_module = new Opt::Module;
+            IR::Reader< Opt::MDes> reader( read_module);
+
+            start = timeNs();
+            reader.read( text);
+            report( "ir_read", n, timeNs() - start, n, (double)text.size() / (double)n);
+            delete read_module;
+
+            std::ostringstream bitcode_os;
+            IR::BitcodeWriter< Opt::MDes> writer( module);
+
+            start = timeNs();
+            writer.write( bitcode_os);
+
+            string bitcode = bitcode_os.str();
+            double bitcode_per_node = (double)bitcode.size() / (double)n;
+
+            report( "ir_bitcode_write", n, timeNs() - start, n, bitcode_per_node);
+
+            Opt::Module *load_module = new Opt::Module;
+            IR::BitcodeReader< Opt::MDes> bitcode_reader( load_module);
+
+            start = timeNs();
+            bitcode_reader.open( bitcode.data(), bitcode.size());
+            bitcode_reader.function( "bench");
+            report( "ir_bitcode_load", n, timeNs() - start, n, bitcode_per_node);
+            delete load_module;
+        }
+
+        start = timeNs();
+        delete module;
+        report( "ir_delete_function", n, timeNs() - start, n, bytes_per_node);
+    }
+
+    /**
+     * Topological numeration of CFG with n nodes. Every node i has successors i + 1 and i + 2
+     */
+    static void benchTopologicalNumeration( UInt64 n)
+    {
+        std::vector< Opt::CFNode *> nodes( (size_t)n);
+        UInt64 rss_before = currentRss();
+        Opt::CFG *cfg = new Opt::CFG;
+
+        for ( UInt64 i = 0; i < n; i++)
+        {
+            nodes[ (size_t)i] = cfg->newNode();
+        }
+        cfg->newEdge( cfg->startNode(), nodes[ 0]);
+        for ( UInt64 i = 0; i + 1 < n; i++)
+        {
+            cfg->newEdge( nodes[ (size_t)i], nodes[ (size_t)i + 1]);
+            if ( i + 2 < n)
+            {
+                cfg->newEdge( nodes[ (size_t)i], nodes[ (size_t)i + 2]);
+            }
+        }
+        cfg->newEdge( nodes[ (size_t)n - 1], cfg->stopNode());
+        double bytes_per_node = (double)( currentRss() - rss_before) / (double)n;
+
+        UInt64 start = timeNs();
+        Numeration num = cfg->makeTopologicalNumeration();
+        UInt64 time = timeNs() - start;
+
+        sink = sink + nodes[ (size_t)n - 1]->number( num);
+        cfg->freeNum( num);
+        report( "cfg_topological_numeration", n, time, n, bytes_per_node);
+        delete cfg;
+    }
+
+    /**
+     * Liveness of n objects in a loop of BENCH_LIVENESS_NODES nodes. Every operation defines
+     * its own object from the previous one and an object far ahead, so most of the objects are live
+     * around the loop. The time per operation covers the local sets and the fixed point iteration
+     */
+    static void benchLiveness( UInt64 n)
+    {
+        Opt::Module *module = new Opt::Module;
+        Opt::Function *f = module->newFunction( "bench");
+        Opt::CFG &cfg = f->cfg();
+        std::vector< Opt::CFNode *> nodes( BENCH_LIVENESS_NODES);
+        std::vector< Opt::Obj *> objs( (size_t)n);
+        Opt::Oper *oper = NULL;
+
+        for ( UInt32 k = 0; k < BENCH_LIVENESS_NODES; k++)
+        {
+            nodes[ k] = cfg.newNode();
+        }
+        for ( UInt64 i = 0; i < n; i++)
+        {
+            objs[ (size_t)i] = f->newObject( Opt::Reg);
+        }
+        for ( UInt64 i = 0; i < n; i++)
+        {
+            oper = isNullP( oper) ? f->newOper( Opt::Add) : f->newOperAfter( Opt::Add, oper);
+            oper->setArgObj( 0, objs[ (size_t)( i + n - 1) % n]);
+            oper->setArgObj( 1, objs[ (size_t)( i * 7919) % n]);
+            oper->setResObj( 0, objs[ (size_t)i]);
+            if ( i == 0)
+            {
+                f->setFirstOper( oper);
+            }
+            nodes[ (size_t)( i * BENCH_LIVENESS_NODES / n)]->extend( oper);
+        }
+        cfg.newEdge( cfg.startNode(), nodes[ 0]);
+        for ( UInt32 k = 0; k + 1 < BENCH_LIVENESS_NODES; k++)
+        {
+            cfg.newEdge( nodes[ k], nodes[ k + 1]);
+        }
+        cfg.newEdge( nodes[ BENCH_LIVENESS_NODES - 1], nodes[ 0]);
+        cfg.newEdge( nodes[ BENCH_LIVENESS_NODES - 1], cfg.stopNode());
+        cfg.setValid( true);
+
+        UInt64 start = timeNs();
+        Opt::Liveness *live = new Opt::Liveness( f);
+        UInt64 time = timeNs() - start;
+
+        sink = sink + live->liveIn( nodes[ 0]).count();
+        /* The sets reuse the memory freed by the IR benchmarks, so resident memory doesn't show them */
+        report( "liveness", n, time, n, -1);
+        delete live;
+        delete module;
+    }
+}
+
+/**
+ * The entry point for benchmarks of SCL (Simple Compiler).
+ * The optional argument is the largest number of elements, the benchmarks are run
+ * for 1e5 elements and each larger power of 10 up to this number.
+ */
+int main( int argc, char **argv)
+{
+    UInt64 max_elements = Bench::BENCH_MAX_ELEMENTS;
+
+    if ( argc > 1)
+    {
+        max_elements = (UInt64)strtod( argv[ 1], NULL);
+    }
+    Utils::MemMgr::init();
+
+    printf( "bench,name,elements,ns_per_op,bytes_per_node,peak_rss_kb\n");
+    for ( UInt64 n = Bench::BENCH_MIN_ELEMENTS; n <= max_elements; n *= 10)
+    {
+        Bench::benchGraph( n);
+        Bench::benchTopologicalNumeration( n);
+        Bench::benchIR( n);
+        if ( n <= Bench::BENCH_LIVENESS_MAX_ELEMENTS)
+        {
+            Bench::benchLiveness( n);
+        }
+    }
+
+    Utils::MemMgr::deinit();
+    return 0;
+}
@@ -0,0 +1,6 @@
+/**
+ * File: bench_impl.h - Header for benchmarking of libraries and tools of SCL (Simple Compiler)
+ * Copyright (C) 2012  Boris Shurygin
+ */
+#include "../Tools/tools_iface.h"
+#include "../opt/opt_iface.hpp"
@@ -28,9 +28,8 @@ class EdgeListTag{};
  * nextPred() and  nextSucc() routines. Also for debug purposes all edges in a graph
  * have unique id, which can be usefull for printing to console or setting breakpoint conditions.
  *
- * An edge can be @ref Marked "marked" and @ref Numbered "numbered". @ref Mark "Markers" and
- * @ref Nums "numerations" are managed by @ref GraphImpl "GraphImpl". Note that @ref NodeImpl "nodes" can be marked with the
- * same marker or numbered in the same numeration.
+ * Marking and numbering of edges is implemented by the Edge template, because the number
+ * of @ref Mark "markers" and @ref Nums "numerations" is a parameter of the graph type.
  * Also for debug purposes all nodes in a GraphImpl
  * have unique id, which can be usefull for printing to console or setting breakpoint conditions.
  *
@@ -42,9 +41,7 @@ class EdgeListTag{};
 class EdgeImpl: 
     public ListItem < PredListTag >,
     public ListItem < SuccListTag >,
-    public ListItem < EdgeListTag >,
-    public Marked,
-    public Numbered
+    public ListItem < EdgeListTag >
 {
 public:
     typedef ListItem < PredListTag > PredList;
@@ -61,8 +58,9 @@ public:
      *  Destructor.
      *  Delete edge from list in graph.
      *  Deletion from node lists MUST be performed manually.
+     *  Not virtual unless GRAPH_VIRTUAL_OBJECTS is defined
      */
-    virtual ~EdgeImpl();
+    GRAPH_OBJ_VIRTUAL ~EdgeImpl();
 
     /**
      * Connect edge to a node in specified direction.
@@ -90,7 +88,7 @@ public:
     inline EdgeImpl* nextPred() const;/**< Next predecessor */
     
     /** Print edge in dot fomat to stdout */
-    virtual void debugPrint();
+    GRAPH_OBJ_VIRTUAL void debugPrint();
 protected:
     /** Constructors are made private, only nodes and GraphImpl can create edges */
     inline EdgeImpl( NodeImpl *_pred, NodeImpl* _succ);
@@ -152,14 +150,17 @@ public:
  * have unique id, which can be usefull for printing to the console or setting the breakpoint conditions.
  *
  * An edge can be @ref Marked "marked" and @ref Numbered "numbered". @ref Mark "Markers" and
- * @ref Nums "numerations" are managed by the @ref GraphImpl "graph". Note that @ref Node "nodes" can
- * be marked with the same marker or numbered in the same numeration.
+ * @ref Nums "numerations" are managed by the @ref Graph "graph". Note that @ref Node "nodes" can
+ * be marked with the same marker or numbered in the same numeration. The number of markers and
+ * numerations is set by MaxMarkers and MaxNums parameters which must be the same as the ones of the graph.
  *
  * Also for the debug purposes all edge in a graph
  * have unique id, which can be usefull for printing to the console or setting the breakpoint conditions.
  *
  * Edges reside in memory pool that is controlled by Graph. Operator new can't be called
  * directly. Edges can be only created by calling Graph::newEdge().
+ * Edges don't have a virtual table unless GRAPH_VIRTUAL_OBJECTS is defined. Graph destroys
+ * and prints them through the most derived type E, so E should be the final class in hierarchy.
  *
  * Every edge have associated QDomElement for XML export support. The updateElement() routine should be called before
  * export to get element in sync with edge's properties.
@@ -169,9 +170,12 @@ public:
  * @sa Mark
  * @sa Nums
  */
-template < class G, class N, class E> class Edge: 
+template < class G, class N, class E,
+           MarkerIndex MaxMarkers = MAX_GRAPH_MARKERS, NumIndex MaxNums = MAX_NUMERATIONS>
+class Edge: 
     public EdgeImpl,
-    public PoolObj<E, UseCustomFixedPool>
+    public Marked< MaxMarkers>,
+    public Numbered< MaxNums>
 {
 public:    
 
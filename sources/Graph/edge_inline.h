@@ -169,9 +169,9 @@ inline EdgeImpl* EdgeImpl::nextPred() const
  * Original edge goes to new node. 
  * Return new node.
  */
-template < class G, class N, class E> 
+template < class G, class N, class E, MarkerIndex MaxMarkers, NumIndex MaxNums> 
 N * 
-Edge< G, N, E>::insertNode()
+Edge< G, N, E, MaxMarkers, MaxNums>::insertNode()
 {
     N *tmp_succ = succ();
     N *new_node = static_cast< G*>(graph())->newNode();
@@ -182,57 +182,57 @@ Edge< G, N, E>::insertNode()
 }
 
 /** Get node in specified direction  */
-template < class G, class N, class E> 
+template < class G, class N, class E, MarkerIndex MaxMarkers, NumIndex MaxNums> 
 inline N * 
-Edge< G, N, E>::node( GraphDir dir) const
+Edge< G, N, E, MaxMarkers, MaxNums>::node( GraphDir dir) const
 {
     return static_cast< N*>( EdgeImpl::node( dir));
 }
     
 /** Get predecessor node of edge */
-template < class G, class N, class E> 
+template < class G, class N, class E, MarkerIndex MaxMarkers, NumIndex MaxNums> 
 N * 
-Edge< G, N, E>::pred() const
+Edge< G, N, E, MaxMarkers, MaxNums>::pred() const
 {
     return static_cast< N*>( EdgeImpl::pred());
 }
 
 /** Get successor node of edge   */
-template < class G, class N, class E> 
+template < class G, class N, class E, MarkerIndex MaxMarkers, NumIndex MaxNums> 
 N * 
-Edge< G, N, E>::succ() const
+Edge< G, N, E, MaxMarkers, MaxNums>::succ() const
 {
 return static_cast< N*>( EdgeImpl::succ());
 }
 
 /** Return next edge of the GraphImpl */
-template < class G, class N, class E> 
+template < class G, class N, class E, MarkerIndex MaxMarkers, NumIndex MaxNums> 
 E * 
-Edge< G, N, E>::nextEdge() const
+Edge< G, N, E, MaxMarkers, MaxNums>::nextEdge() const
 {
     return static_cast< E*>( EdgeImpl::nextEdge());
 }
 
 /** Return next edge of the same node in given direction  */
-template < class G, class N, class E> 
+template < class G, class N, class E, MarkerIndex MaxMarkers, NumIndex MaxNums> 
 E * 
-Edge< G, N, E>::nextEdgeInDir( GraphDir dir) const
+Edge< G, N, E, MaxMarkers, MaxNums>::nextEdgeInDir( GraphDir dir) const
 {
     return static_cast< E*>( EdgeImpl::nextEdgeInDir( dir));
 }
 
 /** Next successor */
-template < class G, class N, class E> 
+template < class G, class N, class E, MarkerIndex MaxMarkers, NumIndex MaxNums> 
 E * 
-Edge< G, N, E>::nextSucc() const
+Edge< G, N, E, MaxMarkers, MaxNums>::nextSucc() const
 {
     return static_cast< E*>( EdgeImpl::nextSucc());
 }
 
 /** Next predecessor */
-template < class G, class N, class E> 
+template < class G, class N, class E, MarkerIndex MaxMarkers, NumIndex MaxNums> 
 E * 
-Edge< G, N, E>::nextPred() const
+Edge< G, N, E, MaxMarkers, MaxNums>::nextPred() const
 {
     return static_cast< E*>( EdgeImpl::nextPred());
 }
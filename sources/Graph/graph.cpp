@@ -55,44 +55,4 @@ GraphImpl::debugPrint()
     }
     out( "}");
 }
-
-/**
- * Implementation for numerations cleanup
- */
-void 
-GraphImpl::clearNumerationsInObjects()
-{
-    NodeImpl *n;
-    EdgeImpl *e;
-    /** Clean markers in nodes */
-    for ( n = firstNode(); isNotNullP( n); n = n->nextNode())
-    {
-        clearUnusedNumerations( n);
-    }
-    /** Clean markers in edges */
-    for ( e = firstEdge(); isNotNullP( e); e = e->nextEdge())
-    {
-        clearUnusedNumerations( e);
-    }
-}
-
-/**
- * Implementation for markers cleanup
- */
-void 
-GraphImpl::clearMarkersInObjects()
-{
-    NodeImpl *n;
-    EdgeImpl *e;
-    /** Clean markers in nodes */
-    for (  n = firstNode(); isNotNullP( n); n = n->nextNode())
-    {
-        clearUnusedMarkers( static_cast<Marked *>(n));
-    }
-    /** Clean markers in edges */
-    for (  e = firstEdge(); isNotNullP( e); e = e->nextEdge())
-    {
-        clearUnusedMarkers( static_cast<Marked *>(n));
-    }
-}
 } // namespace Graph
\ No newline at end of file
@@ -53,39 +53,8 @@ namespace Graph
  }
  @endcode
  *
- * GraphImpl is also manager of @ref Mark "markers" and @ref Nums "numerations" for nodes and edges.
- * New @ref Marker "marker" can be obtained by newMarker() routine. New @ref Numeration "numeration" is
- * created by newNum().
- * Example:
-@code
- //GraphImpl *GraphImpl; 
- NodeImpl *n;
- Marker m = GraphImpl->newMarker();
- Numeration num = GraphImpl->newNum();
-    
- GraphNum i = 0; //unsigned int 32
- //Mark nodes without predecessors
- foreachNode( n, g)
- {
-    if ( isNullP( n->firstPred()))
-    {
-        n->mark( m);
-        n->setNumber( num, i++);
-    }
- }
- ...
-
- //Checking markers and numbers
- foreachNode( n, g)
- {
-     if ( n->isMarked( m) && n->number( num) > 10)
-     {
-        ...
-     }
- }
- GraphImpl->freeMarker( m);
- GraphImpl->freeNum( num);
-@endcode
+ * @ref Mark "Markers" and @ref Nums "numerations" of nodes and edges are managed by the Graph
+ * template as their number is a compile-time parameter of the graph type.
  *
  * Deriving classes from GraphImpl
  * To make a GraphImpl-like data structure one can use GraphImpl as a base class. Most likely
@@ -101,7 +70,7 @@ namespace Graph
  * @sa Nums
  * @sa AGraph
  */
-class GraphImpl: public MarkerManager, public NumManager
+class GraphImpl
 {
 public:
     /** Default constructor */
@@ -137,13 +106,6 @@ public:
     /** Add existing edge */
     inline void addEdge( EdgeImpl *e);
 private:
-    
-    /** Clear unused markers from marked objects */
-    virtual void clearMarkersInObjects();
-
-    /** Clear unused numerations from numbered objects */
-    virtual void clearNumerationsInObjects();
-
     /** First node */
     NodeImpl* first_node;
     /** Number of nodes */
@@ -167,6 +129,22 @@ protected:
     GraphUid edge_next_id;
 };
 
+/**
+ * @brief Memory usage statistics of a graph
+ * @ingroup GraphBase
+ */
+struct GraphMemStats
+{
+    PoolStats nodes; /**< Statistics of the node pool */
+    PoolStats edges; /**< Statistics of the edge pool */
+
+    /** Memory allocated for nodes and edges */
+    inline UInt64 bytes() const;
+
+    /** Print statistics to stream in one line */
+    inline void toStream( ostream& os) const;
+};
+
 /**
  * @class Graph
  * @brief Conveniece template for graph creation.
@@ -222,10 +200,25 @@ protected:
  @endcode
  *
  * The Graph is also the owner of the memory allocated for its nodes and edges. This is
- * implemented via @ref FixedPool "memory pools" with the records of fixed size. The nodes and
+ * implemented via @ref GraphPool "memory pools" with the records of fixed size. The nodes and
  * edges should be created through the newNode() and newEdge() routines. They can be deleted by
  * the deleteNode() and deleteEdge() routines. 
  * IMPORTANT: Do not use operators new/delete for graph's  nodes and edges.
+ * The memory usage of the pools is reported by memStats() routine, its result can be
+ * printed with GraphMemStats::toStream().
+ *
+ * When the order of traversal doesn't matter the nodes and edges can be visited in the order
+ * they are laid out in the pools. Such traversal scans the memory sequentially instead of
+ * following the list pointers and is preferable for the whole-graph sweeps.
+ * @code
+ 
+ // Traversing nodes in memory order
+ for ( MyGraph::NodeIter it = g->nodesBegin(), end = g->nodesEnd(); it != end; ++it)
+ {
+     MyNode *n = *it;
+     ...
+ }
+ @endcode
  * 
  * The Graph is also the manager of @ref Mark "markers" and @ref Nums "numerations" for the nodes and edges.
  * New @ref Marker "marker" can be obtained by the newMarker() routine. The new @ref Numeration "numeration" is
@@ -260,13 +253,30 @@ protected:
  g->freeMarker( m);
  g->freeNum( num);
 @endcode
+ *
+ * The number of markers and numerations that can be used simultaneously is set by the MaxMarkers
+ * and MaxNums template parameters. The same values must be passed to the Node and Edge templates
+ * of the graph type. Every node and edge stores a value per marker and two values per numeration, so a
+ * graph type can be sized exactly for its algorithms. Zero capacity removes the corresponding storage
+ * and interface from nodes and edges altogether.
+ @code
+ // Graph with two markers and without numerations
+ class MyNode: public Node< MyGraph, MyNode, MyEdge, 2, 0> { ... };
+ class MyEdge: public Edge< MyGraph, MyNode, MyEdge, 2, 0> { ... };
+ class MyGraph: public Graph< MyGraph, MyNode, MyEdge, 2, 0> { ... };
+ @endcode
  *
  * @sa Node
  * @sa Edge
  * @sa AGraph
  * @sa GraphImpl
  */
-template < class G, class N, class E> class Graph: public GraphImpl
+template < class G, class N, class E,
+           MarkerIndex MaxMarkers = MAX_GRAPH_MARKERS, NumIndex MaxNums = MAX_NUMERATIONS>
+class Graph:
+    public GraphImpl,
+    public MarkerManager< MaxMarkers>,
+    public NumManager< MaxNums>
 {
 public:
 
@@ -293,16 +303,33 @@ public:
 
     /** Get first node */
     inline N* firstNode();
+
+    /* Iterator types for traversal in memory order */
+    typedef PoolIter< N> NodeIter; /**< Iterator for nodes */
+    typedef PoolIter< E> EdgeIter; /**< Iterator for edges */
+
+    inline NodeIter nodesBegin() const; /**< Create iterator for first node in memory order */
+    inline NodeIter nodesEnd() const;   /**< Create iterator pointing to nodes end          */
+
+    inline EdgeIter edgesBegin() const; /**< Create iterator for first edge in memory order */
+    inline EdgeIter edgesEnd() const;   /**< Create iterator pointing to edges end          */
+
+    /** Get memory usage statistics of nodes and edges */
+    inline GraphMemStats memStats() const;
+
+    /** Print graph to stdout in DOT format */
+    virtual void debugPrint();
 private:
-    /** Get pool of nodes */
-    inline TypedPool<N> &nodePool() const;
-    /** Get pool of edges */
-    inline TypedPool<E> &edgePool() const;
+    /** Clear unused markers from nodes and edges in memory order */
+    virtual void clearMarkersInObjects();
+
+    /** Clear unused numerations from nodes and edges in memory order */
+    virtual void clearNumerationsInObjects();
 
     /** Memory pool for nodes */
-    TypedPool<N> node_pool;
+    GraphPool< N> node_pool;
     /** Memory pool for edges */
-    TypedPool<E> edge_pool;
+    GraphPool< E> edge_pool;
 };
 
 } // namespace Graph 
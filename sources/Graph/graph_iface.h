@@ -17,6 +17,8 @@
 #define GRAPH_IFACE_H
 #include "predecls.h"
 
+#include "pool.h"
+
 #include "edge.h"
 #include "node.h"
 #include "graph.h"
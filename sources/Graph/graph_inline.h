@@ -113,70 +113,192 @@ GraphImpl::addEdge( EdgeImpl *edge_p)
     ++edge_next_id;
 }
 
+/** Memory allocated for nodes and edges */
+inline UInt64
+GraphMemStats::bytes() const
+{
+    return nodes.bytes + edges.bytes;
+}
+
+/** Print statistics to stream in one line */
+inline void
+GraphMemStats::toStream( ostream& os) const
+{
+    os << "nodes { ";
+    nodes.toStream( os);
+    os << " } edges { ";
+    edges.toStream( os);
+    os << " } total " << bytes() << "B";
+}
+
 /* Constructor */
-template < class G, class N, class E> Graph< G, N, E>::Graph()
+template < class G, class N, class E, MarkerIndex MaxMarkers, NumIndex MaxNums> Graph< G, N, E, MaxMarkers, MaxNums>::Graph()
 {
 
 };
 
 /** NodeImpl creation overload */
-template < class G, class N, class E> 
-    N * Graph< G, N, E>::newNode()
+template < class G, class N, class E, MarkerIndex MaxMarkers, NumIndex MaxNums> 
+    N * Graph< G, N, E, MaxMarkers, MaxNums>::newNode()
 {
-    N* node = new ( &node_pool) N();
+    N* node = ::new ( node_pool.allocate()) N();
     addNode( node);
     return node;
 }
 
 /** EdgeImpl creation overload */
-template < class G, class N, class E> 
-    E * Graph< G, N, E>::newEdge( N *pred, N* succ)
+template < class G, class N, class E, MarkerIndex MaxMarkers, NumIndex MaxNums> 
+    E * Graph< G, N, E, MaxMarkers, MaxNums>::newEdge( N *pred, N* succ)
 {
-    E *edge = new ( &edge_pool) E( pred, succ);
+    E *edge = ::new ( edge_pool.allocate()) E( pred, succ);
     addEdge( edge);
     return edge;
 } 
 
 /** Delete node from memory pool */
-template < class G, class N, class E> 
-    void Graph< G, N, E>::deleteNode( N *n)
+template < class G, class N, class E, MarkerIndex MaxMarkers, NumIndex MaxNums> 
+    void Graph< G, N, E, MaxMarkers, MaxNums>::deleteNode( N *n)
 {
-    node_pool.destroy( n);
+    n->~N();
+    node_pool.deallocate( n);
 }
 
 /** Delete edge from memory pool */
-template < class G, class N, class E> 
-    void Graph< G, N, E>::deleteEdge( E *e)
+template < class G, class N, class E, MarkerIndex MaxMarkers, NumIndex MaxNums> 
+    void Graph< G, N, E, MaxMarkers, MaxNums>::deleteEdge( E *e)
 {
-    edge_pool.destroy( e);
+    e->~E();
+    edge_pool.deallocate( e);
 }
 
 /** Get first edge */
-template < class G, class N, class E>
+template < class G, class N, class E, MarkerIndex MaxMarkers, NumIndex MaxNums>
 E*
-Graph< G, N, E>::firstEdge()
+Graph< G, N, E, MaxMarkers, MaxNums>::firstEdge()
 {
     return static_cast< E*>( GraphImpl::firstEdge());
 }
 
 /** Get first node */
-template < class G, class N, class E>
+template < class G, class N, class E, MarkerIndex MaxMarkers, NumIndex MaxNums>
 N*
-Graph< G, N, E>::firstNode()
+Graph< G, N, E, MaxMarkers, MaxNums>::firstNode()
 {
     return static_cast< N*>( GraphImpl::firstNode());
 }
 
 
-template < class G, class N, class E> 
-Graph< G, N, E>::~Graph()
+/** Create iterator for first node in memory order */
+template < class G, class N, class E, MarkerIndex MaxMarkers, NumIndex MaxNums>
+typename Graph< G, N, E, MaxMarkers, MaxNums>::NodeIter
+Graph< G, N, E, MaxMarkers, MaxNums>::nodesBegin() const
+{
+    return node_pool.begin();
+}
+
+/** Create iterator pointing to nodes end */
+template < class G, class N, class E, MarkerIndex MaxMarkers, NumIndex MaxNums>
+typename Graph< G, N, E, MaxMarkers, MaxNums>::NodeIter
+Graph< G, N, E, MaxMarkers, MaxNums>::nodesEnd() const
+{
+    return node_pool.end();
+}
+
+/** Create iterator for first edge in memory order */
+template < class G, class N, class E, MarkerIndex MaxMarkers, NumIndex MaxNums>
+typename Graph< G, N, E, MaxMarkers, MaxNums>::EdgeIter
+Graph< G, N, E, MaxMarkers, MaxNums>::edgesBegin() const
+{
+    return edge_pool.begin();
+}
+
+/** Create iterator pointing to edges end */
+template < class G, class N, class E, MarkerIndex MaxMarkers, NumIndex MaxNums>
+typename Graph< G, N, E, MaxMarkers, MaxNums>::EdgeIter
+Graph< G, N, E, MaxMarkers, MaxNums>::edgesEnd() const
+{
+    return edge_pool.end();
+}
+
+/** Get memory usage statistics of nodes and edges */
+template < class G, class N, class E, MarkerIndex MaxMarkers, NumIndex MaxNums>
+GraphMemStats
+Graph< G, N, E, MaxMarkers, MaxNums>::memStats() const
+{
+    GraphMemStats res;
+
+    res.nodes = node_pool.stats();
+    res.edges = edge_pool.stats();
+    return res;
+}
+
+/**
+ * Print graph to stdout in DOT format.
+ * Nodes and edges are printed in the order they are laid out in memory
+ */
+template < class G, class N, class E, MarkerIndex MaxMarkers, NumIndex MaxNums>
+void
+Graph< G, N, E, MaxMarkers, MaxNums>::debugPrint()
+{
+    out( "diGraphImpl{");
+    /** Print nodes */
+    for ( NodeIter it = nodesBegin(), end = nodesEnd(); it != end; ++it)
+    {
+        (*it)->debugPrint();
+    }
+    /** Print edges */
+    for ( EdgeIter it = edgesBegin(), end = edgesEnd(); it != end; ++it)
+    {
+        (*it)->debugPrint();
+    }
+    out( "}");
+}
+
+/**
+ * Clear unused markers from nodes and edges in memory order
+ */
+template < class G, class N, class E, MarkerIndex MaxMarkers, NumIndex MaxNums>
+void
+Graph< G, N, E, MaxMarkers, MaxNums>::clearMarkersInObjects()
+{
+    for ( NodeIter it = nodesBegin(), end = nodesEnd(); it != end; ++it)
+    {
+        this->clearUnusedMarkers( static_cast< Marked< MaxMarkers> *>( *it));
+    }
+    for ( EdgeIter it = edgesBegin(), end = edgesEnd(); it != end; ++it)
+    {
+        this->clearUnusedMarkers( static_cast< Marked< MaxMarkers> *>( *it));
+    }
+}
+
+/**
+ * Clear unused numerations from nodes and edges in memory order
+ */
+template < class G, class N, class E, MarkerIndex MaxMarkers, NumIndex MaxNums>
+void
+Graph< G, N, E, MaxMarkers, MaxNums>::clearNumerationsInObjects()
+{
+    for ( NodeIter it = nodesBegin(), end = nodesEnd(); it != end; ++it)
+    {
+        this->clearUnusedNumerations( static_cast< Numbered< MaxNums> *>( *it));
+    }
+    for ( EdgeIter it = edgesBegin(), end = edgesEnd(); it != end; ++it)
+    {
+        this->clearUnusedNumerations( static_cast< Numbered< MaxNums> *>( *it));
+    }
+}
+
+/**
+ * Destructor. Deletes nodes in memory order, the edges are deleted along with their nodes
+ */
+template < class G, class N, class E, MarkerIndex MaxMarkers, NumIndex MaxNums> 
+Graph< G, N, E, MaxMarkers, MaxNums>::~Graph()
 {
-    for ( N *node = firstNode();
-            isNotNullP( node);)
+    for ( NodeIter it = nodesBegin(), end = nodesEnd(); it != end;)
     {
-        N* next = node->nextNode();
+        N* node = *it;
+        ++it;
         deleteNode( node);
-        node = next;
     }
 }
 }//namespace Graph
@@ -190,7 +190,7 @@ static bool uTestNumerations( UnitTest* utest_p)
      * Every class that can be a numerations manager should implement
      * the routine for clearing numerations in objects
      */
-    class NumMgrInst: public NumManager
+    class NumMgrInst: public NumManager<>
     {
         /** Implementation of clearing - empty TODO: implement and test it */
         void clearNumerationsInObjects()
@@ -218,7 +218,7 @@ static bool uTestNumerations( UnitTest* utest_p)
     /** 2. Too big number */
     NumMgrInst mgr2;
     Numeration num2 = mgr2.newNum();
-    Numbered obj2; 
+    Numbered<> obj2; 
     try
     {
         obj2.setNumber( num2, -1);
@@ -238,7 +238,7 @@ static bool uTestNumerations( UnitTest* utest_p)
     } 
     Numeration num = mgr.newNum();
     Numeration num_unused = mgr.newNum();
-    Numbered obj; 
+    Numbered<> obj; 
     UTEST_CHECK( utest_p, obj.number( num) == NUMBER_NO_NUM);
     UTEST_CHECK( utest_p, obj.number( num_unused) == NUMBER_NO_NUM);
     obj.setNumber( num, 1);
@@ -251,6 +251,193 @@ static bool uTestNumerations( UnitTest* utest_p)
     return true;
 }
 
+/* Graph with two markers and without numerations */
+class SNode;
+class SEdge;
+class SGraph;
+
+/** Node of graph with reduced marker capacity */
+class SNode: public Node< SGraph, SNode, SEdge, 2, 0>
+{
+
+};
+
+/** Edge of graph with reduced marker capacity */
+class SEdge: public Edge< SGraph, SNode, SEdge, 2, 0>
+{
+public:
+    SEdge( SNode *pred, SNode *succ): Edge< SGraph, SNode, SEdge, 2, 0>( pred, succ)
+    {
+    
+    }
+};
+
+/** Graph with reduced marker capacity */
+class SGraph: public Graph< SGraph, SNode, SEdge, 2, 0>
+{
+
+};
+
+/**
+ * Check graphs with non-default marker and numeration capacity
+ */
+static bool uTestCapacity( UnitTest* utest_p)
+{
+    /** Objects pay only for the markers and numerations they can have */
+    UTEST_CHECK( utest_p, sizeof( SNode) < sizeof( ANode));
+    UTEST_CHECK( utest_p, sizeof( SEdge) < sizeof( AEdge));
+    UTEST_CHECK( utest_p, sizeof( Marked< 2>) == 2 * sizeof( MarkerValue));
+    
+    SGraph graph;
+    SNode *pred = graph.newNode();
+    SNode *succ = graph.newNode();
+    SEdge *edge = graph.newEdge( pred, succ);
+    
+    /** Both markers are usable at the same time and repeatedly */
+    for ( int i = 0; i < 3; i++)
+    {
+        Marker m = graph.newMarker();
+        Marker m2 = graph.newMarker();
+        
+        UTEST_CHECK( utest_p, !pred->isMarked( m));
+        UTEST_CHECK( utest_p, !edge->isMarked( m2));
+        UTEST_CHECK( utest_p, pred->mark( m));
+        UTEST_CHECK( utest_p, edge->mark( m2));
+        UTEST_CHECK( utest_p, pred->isMarked( m));
+        UTEST_CHECK( utest_p, !pred->isMarked( m2));
+        UTEST_CHECK( utest_p, edge->isMarked( m2));
+        UTEST_CHECK( utest_p, !succ->isMarked( m));
+        graph.freeMarker( m);
+        graph.freeMarker( m2);
+    }
+    return true;
+}
+
+/**
+ * Check traversal of nodes and edges in memory order
+ */
+static bool uTestPoolIteration( UnitTest* utest_p)
+{
+    AGraph graph;
+    AGraph *g = &graph;
+    ANode *prev = NULL;
+    
+    /** Create a chain of nodes that spans several pool chunks */
+    for ( GraphNum i = 0; i < 3 * GRAPH_POOL_CHUNK_SIZE; i++)
+    {
+        ANode *node = graph.newNode();
+        if ( isNotNullP( prev))
+        {
+            graph.newEdge( prev, node);
+        }
+        prev = node;
+    }
+    
+    /** Delete every third node to make holes in the pools and refill some of them */
+    for ( AGraph::NodeIter it = graph.nodesBegin(), end = graph.nodesEnd(); it != end;)
+    {
+        ANode *node = *it;
+        ++it;
+        if ( node->id() % 3 == 0)
+        {
+            graph.deleteNode( node);
+        }
+    }
+    for ( int i = 0; i < 10; i++)
+    {
+        graph.newNode();
+    }
+    
+    /** Every node and edge must be visited exactly once */
+    Marker m = graph.newMarker();
+    GraphNum node_count = 0;
+    for ( AGraph::NodeIter it = graph.nodesBegin(), end = graph.nodesEnd(); it != end; it++)
+    {
+        UTEST_CHECK( utest_p, (*it)->mark( m));
+        UTEST_CHECK( utest_p, areEqP( (*it)->graph(), &graph));
+        node_count++;
+    }
+    ANode *n;
+    foreachNode( n, g)
+    {
+        UTEST_CHECK( utest_p, n->isMarked( m));
+    }
+    UTEST_CHECK( utest_p, node_count == graph.numNodes());
+    
+    GraphNum edge_count = 0;
+    for ( AGraph::EdgeIter it = graph.edgesBegin(), end = graph.edgesEnd(); it != end; ++it)
+    {
+        UTEST_CHECK( utest_p, (*it)->mark( m));
+        edge_count++;
+    }
+    AEdge *e;
+    foreachEdge( e, g)
+    {
+        UTEST_CHECK( utest_p, e->isMarked( m));
+    }
+    UTEST_CHECK( utest_p, edge_count == graph.numEdges());
+    graph.freeMarker( m);
+    
+    /** Empty graph has no nodes to iterate over */
+    AGraph empty;
+    UTEST_CHECK( utest_p, empty.nodesBegin() == empty.nodesEnd());
+    UTEST_CHECK( utest_p, empty.edgesBegin() == empty.edgesEnd());
+    return true;
+}
+
+/**
+ * Check memory usage statistics
+ */
+static bool uTestMemStats( UnitTest* utest_p)
+{
+    AGraph graph;
+    GraphMemStats stats = graph.memStats();
+    
+    UTEST_CHECK( utest_p, stats.nodes.chunks == 0);
+    UTEST_CHECK( utest_p, stats.bytes() == 0);
+    UTEST_CHECK( utest_p, stats.nodes.fragmentation() == 0);
+
+    /** Fill one chunk and start the next one */
+    ANode *nodes[ GRAPH_POOL_CHUNK_SIZE + 1];
+    for ( GraphNum i = 0; i <= GRAPH_POOL_CHUNK_SIZE; i++)
+    {
+        nodes[ i] = graph.newNode();
+        if ( i > 0)
+        {
+            graph.newEdge( nodes[ i - 1], nodes[ i]);
+        }
+    }
+    stats = graph.memStats();
+    UTEST_CHECK( utest_p, stats.nodes.live_entries == GRAPH_POOL_CHUNK_SIZE + 1);
+    UTEST_CHECK( utest_p, stats.nodes.free_entries == 0);
+    UTEST_CHECK( utest_p, stats.nodes.unused_entries == GRAPH_POOL_CHUNK_SIZE - 1);
+    UTEST_CHECK( utest_p, stats.nodes.chunks == 2);
+    UTEST_CHECK( utest_p, stats.nodes.object_size == sizeof( ANode));
+    UTEST_CHECK( utest_p, stats.nodes.entry_size >= sizeof( ANode));
+    UTEST_CHECK( utest_p, stats.nodes.bytes >= 2 * GRAPH_POOL_CHUNK_SIZE * sizeof( ANode));
+    UTEST_CHECK( utest_p, stats.edges.live_entries == GRAPH_POOL_CHUNK_SIZE);
+    UTEST_CHECK( utest_p, stats.edges.chunks == 1);
+    UTEST_CHECK( utest_p, stats.bytes() == stats.nodes.bytes + stats.edges.bytes);
+
+    /** Deleted nodes and edges become free entries */
+    for ( GraphNum i = 0; i < 10; i++)
+    {
+        graph.deleteNode( nodes[ i]);
+    }
+    stats = graph.memStats();
+    UTEST_CHECK( utest_p, stats.nodes.live_entries == GRAPH_POOL_CHUNK_SIZE - 9);
+    UTEST_CHECK( utest_p, stats.nodes.free_entries == 10);
+    UTEST_CHECK( utest_p, stats.edges.free_entries == 10);
+    UTEST_CHECK( utest_p, stats.nodes.fragmentation() > 0);
+    
+    /** Free entries are reused before the unused ones */
+    graph.newNode();
+    stats = graph.memStats();
+    UTEST_CHECK( utest_p, stats.nodes.free_entries == 9);
+    UTEST_CHECK( utest_p, stats.nodes.unused_entries == GRAPH_POOL_CHUNK_SIZE - 1);
+    return true;
+}
+
 #if 0
 /**
  * Create Graph and save it to XML
@@ -303,6 +490,12 @@ bool uTest( UnitTest* utest_p)
 
     uTestMarkers( utest_p);
 
+    uTestPoolIteration( utest_p);
+
+    uTestCapacity( utest_p);
+
+    uTestMemStats( utest_p);
+
     return utest_p->result();
 }
 
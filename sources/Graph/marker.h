@@ -17,14 +17,14 @@
  * Example:
  **@code
  //Derive your class from Marked
- class Obj: public Marked
+ class Obj: public Marked<>
  {
  pubic:
      void someAction();
      ...
  }
  //Derive class that controls Obj's instances from MarkerManager
- class ObjManager: public MarkerManager
+ class ObjManager: public MarkerManager<>
  {
      // QList from Qt's containers
      QList<Obj *> objs;
@@ -103,7 +103,12 @@ typedef enum MarkerErrorType_e
  * How many markers are allowed simultaneously
  * @ingroup Mark
  */
-const short int MAX_GRAPH_MARKERS = 10;
+const MarkerIndex MAX_GRAPH_MARKERS = 10;
+/**
+ * Index of marker that doesn't belong to any manager
+ * @ingroup Mark
+ */
+const MarkerIndex GRAPH_MARKER_NO_INDEX = ( MarkerIndex)( -1);
 /**
  * Clean value of markers
  * @ingroup Mark
@@ -136,26 +141,26 @@ private:
     /** Value */
     MarkerValue value;
 
-    /** Two classes have acces to marker internals. All others do not. */
-    friend class Marked;
-    friend class MarkerManager;
+    /** Two class templates have acces to marker internals. All others do not. */
+    template < MarkerIndex MaxMarkers> friend class Marked;
+    template < MarkerIndex MaxMarkers> friend class MarkerManager;
 };
 
 /**
  * Default constructor
  */
 inline Marker::Marker(): 
-    index( MAX_GRAPH_MARKERS), value( GRAPH_MARKER_CLEAN)
+    index( GRAPH_MARKER_NO_INDEX), value( GRAPH_MARKER_CLEAN)
 {
 
 }
 
 /**
- * Represents a marked object
+ * Represents a marked object. The object can be marked by MaxMarkers markers simultaneously
  *
  * @ingroup Mark
  */
-class Marked
+template < MarkerIndex MaxMarkers = MAX_GRAPH_MARKERS> class Marked
 {
 public:
     /** Default constructor */
@@ -174,19 +179,20 @@ public:
     inline void clear( MarkerIndex i);
 private:
     /** Markers */
-    MarkerValue markers[ MAX_GRAPH_MARKERS];
+    MarkerValue markers[ MaxMarkers];
 };
 
     
 /**
  * Default constructor
  */
-inline Marked::Marked()
+template < MarkerIndex MaxMarkers>
+inline Marked< MaxMarkers>::Marked()
 {
     MarkerIndex i;
 
     /** Initialize markers */
-    for ( i = 0; i < MAX_GRAPH_MARKERS; i++)
+    for ( i = 0; i < MaxMarkers; i++)
     {
         markers [ i] = GRAPH_MARKER_CLEAN;
     }
@@ -195,8 +201,10 @@ inline Marked::Marked()
 /**
  * mark node with marker. Return false if node is already marked. True otherwise.
  */
-inline bool Marked::mark( Marker marker)
+template < MarkerIndex MaxMarkers>
+inline bool Marked< MaxMarkers>::mark( Marker marker)
 {
+    GRAPH_ASSERTXD( marker.index < MaxMarkers, "Marker doesn't belong to a manager of this object");
     if ( markers[ marker.index] == marker.value)
     {
         return false;
@@ -208,8 +216,10 @@ inline bool Marked::mark( Marker marker)
 /**
  * Return true if node is marked with this marker
  */
-inline bool Marked::isMarked( Marker marker)
+template < MarkerIndex MaxMarkers>
+inline bool Marked< MaxMarkers>::isMarked( Marker marker)
 {
+    GRAPH_ASSERTXD( marker.index < MaxMarkers, "Marker doesn't belong to a manager of this object");
     if ( markers[ marker.index] == marker.value)
     {
         return true;
@@ -220,8 +230,10 @@ inline bool Marked::isMarked( Marker marker)
 /**
  * Return true if node has been marked with this marker and unmarks it
  */
-inline bool Marked::unmark( Marker marker)
+template < MarkerIndex MaxMarkers>
+inline bool Marked< MaxMarkers>::unmark( Marker marker)
 {
+    GRAPH_ASSERTXD( marker.index < MaxMarkers, "Marker doesn't belong to a manager of this object");
     if ( markers[ marker.index] == marker.value)
     {
         markers[ marker.index] = GRAPH_MARKER_CLEAN;
@@ -233,17 +245,18 @@ inline bool Marked::unmark( Marker marker)
 /**
  * Clears value for given index
  */
-inline void Marked::clear( MarkerIndex i)
+template < MarkerIndex MaxMarkers>
+inline void Marked< MaxMarkers>::clear( MarkerIndex i)
 {
        markers[ i] = GRAPH_MARKER_CLEAN;
 }
 
 /**
- * Class that creates/frees markers
+ * Class that creates/frees markers. Up to MaxMarkers markers can be used simultaneously
  *
  * @ingroup Mark
  */
-class MarkerManager
+template < MarkerIndex MaxMarkers = MAX_GRAPH_MARKERS> class MarkerManager
 {
 public:
 
@@ -263,7 +276,7 @@ protected:
     /**
      * Clears unused markers in given object
      */
-    void clearUnusedMarkers( Marked *m_obj);
+    inline void clearUnusedMarkers( Marked< MaxMarkers> *m_obj);
 private:
     /** Find free index */
     inline MarkerIndex findFreeIndex();
@@ -281,10 +294,10 @@ private:
     inline MarkerValue findNextFreeValue();
 
     /** Marker values for each index */
-    MarkerValue markers[ MAX_GRAPH_MARKERS];
+    MarkerValue markers[ MaxMarkers];
     
     /** Usage flags for each index */
-    bool is_used[ MAX_GRAPH_MARKERS];
+    bool is_used[ MaxMarkers];
     
     /** Last free value */
     MarkerValue last;
@@ -293,12 +306,13 @@ private:
 /**
  * Find free index
  */
+template < MarkerIndex MaxMarkers>
 inline MarkerIndex 
-MarkerManager::findFreeIndex()
+MarkerManager< MaxMarkers>::findFreeIndex()
 {
     MarkerIndex i = 0;
     /** Search for free marker index */
-    for ( i = 0; i < MAX_GRAPH_MARKERS; i++)
+    for ( i = 0; i < MaxMarkers; i++)
     {
         if ( !is_used [ i])
         {
@@ -312,8 +326,9 @@ MarkerManager::findFreeIndex()
 /**
  * Increment marker value
  */
+template < MarkerIndex MaxMarkers>
 inline MarkerValue 
-MarkerManager::nextValue()
+MarkerManager< MaxMarkers>::nextValue()
 {
     if ( last == GRAPH_MARKER_LAST)
     {
@@ -328,11 +343,12 @@ MarkerManager::nextValue()
 /**
  * Check if this value is busy
  */
+template < MarkerIndex MaxMarkers>
 inline bool 
-MarkerManager::isValueBusy( MarkerValue val)
+MarkerManager< MaxMarkers>::isValueBusy( MarkerValue val)
 {
     /** Check all markers */
-    for ( MarkerIndex i = 0; i < MAX_GRAPH_MARKERS; i++)
+    for ( MarkerIndex i = 0; i < MaxMarkers; i++)
     {
         if ( is_used [ i] && markers[ i] == val)
             return true;
@@ -343,8 +359,9 @@ MarkerManager::isValueBusy( MarkerValue val)
 /**
  * Return next free value
  */
+template < MarkerIndex MaxMarkers>
 inline MarkerValue 
-MarkerManager::findNextFreeValue()
+MarkerManager< MaxMarkers>::findNextFreeValue()
 {
     MarkerIndex i = 0;
     bool reached_limit = false;
@@ -370,10 +387,11 @@ MarkerManager::findNextFreeValue()
 /**
  * Clears unused markers in given object
  */
+template < MarkerIndex MaxMarkers>
 inline void 
-MarkerManager::clearUnusedMarkers( Marked *m_obj)
+MarkerManager< MaxMarkers>::clearUnusedMarkers( Marked< MaxMarkers> *m_obj)
 {
-    for ( MarkerIndex i = 0; i < MAX_GRAPH_MARKERS; i++)
+    for ( MarkerIndex i = 0; i < MaxMarkers; i++)
     {
         if ( !is_used [ i])
             m_obj->clear( i);
@@ -383,12 +401,13 @@ MarkerManager::clearUnusedMarkers( Marked *m_obj)
 /**
  * Default Constructor
  */
-inline MarkerManager::MarkerManager()
+template < MarkerIndex MaxMarkers>
+inline MarkerManager< MaxMarkers>::MarkerManager()
 {
     MarkerIndex i;
 
     /** Initialize markers */
-    for ( i = 0; i < MAX_GRAPH_MARKERS; i++)
+    for ( i = 0; i < MaxMarkers; i++)
     {
         markers [ i] = GRAPH_MARKER_CLEAN;
         is_used [ i] = false;
@@ -400,7 +419,8 @@ inline MarkerManager::MarkerManager()
  * Acquire new marker. Markers MUST be freed after use,
  * otherwise you run to markers number limit.
  */
-inline Marker MarkerManager::newMarker()
+template < MarkerIndex MaxMarkers>
+inline Marker MarkerManager< MaxMarkers>::newMarker()
 {
     try {
         Marker new_marker;
@@ -426,8 +446,32 @@ inline Marker MarkerManager::newMarker()
 /**
  * Free marker
  */
-inline void MarkerManager::freeMarker( Marker m)
+template < MarkerIndex MaxMarkers>
+inline void MarkerManager< MaxMarkers>::freeMarker( Marker m)
 {
+    GRAPH_ASSERTXD( m.index < MaxMarkers, "Marker doesn't belong to this manager");
     is_used[ m.index] = false;
 }
+
+/**
+ * Object without markers. Used for the object types that don't need marking
+ *
+ * @ingroup Mark
+ */
+template <> class Marked< 0>
+{
+
+};
+
+/**
+ * Manager of zero markers. Markers can't be acquired, objects don't need clearing
+ *
+ * @ingroup Mark
+ */
+template <> class MarkerManager< 0>
+{
+protected:
+    /** Nothing to clear in objects without markers */
+    inline void clearUnusedMarkers( Marked< 0> *){}
+};
 } //namespace Graph
\ No newline at end of file
@@ -53,9 +53,8 @@ namespace Graph
   }
   @endcode
  *
- * A node can be @ref Marked "marked" and @ref Numbered "numbered". @ref Mark "Markers" and
- * @ref Nums "numerations" are managed by @ref GraphImpl "GraphImpl". Note that @ref EdgeImpl "edges" can be marked with the
- * same marker or numbered in the same numeration.
+ * Marking and numbering of nodes is implemented by the Node template, because the number
+ * of @ref Mark "markers" and @ref Nums "numerations" is a parameter of the graph type.
  * 
  * All nodes in graph are linked in a list. Previous and next nodes can be obtained
  * through prevNode and nextNode routines. Also for debug purposes all nodes in a GraphImpl
@@ -70,7 +69,6 @@ namespace Graph
  * @sa Nums
  */
 class NodeImpl: 
-    public Marked, public Numbered,
     public ListItem< NodeListTag>
 {
 public:
@@ -78,9 +76,10 @@ public:
     /**
      * @brief Destructor.
      * Destructs the node. Operator delete shouldn't be called directly.
-     * Use GraphImpl::deleteNode for freeing memory and destruction
+     * Use GraphImpl::deleteNode for freeing memory and destruction.
+     * Not virtual unless GRAPH_VIRTUAL_OBJECTS is defined
      */
-    virtual ~NodeImpl();
+    GRAPH_OBJ_VIRTUAL ~NodeImpl();
     
     inline GraphUid id() const;  /**< Get node's unique ID           */
     inline GraphImpl * graph() const;/**< Get node's corresponding graph */
@@ -105,7 +104,7 @@ public:
     inline void deletePred( EdgeImpl* edge); /**< Delete predecessor edge */
     inline void deleteSucc( EdgeImpl* edge); /**< Delete successor edge   */
     
-    virtual void debugPrint(); /**< Print node in DOT format to stdout */
+    GRAPH_OBJ_VIRTUAL void debugPrint(); /**< Print node in DOT format to stdout */
 
 protected:
     /** We can't create nodes separately, do it through newNode method of graph */
@@ -178,8 +177,9 @@ public:
   }
 @endcode
  * A node can be @ref Marked "marked" and @ref Numbered "numbered". @ref Mark "Markers" and
- * @ref Nums "numerations" are managed by @ref GraphImpl "GraphImpl". Note that @ref EdgeImpl "edges" can be marked with the
- * same marker or numbered in the same numeration.
+ * @ref Nums "numerations" are managed by the @ref Graph "graph". Note that @ref Edge "edges" can be marked with the
+ * same marker or numbered in the same numeration. The number of markers and numerations is set by
+ * MaxMarkers and MaxNums parameters which must be the same as the ones of the graph.
  * 
  * All nodes in GraphImpl are linked in a list. Previous and next nodes can be obtained
  * through prevNode and nextNode routines. Also for debug purposes all nodes in a GraphImpl
@@ -187,6 +187,8 @@ public:
  *
  * A node resides in memory pool that is controlled by Graph. Operator new can't be called 
  * directly. Nodes can be only created by newNode method of Graph class. 
+ * Nodes don't have a virtual table unless GRAPH_VIRTUAL_OBJECTS is defined. Graph destroys
+ * and prints them through the most derived type N, so N should be the final class in hierarchy.
  *
  * Nodes have associated QDomElement for XML export support. The updateElement() routine should be called before 
  * export to get element in sync with node's properties.
@@ -197,12 +199,15 @@ public:
  * @sa Mark
  * @sa Nums
  */
-template < class G, class N, class E> class Node: 
+template < class G, class N, class E,
+           MarkerIndex MaxMarkers = MAX_GRAPH_MARKERS, NumIndex MaxNums = MAX_NUMERATIONS>
+class Node: 
     public NodeImpl,
-    public PoolObj< N, UseCustomFixedPool>
+    public Marked< MaxMarkers>,
+    public Numbered< MaxNums>
 {
 public:
-    virtual ~Node();
+    ~Node();
 
     inline G * graph()  const;/**< Get node's corresponding GraphImpl */
     inline N* nextNode() const;     /**< Next node in GraphImpl's list      */
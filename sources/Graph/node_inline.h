@@ -156,8 +156,8 @@ NodeImpl::deleteEdgeInDir( GraphDir dir, EdgeImpl* edge)
     }
 }
 
-template < class G, class N, class E> 
-Node< G, N, E>::~Node()
+template < class G, class N, class E, MarkerIndex MaxMarkers, NumIndex MaxNums> 
+Node< G, N, E, MaxMarkers, MaxNums>::~Node()
 {
     E *edge;
     
@@ -177,35 +177,35 @@ Node< G, N, E>::~Node()
 }
 
 /** Get node's corresponding GraphImpl */
-template < class G, class N, class E> 
+template < class G, class N, class E, MarkerIndex MaxMarkers, NumIndex MaxNums> 
 G* 
-Node< G, N, E>::graph() const
+Node< G, N, E, MaxMarkers, MaxNums>::graph() const
 {
     return static_cast< G*>(NodeImpl::graph());
 }
 
 /** Next node in GraphImpl's list      */
-template < class G, class N, class E>
+template < class G, class N, class E, MarkerIndex MaxMarkers, NumIndex MaxNums>
 N *
-Node< G, N, E>::nextNode() const
+Node< G, N, E, MaxMarkers, MaxNums>::nextNode() const
 {
     return static_cast< N*>(NodeImpl::nextNode());
 }
 
 /**< Prev node in GraphImpl's list      */
-template < class G, class N, class E> N * Node< G, N, E>::prevNode() const
+template < class G, class N, class E, MarkerIndex MaxMarkers, NumIndex MaxNums> N * Node< G, N, E, MaxMarkers, MaxNums>::prevNode() const
 {
     return static_cast< N*>(NodeImpl::prevNode());
 }
 
 /**< Get first successor edge    */
-template < class G, class N, class E> E * Node< G, N, E>::firstSucc() const
+template < class G, class N, class E, MarkerIndex MaxMarkers, NumIndex MaxNums> E * Node< G, N, E, MaxMarkers, MaxNums>::firstSucc() const
 {
     return static_cast< E*>(NodeImpl::firstSucc());
 } 
 
 /**< Get first predecessor edge  */
-template < class G, class N, class E> E * Node< G, N, E>::firstPred() const
+template < class G, class N, class E, MarkerIndex MaxMarkers, NumIndex MaxNums> E * Node< G, N, E, MaxMarkers, MaxNums>::firstPred() const
 {
     return static_cast< E*>(NodeImpl::firstPred());
 }
@@ -214,9 +214,9 @@ template < class G, class N, class E> E * Node< G, N, E>::firstPred() const
 /**
  * Create iterator for first succ
  */
-template < class G, class N, class E> 
-typename Node< G, N, E>::Succ
-Node< G, N, E>::succsBegin()
+template < class G, class N, class E, MarkerIndex MaxMarkers, NumIndex MaxNums> 
+typename Node< G, N, E, MaxMarkers, MaxNums>::Succ
+Node< G, N, E, MaxMarkers, MaxNums>::succsBegin()
 {
     return Succ( static_cast<N *>(this) );
 }
@@ -224,27 +224,27 @@ Node< G, N, E>::succsBegin()
 /**
  * Create iterator pointing to succ end
  */
-template < class G, class N, class E> 
-typename Node< G, N, E>::Succ
-Node< G, N, E>::succsEnd()
+template < class G, class N, class E, MarkerIndex MaxMarkers, NumIndex MaxNums> 
+typename Node< G, N, E, MaxMarkers, MaxNums>::Succ
+Node< G, N, E, MaxMarkers, MaxNums>::succsEnd()
 {
     return Succ();
 }
 /**
  * Create iterator for first succ
  */
-template < class G, class N, class E> 
-typename Node< G, N, E>::Pred
-Node< G, N, E>::predsBegin()
+template < class G, class N, class E, MarkerIndex MaxMarkers, NumIndex MaxNums> 
+typename Node< G, N, E, MaxMarkers, MaxNums>::Pred
+Node< G, N, E, MaxMarkers, MaxNums>::predsBegin()
 {
     return Pred( static_cast<N *>(this));
 }
 /**
  * Create iterator pointing to succ end
  */
-template < class G, class N, class E> 
-typename Node< G, N, E>::Pred
-Node< G, N, E>::predsEnd()
+template < class G, class N, class E, MarkerIndex MaxMarkers, NumIndex MaxNums> 
+typename Node< G, N, E, MaxMarkers, MaxNums>::Pred
+Node< G, N, E, MaxMarkers, MaxNums>::predsEnd()
 {
     return Pred();
 }
@@ -252,18 +252,18 @@ Node< G, N, E>::predsEnd()
 /**
  * Create iterator for first succ
  */
-template < class G, class N, class E> 
-typename Node< G, N, E>::EdgeIter
-Node< G, N, E>::edgesBegin()
+template < class G, class N, class E, MarkerIndex MaxMarkers, NumIndex MaxNums> 
+typename Node< G, N, E, MaxMarkers, MaxNums>::EdgeIter
+Node< G, N, E, MaxMarkers, MaxNums>::edgesBegin()
 {
     return EdgeIter( static_cast<N *>(this));
 }
 /**
  * Create iterator pointing to succ end
  */
-template < class G, class N, class E> 
-typename Node< G, N, E>::EdgeIter
-Node< G, N, E>::edgesEnd()
+template < class G, class N, class E, MarkerIndex MaxMarkers, NumIndex MaxNums> 
+typename Node< G, N, E, MaxMarkers, MaxNums>::EdgeIter
+Node< G, N, E, MaxMarkers, MaxNums>::edgesEnd()
 {
     return EdgeIter();
 }
@@ -21,14 +21,14 @@
  * When you done with using numbers free the numeration by calling NumManager::freeNum().
  *@code
  //Derive your class from Numbered
- class Obj: public Numbered
+ class Obj: public Numbered<>
  {
  pubic:
      void someAction();
      ...
  }
  //Derive class that controls Obj's instances from NumManager
- class ObjManager: public NumManager
+ class ObjManager: public NumManager<>
  {
      // QList from Qt's containers
      QList<Obj *> objs;
@@ -64,7 +64,7 @@
      man.freeNum( num); // Free numeration
  }
  @endcode
- * You can have not more than MAX_NUMERATIONS at one time so if you forget to 
+ * You can have not more than MaxNums (MAX_NUMERATIONS by default) at one time so if you forget to 
  * free a numeration you'll run into exception telling you that there are no free numeration
  * indices left.
  *
@@ -113,7 +113,12 @@ enum NumErrorType
  * Number of numerations allowed simultaneously  
  * @ingroup Nums
  */
-const short int MAX_NUMERATIONS = 10;
+const NumIndex MAX_NUMERATIONS = 10;
+/** 
+ * Index of numeration that doesn't belong to any manager
+ * @ingroup Nums
+ */
+const NumIndex NUM_NO_INDEX = ( NumIndex)( -1);
 /** 
  * Clean value
  * @ingroup Nums
@@ -174,13 +179,13 @@ private:
     NumValue value;
 
     /* Two classes have acces to num internals. All others do not. */
-    friend class Numbered;
-    friend class NumManager;
+    template < NumIndex MaxNums> friend class Numbered;
+    template < NumIndex MaxNums> friend class NumManager;
 };
 
 /** Default constructor */
 inline Numeration::Numeration():
-    index( MAX_NUMERATIONS), value( NUM_VAL_CLEAN)
+    index( NUM_NO_INDEX), value( NUM_VAL_CLEAN)
 {
 
 }
@@ -198,8 +203,9 @@ inline Numeration::Numeration():
  * given to it. Until then object is unnumbered. It is also possible to wipe the number from object
  * by calling unNumber(). Most routines have the @ref Numeration "numeration" parameter. It 
  * describes numeration of interest and is obtained from a @ref NumManager "numeration manager".
+ * The object can be a member of up to MaxNums numerations.
  */
-class Numbered
+template < NumIndex MaxNums = MAX_NUMERATIONS> class Numbered
 {
 public:
     /** Constructor */
@@ -221,19 +227,20 @@ public:
     inline void clear( NumIndex i);
 private:
     /** Numeration descriptions */
-    NumValue nums[ MAX_NUMERATIONS];
+    NumValue nums[ MaxNums];
 
     /** Number in each numeration */
-    GraphNum numbers[ MAX_NUMERATIONS];
+    GraphNum numbers[ MaxNums];
 };
 
 /** Constructor */
-inline Numbered::Numbered()
+template < NumIndex MaxNums>
+inline Numbered< MaxNums>::Numbered()
 {
     NumIndex i;
 
     /** Initialize nums */
-    for ( i = 0; i < MAX_NUMERATIONS; i++)
+    for ( i = 0; i < MaxNums; i++)
     {
         nums [ i] = NUM_VAL_CLEAN;
     }
@@ -242,10 +249,12 @@ inline Numbered::Numbered()
 /**
  * Assign a number to object. Return false if object is already numbered. True otherwise.
  */
+template < NumIndex MaxNums>
 inline bool 
-Numbered::setNumber( Numeration num,
+Numbered< MaxNums>::setNumber( Numeration num,
                      GraphNum new_number)
 {
+    GRAPH_ASSERTXD( num.index < MaxNums, "Numeration doesn't belong to a manager of this object");
     if ( new_number >= NUMBER_MAX)
         throw NUM_ERROR_NUMBER_OUT_OF_RANGE;
 
@@ -261,9 +270,11 @@ Numbered::setNumber( Numeration num,
 /**
  * Return number in given numeration or NO_NUM if it was not numbered yet
  */
+template < NumIndex MaxNums>
 inline GraphNum 
-Numbered::number( Numeration num)
+Numbered< MaxNums>::number( Numeration num)
 {
+    GRAPH_ASSERTXD( num.index < MaxNums, "Numeration doesn't belong to a manager of this object");
     if ( nums[ num.index] == num.value)
     {
         return numbers[ num.index];
@@ -274,9 +285,11 @@ Numbered::number( Numeration num)
 /**
  * Return true if node is numbered in this numeration
  */
+template < NumIndex MaxNums>
 inline bool 
-Numbered::isNumbered( Numeration num)
+Numbered< MaxNums>::isNumbered( Numeration num)
 {
+    GRAPH_ASSERTXD( num.index < MaxNums, "Numeration doesn't belong to a manager of this object");
     if ( nums[ num.index] == num.value)
     {
         return true;
@@ -287,9 +300,11 @@ Numbered::isNumbered( Numeration num)
 /**
  * Return true if node has been numbered in this numeration and unmarks it
  */
+template < NumIndex MaxNums>
 inline bool 
-Numbered::unNumber( Numeration num)
+Numbered< MaxNums>::unNumber( Numeration num)
 {
+    GRAPH_ASSERTXD( num.index < MaxNums, "Numeration doesn't belong to a manager of this object");
     if ( nums[ num.index] == num.value)
     {
         nums[ num.index] = NUM_VAL_CLEAN;
@@ -301,8 +316,9 @@ Numbered::unNumber( Numeration num)
 /**
  * Clears value for given index
  */
+template < NumIndex MaxNums>
 inline void 
-Numbered::clear( NumIndex i)
+Numbered< MaxNums>::clear( NumIndex i)
 {
        nums[ i] = NUM_VAL_CLEAN;
 }
@@ -312,11 +328,11 @@ Numbered::clear( NumIndex i)
  * @ingroup Nums
  *
 
- * @ref NumManager "Numeration manager" creates and frees numerations. You can have up to MAX_NUMERATIONS numerations
+ * @ref NumManager "Numeration manager" creates and frees numerations. You can have up to MaxNums numerations
  * at a time. A derived class should reimplement clearNumerationsInObjects() routine which calls clearUnusedNumerations
  * for every Numbered-derived object.
  */
-class NumManager
+template < NumIndex MaxNums = MAX_NUMERATIONS> class NumManager
 {
 public:
 
@@ -335,12 +351,12 @@ public:
     void freeNum( Numeration n);
 protected:
     /** Clears unused markers in given object */
-    inline void clearUnusedNumerations( Numbered *n_obj);
+    inline void clearUnusedNumerations( Numbered< MaxNums> *n_obj);
 private:
     /** Marker values for each numeration */
-    NumValue nums[ MAX_NUMERATIONS];
+    NumValue nums[ MaxNums];
     /** Usage flags for each numeration index */
-    bool is_used[ MAX_NUMERATIONS];
+    bool is_used[ MaxNums];
     /** Last used value */
     NumValue last;
 
@@ -369,11 +385,12 @@ private:
 /**
  * Find free index
  */
-inline NumIndex NumManager::findFreeIndex()
+template < NumIndex MaxNums>
+inline NumIndex NumManager< MaxNums>::findFreeIndex()
 {
     NumIndex i = 0;
     /** Search for free num index */
-    for ( i = 0; i < MAX_NUMERATIONS; i++)
+    for ( i = 0; i < MaxNums; i++)
     {
         if ( !is_used [ i])
         {
@@ -387,7 +404,8 @@ inline NumIndex NumManager::findFreeIndex()
 /**
  * Increment num value
  */
-inline NumValue NumManager::nextValue()
+template < NumIndex MaxNums>
+inline NumValue NumManager< MaxNums>::nextValue()
 {
     if ( last == NUM_VAL_LAST)
     {
@@ -402,10 +420,11 @@ inline NumValue NumManager::nextValue()
 /**
  * Check if this value is busy
  */
-inline bool NumManager::isValueBusy( NumValue val)
+template < NumIndex MaxNums>
+inline bool NumManager< MaxNums>::isValueBusy( NumValue val)
 {
     /** Check all nums */
-    for ( NumIndex i = 0; i < MAX_NUMERATIONS; i++)
+    for ( NumIndex i = 0; i < MaxNums; i++)
     {
         if ( is_used [ i] && nums[ i] == val)
             return true;
@@ -416,7 +435,8 @@ inline bool NumManager::isValueBusy( NumValue val)
 /**
  * Return next free value
  */
-inline NumValue NumManager::findNextFreeValue()
+template < NumIndex MaxNums>
+inline NumValue NumManager< MaxNums>::findNextFreeValue()
 {
     NumIndex i = 0;
     bool reached_limit = false;
@@ -443,9 +463,10 @@ inline NumValue NumManager::findNextFreeValue()
 /**
  * Clears unused markers in given object
  */
-inline void NumManager::clearUnusedNumerations( Numbered *n_obj)
+template < NumIndex MaxNums>
+inline void NumManager< MaxNums>::clearUnusedNumerations( Numbered< MaxNums> *n_obj)
 {
-    for ( NumIndex i = 0; i < MAX_NUMERATIONS; i++)
+    for ( NumIndex i = 0; i < MaxNums; i++)
     {
         if ( !is_used [ i])
             n_obj->clear( i);
@@ -455,12 +476,13 @@ inline void NumManager::clearUnusedNumerations( Numbered *n_obj)
 /**
  * Default Constructor
  */
-inline NumManager::NumManager()
+template < NumIndex MaxNums>
+inline NumManager< MaxNums>::NumManager()
 {
     NumIndex i;
 
     /** Initialize nums */
-    for ( i = 0; i < MAX_NUMERATIONS; i++)
+    for ( i = 0; i < MaxNums; i++)
     {
         nums [ i] = NUM_VAL_CLEAN;
         is_used [ i] = false;
@@ -471,7 +493,8 @@ inline NumManager::NumManager()
 /**
  * Create new numeration
  */
-inline Numeration NumManager::newNum()
+template < NumIndex MaxNums>
+inline Numeration NumManager< MaxNums>::newNum()
 {
     Numeration new_num;
         
@@ -485,9 +508,31 @@ inline Numeration NumManager::newNum()
 /**
  * Free num
  */
-inline void NumManager::freeNum( Numeration n)
+template < NumIndex MaxNums>
+inline void NumManager< MaxNums>::freeNum( Numeration n)
 {
+    GRAPH_ASSERTXD( n.index < MaxNums, "Numeration doesn't belong to this manager");
     is_used[ n.index] = false;
 }
 
+
+/**
+ * Object that can't be numbered. Used for the object types that don't need numerations
+ * @ingroup Nums
+ */
+template <> class Numbered< 0>
+{
+
+};
+
+/**
+ * Manager of zero numerations. Numerations can't be created, objects don't need clearing
+ * @ingroup Nums
+ */
+template <> class NumManager< 0>
+{
+protected:
+    /** Nothing to clear in objects without numerations */
+    inline void clearUnusedNumerations( Numbered< 0> *){}
+};
 } //namespace Graph
\ No newline at end of file
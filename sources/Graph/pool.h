@@ -0,0 +1,451 @@
+/**
+ * @file: pool.h
+ * Definition and implementation of the memory pool for graph's nodes and edges
+ */
+/*
+ * Graph library, internal representation of graphs in compiler prototype project
+ * Copyright (C) 2012  Boris Shurygin
+ */
+#pragma once
+#ifndef GRAPH_POOL_H
+#define GRAPH_POOL_H
+
+#if defined(_MSC_VER)
+#  include <intrin.h>
+#endif
+
+namespace Graph
+{
+
+/**
+ * Number of 64-bit occupancy words in one chunk of graph pool
+ * @ingroup GraphBase
+ */
+const UInt32 GRAPH_POOL_CHUNK_WORDS = 1;
+
+/**
+ * Number of entries in one chunk of graph pool
+ * @ingroup GraphBase
+ */
+const UInt32 GRAPH_POOL_CHUNK_SIZE = GRAPH_POOL_CHUNK_WORDS * 64;
+
+/**
+ * Index of the least significant set bit of a non-zero word
+ * @ingroup GraphBase
+ */
+inline UInt32 lowestBit( UInt64 word)
+{
+    GRAPH_ASSERTD( word != 0);
+#if defined(_MSC_VER)
+    unsigned long res;
+#  if defined(_WIN64)
+    _BitScanForward64( &res, word);
+#  else
+    if ( !_BitScanForward( &res, (unsigned long)word))
+    {
+        _BitScanForward( &res, (unsigned long)( word >> 32));
+        res += 32;
+    }
+#  endif
+    return (UInt32)res;
+#else
+    return (UInt32)__builtin_ctzll( word);
+#endif
+}
+
+template < class Data> class PoolIter;
+
+/**
+ * @brief Memory usage statistics of a pool
+ * @ingroup GraphBase
+ */
+struct PoolStats
+{
+    GraphNum live_entries;   /**< Number of live objects                         */
+    GraphNum free_entries;   /**< Number of freed entries waiting for reuse      */
+    GraphNum unused_entries; /**< Number of never used entries in the last chunk */
+    UInt32 chunks;           /**< Number of allocated chunks                     */
+    UInt32 object_size;      /**< Size of the object                             */
+    UInt32 entry_size;       /**< Size of the entry including pool's header      */
+    UInt64 bytes;            /**< Memory allocated by the pool                   */
+
+    /** Share of freed entries among the entries that have been used */
+    inline double fragmentation() const;
+
+    /** Print statistics to stream in one line */
+    inline void toStream( ostream& os) const;
+};
+
+/**
+ * @class GraphPool
+ * @brief Chunked memory pool for the objects of one type
+ * @ingroup GraphBase
+ *
+ * @details
+ * The pool carves memory in chunks of GRAPH_POOL_CHUNK_SIZE entries. Each chunk keeps
+ * an occupancy bitmap with one bit per entry, so all live objects can be visited
+ * in memory order by scanning the chunks sequentially and skipping the free slots.
+ * Freed entries are reused in LIFO order before new entries are taken from the last chunk.
+ * The pool only manages raw memory, construction and destruction of objects is done by the owner.
+ * @sa PoolIter
+ */
+template < class Data> class GraphPool
+{
+public:
+    /** Constructor */
+    inline GraphPool();
+
+    /** Destructor, releases chunks without destructing the objects */
+    inline ~GraphPool();
+
+    /** Get memory for one object */
+    inline void *allocate();
+
+    /** Return object's memory to the pool */
+    inline void deallocate( void *ptr);
+
+    /** Number of live objects */
+    inline GraphNum numEntries() const;
+
+    /** Get memory usage statistics */
+    inline PoolStats stats() const;
+
+    /** Iterator pointing to the first live object in memory order */
+    inline PoolIter< Data> begin() const;
+
+    /** Iterator pointing to the end of pool */
+    inline PoolIter< Data> end() const;
+
+private:
+    /** Memory entry, the object's storage is prefixed by its slot number in chunk */
+    struct Entry
+    {
+        UInt32 slot; /**< Entry number in chunk */
+        union
+        {
+            Entry *next_free; /**< Next free entry when the entry is not used */
+            UInt64 data[ ( sizeof( Data) + sizeof( UInt64) - 1) / sizeof( UInt64)]; /**< Object's storage */
+        };
+    };
+
+    /** Chunk of entries */
+    struct Chunk
+    {
+        Chunk *next;                          /**< Next chunk of the pool */
+        UInt64 busy[ GRAPH_POOL_CHUNK_WORDS]; /**< Occupancy bitmap     */
+        Entry entries[ GRAPH_POOL_CHUNK_SIZE];/**< Entries              */
+    };
+
+    /** Get the chunk that holds the given entry */
+    inline static Chunk *chunkOf( Entry *e);
+
+    /** Get the entry by the object's address */
+    inline static Entry *entryOf( void *ptr);
+
+    UInt32 chunk_num;   /**< Number of chunks                          */
+    Chunk *first_chunk; /**< First chunk                               */
+    Chunk *last_chunk;  /**< Chunk where new entries are taken from    */
+    UInt32 last_used;   /**< Number of entries ever used in last chunk */
+    Entry *free_entry;  /**< Head of the free entries list             */
+    GraphNum entry_num; /**< Number of live objects                    */
+
+    friend class PoolIter< Data>;
+};
+
+/**
+ * @class PoolIter
+ * @brief Iterator over the live objects of GraphPool in memory order
+ * @ingroup GraphBase
+ *
+ * @details
+ * The iterator caches the occupancy word it currently walks, so the object that the iterator
+ * points to can be destroyed and deallocated before the increment.
+ */
+template < class Data> class PoolIter
+{
+public:
+    /** Default constructor creates end iterator */
+    inline PoolIter();
+
+    inline PoolIter & operator++();   /**< Preincrement operator  */
+    inline PoolIter operator++( int); /**< Postincrement operator */
+    inline Data * operator*() const;  /**< Dereferenece operator  */
+
+    /** Comparison operator */
+    inline bool operator==( const PoolIter& o) const;
+
+    /** Not equals operator */
+    inline bool operator!=( const PoolIter& o) const;
+private:
+    typedef typename GraphPool< Data>::Chunk Chunk;
+
+    /** Constructor of iterator pointing to first object of the chunk list */
+    inline PoolIter( Chunk *chunk);
+
+    /** Advance to the next live object starting from current position */
+    inline void findNext();
+
+    Chunk *chunk;   /**< Current chunk                          */
+    UInt32 word;    /**< Current occupancy word                 */
+    UInt64 bits;    /**< Bits of current word not visited yet   */
+    Data *data_p;   /**< Current object                         */
+
+    friend class GraphPool< Data>;
+};
+
+/** Share of freed entries among the entries that have been used */
+inline double
+PoolStats::fragmentation() const
+{
+    if ( live_entries + free_entries == 0)
+        return 0;
+    return (double)free_entries / ( live_entries + free_entries);
+}
+
+/** Print statistics to stream in one line */
+inline void
+PoolStats::toStream( ostream& os) const
+{
+    os << "live " << live_entries
+       << ", free " << free_entries
+       << ", unused " << unused_entries
+       << ", chunks " << chunks
+       << ", object " << object_size << "B"
+       << ", entry " << entry_size << "B"
+       << ", total " << bytes << "B"
+       << ", fragmentation " << fragmentation();
+}
+
+/** Constructor */
+template < class Data>
+GraphPool< Data>::GraphPool():
+    chunk_num( 0),
+    first_chunk( NULL),
+    last_chunk( NULL),
+    last_used( GRAPH_POOL_CHUNK_SIZE),
+    free_entry( NULL),
+    entry_num( 0)
+{
+
+}
+
+/** Destructor, releases chunks without destructing the objects */
+template < class Data>
+GraphPool< Data>::~GraphPool()
+{
+    Chunk *chunk = first_chunk;
+    while ( isNotNullP( chunk))
+    {
+        Chunk *next = chunk->next;
+        delete chunk;
+        chunk = next;
+    }
+}
+
+/** Get the chunk that holds the given entry */
+template < class Data>
+typename GraphPool< Data>::Chunk *
+GraphPool< Data>::chunkOf( Entry *e)
+{
+    return reinterpret_cast< Chunk *>( reinterpret_cast< char *>( e - e->slot)
+                                       - offsetof( Chunk, entries));
+}
+
+/** Get the entry by the object's address */
+template < class Data>
+typename GraphPool< Data>::Entry *
+GraphPool< Data>::entryOf( void *ptr)
+{
+    return reinterpret_cast< Entry *>( static_cast< char *>( ptr) - offsetof( Entry, data));
+}
+
+/** Get memory for one object */
+template < class Data>
+void *
+GraphPool< Data>::allocate()
+{
+    Entry *e;
+
+    if ( isNotNullP( free_entry))
+    {
+        e = free_entry;
+        free_entry = e->next_free;
+    } else
+    {
+        if ( last_used == GRAPH_POOL_CHUNK_SIZE)
+        {
+            /** Last chunk is exhausted, append a new one */
+            Chunk *chunk = new Chunk;
+            chunk->next = NULL;
+            for ( UInt32 i = 0; i < GRAPH_POOL_CHUNK_WORDS; i++)
+            {
+                chunk->busy[ i] = 0;
+            }
+            if ( isNullP( last_chunk))
+            {
+                first_chunk = chunk;
+            } else
+            {
+                last_chunk->next = chunk;
+            }
+            last_chunk = chunk;
+            last_used = 0;
+            chunk_num++;
+        }
+        e = &last_chunk->entries[ last_used];
+        e->slot = last_used++;
+    }
+    chunkOf( e)->busy[ e->slot / 64] |= (UInt64)1 << ( e->slot % 64);
+    entry_num++;
+    return e->data;
+}
+
+/** Return object's memory to the pool */
+template < class Data>
+void
+GraphPool< Data>::deallocate( void *ptr)
+{
+    GRAPH_ASSERTD( isNotNullP( ptr));
+    Entry *e = entryOf( ptr);
+    Chunk *chunk = chunkOf( e);
+    UInt64 mask = (UInt64)1 << ( e->slot % 64);
+
+    GRAPH_ASSERTXD( chunk->busy[ e->slot / 64] & mask, "Pool entry is freed twice");
+    chunk->busy[ e->slot / 64] &= ~mask;
+    e->next_free = free_entry;
+    free_entry = e;
+    entry_num--;
+}
+
+/** Number of live objects */
+template < class Data>
+GraphNum
+GraphPool< Data>::numEntries() const
+{
+    return entry_num;
+}
+
+/** Get memory usage statistics */
+template < class Data>
+PoolStats
+GraphPool< Data>::stats() const
+{
+    PoolStats res;
+
+    res.live_entries = entry_num;
+    res.unused_entries = ( chunk_num == 0) ? 0 : GRAPH_POOL_CHUNK_SIZE - last_used;
+    res.free_entries = chunk_num * GRAPH_POOL_CHUNK_SIZE - res.unused_entries - entry_num;
+    res.chunks = chunk_num;
+    res.object_size = sizeof( Data);
+    res.entry_size = sizeof( Entry);
+    res.bytes = (UInt64)chunk_num * sizeof( Chunk);
+    return res;
+}
+
+/** Iterator pointing to the first live object in memory order */
+template < class Data>
+PoolIter< Data>
+GraphPool< Data>::begin() const
+{
+    return PoolIter< Data>( first_chunk);
+}
+
+/** Iterator pointing to the end of pool */
+template < class Data>
+PoolIter< Data>
+GraphPool< Data>::end() const
+{
+    return PoolIter< Data>();
+}
+
+/** Default constructor creates end iterator */
+template < class Data>
+PoolIter< Data>::PoolIter():
+    chunk( NULL), word( 0), bits( 0), data_p( NULL)
+{
+
+}
+
+/** Constructor of iterator pointing to first object of the chunk list */
+template < class Data>
+PoolIter< Data>::PoolIter( Chunk *first):
+    chunk( first), word( 0), bits( 0), data_p( NULL)
+{
+    if ( isNotNullP( chunk))
+    {
+        bits = chunk->busy[ 0];
+        findNext();
+    }
+}
+
+/** Advance to the next live object starting from current position */
+template < class Data>
+void
+PoolIter< Data>::findNext()
+{
+    while ( bits == 0)
+    {
+        if ( ++word == GRAPH_POOL_CHUNK_WORDS)
+        {
+            chunk = chunk->next;
+            word = 0;
+            if ( isNullP( chunk))
+            {
+                data_p = NULL;
+                return;
+            }
+        }
+        bits = chunk->busy[ word];
+    }
+    UInt32 slot = word * 64 + lowestBit( bits);
+    bits &= bits - 1;
+    data_p = reinterpret_cast< Data *>( chunk->entries[ slot].data);
+}
+
+/** Preincrement operator */
+template < class Data>
+PoolIter< Data> &
+PoolIter< Data>::operator++()
+{
+    GRAPH_ASSERTXD( isNotNullP( data_p), "Pool iterator is at end");
+    findNext();
+    return *this;
+}
+
+/** Postincrement operator */
+template < class Data>
+PoolIter< Data>
+PoolIter< Data>::operator++( int)
+{
+    PoolIter tmp = *this;
+    ++*this;
+    return tmp;
+}
+
+/** Dereferenece operator */
+template < class Data>
+Data *
+PoolIter< Data>::operator*() const
+{
+    return data_p;
+}
+
+/** Comparison operator */
+template < class Data>
+bool
+PoolIter< Data>::operator==( const PoolIter& o) const
+{
+    return data_p == o.data_p;
+}
+
+/** Not equals operator */
+template < class Data>
+bool
+PoolIter< Data>::operator!=( const PoolIter& o) const
+{
+    return !( *this == o);
+}
+
+} // namespace Graph
+
+#endif /* GRAPH_POOL_H */
@@ -31,6 +31,19 @@ namespace Graph
      */
 #if !defined(GRAPH_ASSERTXD)
 #    define GRAPH_ASSERTXD(cond, what) ASSERT_XD(cond, "Graph", what)
+#endif
+
+    /**
+     * Qualifier of the destructors and printing routines of nodes and edges.
+     * Nodes and edges carry no virtual table by default. They are destroyed and printed
+     * through their most derived type known to Graph< G, N, E>. Define GRAPH_VIRTUAL_OBJECTS
+     * if nodes or edges have to be destroyed or printed through NodeImpl/EdgeImpl pointers.
+     * @ingroup GraphBase
+     */
+#if defined(GRAPH_VIRTUAL_OBJECTS)
+#    define GRAPH_OBJ_VIRTUAL virtual
+#else
+#    define GRAPH_OBJ_VIRTUAL
 #endif
 
     /**
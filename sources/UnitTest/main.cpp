@@ -23,6 +23,20 @@ int main(int argc, char **argv)
     RUN_TEST( Graph::uTest);
     /** Test optimizer package */
     RUN_TEST_OUT_FILE_CHECK( Opt::uTest, "opt_utest.txt");
+    RUN_TEST( Opt::uTestSSA);
+    RUN_TEST( Opt::uTestDeps);
+    RUN_TEST( Opt::uTestSched);
+    RUN_TEST( Opt::uTestOperandSets);
+    RUN_TEST( Opt::uTestArena);
+    RUN_TEST( Opt::uTestReader);
+    RUN_TEST( Opt::uTestBitcode);
+    RUN_TEST( Opt::uTestDriver);
+    RUN_TEST( Opt::uTestPassManager);
+    RUN_TEST( Opt::uTestLiveness);
+    RUN_TEST( Opt::uTestDataflow);
+    RUN_TEST( Opt::uTestSCCP);
+    RUN_TEST( Opt::uTestDCE);
+    RUN_TEST( Opt::uTestGVN);
     
     /*
      * NOTE: For the unit tests below the logging can be usefull, 
@@ -0,0 +1,212 @@
+/**
+ * @file: ir/arena.hpp
+ * Memory arena of the function's IR
+ * @ingroup IR
+ */
+ /*
+  * Copyright 2012 MIPT-COMPILER team
+  */
+
+#pragma once
+
+namespace IR
+{
+    /** Size of the regular arena chunk in bytes */
+    const UInt32 ARENA_CHUNK_SIZE = 16 * 1024;
+
+    /** Alignment of the memory given by the arena */
+    const UInt32 ARENA_ALIGN = sizeof( UInt64);
+
+    /** Step of the small blocks' size classes in bytes */
+    const UInt32 ARENA_SMALL_STEP = 16;
+
+    /** Largest small block, larger blocks have power of two size classes */
+    const UInt32 ARENA_SMALL_MAX = 256;
+
+    /** Number of size classes of the arena's blocks */
+    const UInt32 ARENA_SIZE_CLASSES = 48;
+
+    /**
+     * @class Arena
+     * @brief Chunked memory of one function's IR that is released at once
+     *
+     * Objects are cut from the chunks one after another and never freed separately.
+     * Arrays that may be freed like operands of operations, operand sets and use lists take blocks
+     * of size classes and the freed blocks are kept in the lists by size class for reuse. Small blocks
+     * have classes in steps of ARENA_SMALL_STEP bytes so exactly sized arrays waste little,
+     * larger ones are rounded up to a power of two. Blocks larger than a quarter of the chunk
+     * get their own chunks. The destructor releases the chunks without destructing anything
+     * in them, so only trivially destructible data should be put into the arena
+     * @ingroup IR
+     */
+    class Arena
+    {
+    public:
+        inline Arena();
+        inline ~Arena();
+
+        /** Get memory of the given size that lives as long as the arena */
+        inline void *allocate( size_t size);
+
+        /** Get block for an array of the given size, the size is rounded up to its size class */
+        inline void *allocateArray( size_t size);
+        /** Return the array block of the given size to the arena for reuse */
+        inline void deallocateArray( void *ptr, size_t size);
+
+        inline UInt32 numChunks() const; /**< Get number of allocated chunks */
+        inline UInt64 bytes() const;     /**< Get number of bytes allocated by the arena */
+    private:
+        /** Header of the chunk, the memory of the chunk follows it */
+        struct Chunk
+        {
+            Chunk *next;
+            UInt64 size;
+        };
+
+        /** Free array block */
+        struct FreeBlock
+        {
+            FreeBlock *next;
+        };
+
+        /** Get size class of the array block */
+        static inline UInt32 sizeClass( size_t size);
+        /** Get size of the blocks of the given class */
+        static inline size_t classSize( UInt32 c);
+        /** Allocate new chunk with the given number of bytes after the header */
+        inline char *newChunk( size_t size);
+
+        Chunk *chunks;     /**< List of the chunks, the last allocated goes first */
+        char *cur;         /**< Free part of the current chunk */
+        size_t cur_left;   /**< Number of bytes left in the current chunk */
+        UInt32 chunk_num;
+        UInt64 bytes_;
+        FreeBlock *free_blocks[ ARENA_SIZE_CLASSES]; /**< Free array blocks by size class */
+    };
+
+    /** Create empty arena */
+    Arena::Arena(): chunks( NULL), cur( NULL), cur_left( 0), chunk_num( 0), bytes_( 0)
+    {
+        for ( UInt32 i = 0; i < ARENA_SIZE_CLASSES; i++)
+        {
+            free_blocks[ i] = NULL;
+        }
+    }
+
+    /** Release all the chunks, takes time proportional to their number */
+    Arena::~Arena()
+    {
+        while ( isNotNullP( chunks) )
+        {
+            Chunk *next = chunks->next;
+
+            delete [] reinterpret_cast< UInt64 *>( chunks);
+            chunks = next;
+        }
+    }
+
+    /** Allocate new chunk with the given number of bytes after the header */
+    char *Arena::newChunk( size_t size)
+    {
+        size_t words = ( sizeof( Chunk) + size + sizeof( UInt64) - 1) / sizeof( UInt64);
+        Chunk *chunk = reinterpret_cast< Chunk *>( new UInt64[ words]);
+
+        chunk->next = chunks;
+        chunk->size = size;
+        chunks = chunk;
+        chunk_num++;
+        bytes_ += words * sizeof( UInt64);
+        return reinterpret_cast< char *>( chunk + 1);
+    }
+
+    /** Get memory of the given size that lives as long as the arena */
+    void *Arena::allocate( size_t size)
+    {
+        size = ( size + ARENA_ALIGN - 1) & ~( (size_t)ARENA_ALIGN - 1);
+
+        if ( size > ARENA_CHUNK_SIZE / 4)
+        {
+            return newChunk( size);
+        }
+        if ( size > cur_left)
+        {
+            /* The rest of the current chunk is left unused */
+            cur = newChunk( ARENA_CHUNK_SIZE);
+            cur_left = ARENA_CHUNK_SIZE;
+        }
+        void *ptr = cur;
+
+        cur += size;
+        cur_left -= size;
+        return ptr;
+    }
+
+    /** Get size class of the array block */
+    UInt32 Arena::sizeClass( size_t size)
+    {
+        const UInt32 small_classes = ARENA_SMALL_MAX / ARENA_SMALL_STEP;
+
+        if ( size <= ARENA_SMALL_MAX)
+        {
+            return (UInt32)( ( size + ARENA_SMALL_STEP - 1) / ARENA_SMALL_STEP) - 1;
+        }
+        UInt32 c = small_classes;
+
+        while ( classSize( c) < size)
+        {
+            c++;
+        }
+        IR_ASSERTD( c < ARENA_SIZE_CLASSES);
+        return c;
+    }
+
+    /** Get size of the blocks of the given class */
+    size_t Arena::classSize( UInt32 c)
+    {
+        const UInt32 small_classes = ARENA_SMALL_MAX / ARENA_SMALL_STEP;
+
+        if ( c < small_classes)
+        {
+            return ( c + 1) * ARENA_SMALL_STEP;
+        }
+        return (size_t)ARENA_SMALL_MAX << ( c - small_classes + 1);
+    }
+
+    /** Get block for an array of the given size */
+    void *Arena::allocateArray( size_t size)
+    {
+        IR_ASSERTD( size >= sizeof( FreeBlock));
+        UInt32 c = sizeClass( size);
+
+        if ( isNotNullP( free_blocks[ c]) )
+        {
+            FreeBlock *block = free_blocks[ c];
+
+            free_blocks[ c] = block->next;
+            return block;
+        }
+        return allocate( classSize( c));
+    }
+
+    /** Return the array block of the given size to the arena for reuse */
+    void Arena::deallocateArray( void *ptr, size_t size)
+    {
+        FreeBlock *block = static_cast< FreeBlock *>( ptr);
+        UInt32 c = sizeClass( size);
+
+        block->next = free_blocks[ c];
+        free_blocks[ c] = block;
+    }
+
+    /** Get number of allocated chunks */
+    UInt32 Arena::numChunks() const
+    {
+        return chunk_num;
+    }
+
+    /** Get number of bytes allocated by the arena */
+    UInt64 Arena::bytes() const
+    {
+        return bytes_;
+    }
+}
@@ -0,0 +1,1136 @@
+/**
+ * @file: ir/bitcode.hpp
+ * Binary form of the module's IR with lazy loading of functions
+ * @ingroup IR
+ */
+ /*
+  * Copyright 2012 MIPT-COMPILER team
+  */
+
+#pragma once
+
+namespace IR
+{
+    /** Version of the binary IR, the bitcode of other versions is not read */
+    const UInt32 BITCODE_VERSION = 1;
+
+    /** Size of the bitcode header: magic, version and the offset of the index */
+    const UInt32 BITCODE_HEADER_SIZE = 16;
+
+    /** Magic characters the bitcode starts with */
+    const char BITCODE_MAGIC[] = "IRBC";
+
+    /** Kind of operand in the bitcode, immediates are split by the type of the constant */
+    enum BitcodeOperandKind
+    {
+        BITCODE_OP_UNSET,
+        BITCODE_OP_OBJ,
+        BITCODE_OP_INT,
+        BITCODE_OP_FLOAT,
+        BITCODE_OP_SYMBOL,
+        BITCODE_OP_TARGET,
+        BITCODE_OP_KINDS_NUM
+    };
+
+    /** Kind of CF node in the bitcode */
+    enum BitcodeNodeKind
+    {
+        BITCODE_NODE_REGULAR,
+        BITCODE_NODE_START,
+        BITCODE_NODE_STOP,
+        BITCODE_NODE_KINDS_NUM
+    };
+
+    /**
+     * @class BitcodeWriter
+     * @brief Writer of the module's IR in the binary form
+     *
+     * The bitcode is the header, the functions one after another and the index at the end.
+     * The header has the magic characters, the version and the offset of the index as 32 and 64 bit
+     * little endian numbers. The index has the strings of the module's symbol table and the name,
+     * offset and size of every function, so a function is read without looking at the others.
+     * A function is its objects' numbers and virtual flags, arguments, operations with their operands
+     * in the order of ids, CF nodes and edges if the CFG is valid and the sequence of operations.
+     * Numbers are written in LEB128, signed ones zigzag encoded, ids of operations as the gaps
+     * between them, floating point constants as their 8 bytes. Ids are kept, so the function
+     * read back prints the same text. Like the text only the operations in the sequence are written
+     * @ingroup IR
+     */
+    template <class MDesType> class BitcodeWriter
+    {
+    public:
+        typedef typename MDesType::OperationType OperationType;
+
+        /** Create writer of the given module */
+        BitcodeWriter( Module< MDesType> *m);
+
+        /** Write the module's functions to the stream */
+        void write( ostream &os);
+
+        /** Get the bytes of the last written bitcode */
+        inline const string &bytes() const;
+    private:
+        /** Order of the IR entities by their ids */
+        template < class T> class IdLess
+        {
+        public:
+            bool operator () ( const T *a, const T *b) const
+            {
+                return a->id() < b->id();
+            }
+        };
+
+        void writeFunction( Function< MDesType> *f);          /**< Write the function's body */
+        void writeOperands( const OperationType *oper);       /**< Write results and arguments of the operation */
+        void writeOperand( const Operand< MDesType> &op);     /**< Write the operand with its kind */
+
+        inline void putByte( UInt8 val);                /**< Append byte */
+        inline void putUInt( UInt64 val);               /**< Append unsigned number in LEB128 */
+        inline void putInt( Int64 val);                 /**< Append signed number zigzag encoded */
+        inline void putFixed( UInt64 val, UInt32 size); /**< Append little endian number of the given size */
+
+        Module< MDesType> *module;
+        string bytes_;                        /**< The bitcode being written */
+        vector< OperationType *> opers;       /**< Operations of the function in the order of the sequence */
+        vector< OperationType *> opers_by_id; /**< Operations of the function in the order of their ids */
+        vector< CFNode< MDesType> *> nodes;
+        vector< CFEdge< MDesType> *> edges;
+    };
+
+    /**
+     * @class BitcodeReader
+     * @brief Reader of the binary IR that loads functions on the first access
+     *
+     * Opening the bitcode reads only the header and the index, the symbols of the index are
+     * added to the module's symbol table. A function is created in the module when it is accessed
+     * for the first time, the later accesses find it in the module. The bytes of the bitcode are not
+     * copied and must live as long as the reader, the files are mapped into memory by the reader itself.
+     * Errors in the bitcode throw ReadError with line 0, the function being loaded is removed then
+     * @ingroup IR
+     */
+    template <class MDesType> class BitcodeReader
+    {
+    public:
+        typedef typename MDesType::OperationType OperationType;
+        typedef typename MDesType::OperName OperName;
+        typedef typename MDesType::ObjectName ObjectName;
+        typedef typename MDesType::OpDes OpDes;
+
+        /** Create reader that loads the functions into the given module */
+        BitcodeReader( Module< MDesType> *m);
+        /** Unmap the file of the bitcode, the loaded functions stay in the module */
+        ~BitcodeReader();
+
+        /** Read the header and the index of the bitcode, the bytes are used until the reader is destroyed */
+        void open( const char *data, size_t size);
+        /** Map the file and read its header and index, the file stays mapped until the reader is destroyed */
+        void openFile( const char *path);
+
+        inline UInt32 numFunctions() const;           /**< Get number of functions in the bitcode */
+        inline Symbol functionName( UInt32 i) const;  /**< Get name of the function in the module's symbol table */
+        inline bool isLoaded( UInt32 i) const;        /**< Check that the function is loaded into the module */
+
+        /** Get the function by its number in the index loading it on the first access */
+        Function< MDesType> *function( UInt32 i);
+        /** Get the function by its name loading it on the first access, NULL if the bitcode has no such function */
+        Function< MDesType> *function( const string &name);
+
+        /** Load all the functions that are not loaded yet, returns their number */
+        UInt32 loadAll();
+    private:
+        /** Entry of the function index */
+        struct FuncEntry
+        {
+            Symbol name;
+            UInt64 offset;
+            UInt64 size;
+            bool is_loaded;
+        };
+
+        /** Target argument that is set after all the operations are created */
+        struct TargetFixup
+        {
+            OperationType *oper;
+            UInt32 arg;
+            UInt32 target_id;
+        };
+
+        void load( FuncEntry &entry); /**< Create the function from its bytes */
+        void loadObjects();           /**< Create objects and arguments of the function */
+        void loadOpers();             /**< Create operations with their operands in the order of their ids */
+        void loadCFG();               /**< Create CF nodes and edges in the order of their ids */
+        void loadSeq();               /**< Link the operations into the sequence and the CF nodes */
+
+        /** Read the operand and set it to the operation */
+        void loadOperand( OperationType *oper, OpDir dir, UInt32 i);
+        /** Read the set and add its operands to the operation */
+        void loadSet( OperationType *oper, OpDir dir);
+        /** Read object reference */
+        Object< MDesType> *getObject();
+        /** Read constant of the given kind */
+        Const getConst( UInt8 kind);
+
+        inline UInt8 getByte();                 /**< Read byte */
+        inline UInt64 getUInt();                /**< Read unsigned number in LEB128 */
+        inline Int64 getInt();                  /**< Read zigzag encoded signed number */
+        inline UInt64 getFixed( UInt32 size);   /**< Read little endian number of the given size */
+        inline UInt32 getId( UInt64 bound);     /**< Read number that must be less than the bound */
+        void error( const char *what) const;    /**< Throw ReadError */
+
+        Module< MDesType> *module;
+        Function< MDesType> *func;
+        MappedFile *file;
+        const char *data;
+        size_t size;
+        const char *pos;                         /**< Current byte */
+        const char *end;                         /**< End of the bytes being read */
+
+        vector< Symbol> symbols;                 /**< Symbols of the module by their ids in the bitcode */
+        vector< FuncEntry> funcs;                /**< Function index */
+        vector< UInt32> funcs_by_sym;            /**< Numbers of functions by the ids of their name symbols */
+
+        vector< OperationType *> opers_by_id;
+        vector< CFNode< MDesType> *> nodes_by_id;
+        vector< TargetFixup> fixups;
+        bool is_cfg;
+    };
+
+    /** Create writer of the given module */
+    template <class MDesType>
+    BitcodeWriter< MDesType>::BitcodeWriter( Module< MDesType> *m): module( m)
+    {
+    }
+
+    /** Get the bytes of the last written bitcode */
+    template <class MDesType>
+    const string &
+    BitcodeWriter< MDesType>::bytes() const
+    {
+        return bytes_;
+    }
+
+    /** Append byte */
+    template <class MDesType>
+    void
+    BitcodeWriter< MDesType>::putByte( UInt8 val)
+    {
+        bytes_.push_back( (char)val);
+    }
+
+    /** Append unsigned number in LEB128, seven bits per byte with the high bit set in all but the last */
+    template <class MDesType>
+    void
+    BitcodeWriter< MDesType>::putUInt( UInt64 val)
+    {
+        while ( val >= 0x80)
+        {
+            putByte( (UInt8)( val | 0x80));
+            val >>= 7;
+        }
+        putByte( (UInt8)val);
+    }
+
+    /** Append signed number zigzag encoded so the small negative numbers take few bytes */
+    template <class MDesType>
+    void
+    BitcodeWriter< MDesType>::putInt( Int64 val)
+    {
+        putUInt( ( (UInt64)val << 1) ^ (UInt64)( val >> 63));
+    }
+
+    /** Append little endian number of the given size */
+    template <class MDesType>
+    void
+    BitcodeWriter< MDesType>::putFixed( UInt64 val, UInt32 size)
+    {
+        for ( UInt32 i = 0; i < size; i++)
+        {
+            putByte( (UInt8)( val >> ( 8 * i)));
+        }
+    }
+
+    /** Write the module's functions to the stream */
+    template <class MDesType>
+    void
+    BitcodeWriter< MDesType>::write( ostream &os)
+    {
+        const SymbolTable &symtab = module->symbols();
+        vector< Function< MDesType> *> funcs;
+        vector< UInt64> offsets;
+
+        /* Offset of the index is set in the header when the functions are written */
+        bytes_.assign( BITCODE_MAGIC, 4);
+        putFixed( BITCODE_VERSION, 4);
+        putFixed( 0, 8);
+        for ( Function< MDesType> *f = module->firstFunction(); isNotNullP( f); f = f->next())
+        {
+            funcs.push_back( f);
+            offsets.push_back( bytes_.size());
+            writeFunction( f);
+        }
+        offsets.push_back( bytes_.size());
+
+        /* The index follows the functions so they are written in one pass */
+        UInt64 index_offset = bytes_.size();
+
+        putUInt( symtab.numSymbols());
+        for ( UInt32 i = 0; i < symtab.numSymbols(); i++)
+        {
+            const string &str = symtab.str( Symbol( i));
+
+            putUInt( str.size());
+            bytes_.append( str);
+        }
+        putUInt( funcs.size());
+        for ( UInt32 i = 0; i < funcs.size(); i++)
+        {
+            putUInt( funcs[ i]->nameSym().id());
+            putUInt( offsets[ i]);
+            putUInt( offsets[ i + 1] - offsets[ i]);
+        }
+
+        for ( UInt32 i = 0; i < 8; i++)
+        {
+            bytes_[ 8 + i] = (char)( index_offset >> ( 8 * i));
+        }
+        os.write( bytes_.data(), (std::streamsize)bytes_.size());
+    }
+
+    /** Write the function's body */
+    template <class MDesType>
+    void
+    BitcodeWriter< MDesType>::writeFunction( Function< MDesType> *f)
+    {
+        CFG< MDesType> &cfg = f->cfg();
+        bool is_cfg = cfg.isValid();
+
+        putByte( is_cfg ? 1 : 0);
+
+        /* Objects: the number of every type and the virtual flags as bits */
+        for ( UInt32 t = 0; t < MDesType::num_objs; t++)
+        {
+            UInt32 num = f->numObjects( (typename MDesType::ObjectName)t);
+
+            putUInt( num);
+            for ( UInt32 i = 0; i < num; i += 8)
+            {
+                UInt8 bits = 0;
+
+                for ( UInt32 j = 0; j < 8 && i + j < num; j++)
+                {
+                    if ( f->object( (typename MDesType::ObjectName)t, i + j)->isVirtual() )
+                    {
+                        bits |= (UInt8)( 1 << j);
+                    }
+                }
+                putByte( bits);
+            }
+        }
+        putUInt( f->numArgs());
+        for ( UInt16 i = 0; i < f->numArgs(); i++)
+        {
+            IR_ASSERTXD( isNotNullP( f->arg( i)), "Function arguments must be set");
+            putUInt( f->arg( i)->type());
+            putUInt( f->arg( i)->id());
+        }
+
+        /* Operations in the order of ids, so they are created with the same ids */
+        bool ids_ascending = true;
+
+        opers.clear();
+        for ( Operation< MDesType> *oper = f->firstOper(); isNotNullP( oper); oper = oper->nextOper())
+        {
+            if ( !opers.empty() && oper->id() < opers.back()->id() )
+            {
+                ids_ascending = false;
+            }
+            opers.push_back( static_cast< OperationType *>( oper));
+        }
+        opers_by_id = opers;
+        if ( !ids_ascending)
+        {
+            sort( opers_by_id.begin(), opers_by_id.end(), IdLess< OperationType>());
+        }
+
+        UInt64 next_id = 0;
+
+        putUInt( opers_by_id.size());
+        for ( UInt32 i = 0; i < opers_by_id.size(); i++)
+        {
+            OperationType *oper = opers_by_id[ i];
+
+            putUInt( oper->id() - next_id);
+            putUInt( oper->name());
+            writeOperands( oper);
+            next_id = oper->id() + 1;
+        }
+
+        /* CF nodes and edges in the order of ids */
+        if ( is_cfg)
+        {
+            nodes.clear();
+            edges.clear();
+            for ( CFNode< MDesType> *node = cfg.firstNode(); isNotNullP( node); node = node->nextNode())
+            {
+                nodes.push_back( node);
+            }
+            for ( CFEdge< MDesType> *edge = cfg.firstEdge(); isNotNullP( edge); edge = edge->nextEdge())
+            {
+                edges.push_back( edge);
+            }
+            sort( nodes.begin(), nodes.end(), IdLess< CFNode< MDesType> >());
+            sort( edges.begin(), edges.end(), IdLess< CFEdge< MDesType> >());
+            putUInt( nodes.size());
+            for ( UInt32 i = 0; i < nodes.size(); i++)
+            {
+                putUInt( nodes[ i]->id());
+                putByte( nodes[ i]->isStart() ? BITCODE_NODE_START
+                         : nodes[ i]->isStop() ? BITCODE_NODE_STOP : BITCODE_NODE_REGULAR);
+            }
+            putUInt( edges.size());
+            for ( UInt32 i = 0; i < edges.size(); i++)
+            {
+                Operation< MDesType> *src = edges[ i]->srcOper();
+
+                putUInt( edges[ i]->id());
+                putUInt( edges[ i]->pred()->id());
+                putUInt( edges[ i]->succ()->id());
+                putUInt( isNotNullP( src) ? src->id() + 1 : 0);
+            }
+        }
+
+        /* Sequence of the operations with their CF nodes */
+        for ( UInt32 i = 0; i < opers.size(); i++)
+        {
+            putUInt( opers[ i]->id());
+            if ( is_cfg)
+            {
+                putUInt( isNotNullP( opers[ i]->node()) ? opers[ i]->node()->id() + 1 : 0);
+            }
+        }
+    }
+
+    /** Write results and arguments of the operation, sets are written from the first added operand */
+    template <class MDesType>
+    void
+    BitcodeWriter< MDesType>::writeOperands( const OperationType *oper)
+    {
+        const typename MDesType::OperDes *des = oper->archDes();
+
+        for ( UInt32 i = 0; i < oper->numRess(); i++)
+        {
+            if ( des->resDes( i)->canBeSet() )
+            {
+                putUInt( oper->numRessInSet());
+                for ( UInt32 j = oper->numRessInSet(); j-- > 0;)
+                {
+                    writeOperand( oper->resInSet( j));
+                }
+            } else
+            {
+                writeOperand( oper->res( i));
+            }
+        }
+        for ( UInt32 i = 0; i < oper->numArgs(); i++)
+        {
+            if ( des->argDes( i)->canBeSet() )
+            {
+                putUInt( oper->numArgsInSet());
+                for ( UInt32 j = oper->numArgsInSet(); j-- > 0;)
+                {
+                    writeOperand( oper->argInSet( j));
+                }
+            } else
+            {
+                writeOperand( oper->arg( i));
+            }
+        }
+    }
+
+    /** Write the operand with its kind */
+    template <class MDesType>
+    void
+    BitcodeWriter< MDesType>::writeOperand( const Operand< MDesType> &op)
+    {
+        switch ( op.type())
+        {
+            case OP_TYPE_OBJ:
+                putByte( BITCODE_OP_OBJ);
+                putUInt( op.object()->type());
+                putUInt( op.object()->id());
+                break;
+            case OP_TYPE_IMM:
+            {
+                Const imm = op.constValue();
+
+                if ( imm.type() == CONST_TYPE_INTEGER)
+                {
+                    putByte( BITCODE_OP_INT);
+                    putInt( imm.intVal());
+                } else if ( imm.type() == CONST_TYPE_FLOAT)
+                {
+                    Double d_val = imm.floatVal();
+                    UInt64 bits;
+
+                    memcpy( &bits, &d_val, sizeof( bits));
+                    putByte( BITCODE_OP_FLOAT);
+                    putFixed( bits, sizeof( bits));
+                } else
+                {
+                    putByte( BITCODE_OP_SYMBOL);
+                    putUInt( imm.symVal().id());
+                }
+                break;
+            }
+            case OP_TYPE_TARGET:
+                putByte( BITCODE_OP_TARGET);
+                putUInt( op.target()->id());
+                break;
+            default:
+                putByte( BITCODE_OP_UNSET);
+                break;
+        }
+    }
+
+    /** Create reader that loads the functions into the given module */
+    template <class MDesType>
+    BitcodeReader< MDesType>::BitcodeReader( Module< MDesType> *m):
+        module( m), func( NULL), file( NULL), data( NULL), size( 0), pos( NULL), end( NULL), is_cfg( false)
+    {
+    }
+
+    /** Unmap the file of the bitcode, the loaded functions stay in the module */
+    template <class MDesType>
+    BitcodeReader< MDesType>::~BitcodeReader()
+    {
+        delete file;
+    }
+
+    /** Throw ReadError */
+    template <class MDesType>
+    void
+    BitcodeReader< MDesType>::error( const char *what) const
+    {
+        throw ReadError( string( "Bitcode: ") + what, 0);
+    }
+
+    /** Read byte */
+    template <class MDesType>
+    UInt8
+    BitcodeReader< MDesType>::getByte()
+    {
+        if ( pos == end)
+        {
+            error( "unexpected end of data");
+        }
+        return (UInt8)*pos++;
+    }
+
+    /** Read unsigned number in LEB128 */
+    template <class MDesType>
+    UInt64
+    BitcodeReader< MDesType>::getUInt()
+    {
+        UInt64 val = 0;
+
+        for ( UInt32 shift = 0; shift < 64; shift += 7)
+        {
+            UInt8 byte = getByte();
+
+            val |= (UInt64)( byte & 0x7f) << shift;
+            if ( ( byte & 0x80) == 0)
+                return val;
+        }
+        error( "number is too large");
+        return 0;
+    }
+
+    /** Read zigzag encoded signed number */
+    template <class MDesType>
+    Int64
+    BitcodeReader< MDesType>::getInt()
+    {
+        UInt64 val = getUInt();
+
+        return (Int64)( val >> 1) ^ -(Int64)( val & 1);
+    }
+
+    /** Read little endian number of the given size */
+    template <class MDesType>
+    UInt64
+    BitcodeReader< MDesType>::getFixed( UInt32 size)
+    {
+        UInt64 val = 0;
+
+        for ( UInt32 i = 0; i < size; i++)
+        {
+            val |= (UInt64)getByte() << ( 8 * i);
+        }
+        return val;
+    }
+
+    /** Read number that must be less than the bound */
+    template <class MDesType>
+    UInt32
+    BitcodeReader< MDesType>::getId( UInt64 bound)
+    {
+        UInt64 val = getUInt();
+
+        if ( val >= bound)
+        {
+            error( "number is out of range");
+        }
+        return (UInt32)val;
+    }
+
+    /** Read the header and the index of the bitcode, the bytes are used until the reader is destroyed */
+    template <class MDesType>
+    void
+    BitcodeReader< MDesType>::open( const char *bytes, size_t bytes_size)
+    {
+        data = bytes;
+        size = bytes_size;
+        symbols.clear();
+        funcs.clear();
+        funcs_by_sym.clear();
+
+        pos = data;
+        end = data + size;
+        if ( size < BITCODE_HEADER_SIZE || memcmp( data, BITCODE_MAGIC, 4) != 0)
+        {
+            error( "not a bitcode");
+        }
+        pos += 4;
+        if ( getFixed( 4) != BITCODE_VERSION)
+        {
+            error( "unsupported version");
+        }
+        UInt64 index_offset = getFixed( 8);
+
+        if ( index_offset < BITCODE_HEADER_SIZE || index_offset > size)
+        {
+            error( "index is out of data");
+        }
+
+        /* Symbols of the index are added to the module's table, bitcode ids are mapped to the module's */
+        SymbolTable &symtab = module->symbols();
+
+        pos = data + index_offset;
+        symbols.resize( getId( end - pos + 1));
+        for ( UInt32 i = 0; i < symbols.size(); i++)
+        {
+            UInt32 len = getId( end - pos + 1);
+
+            symbols[ i] = symtab.intern( pos, len);
+            pos += len;
+        }
+        funcs.resize( getId( end - pos + 1));
+        for ( UInt32 i = 0; i < funcs.size(); i++)
+        {
+            FuncEntry &entry = funcs[ i];
+
+            entry.name = symbols[ getId( symbols.size())];
+            entry.offset = getUInt();
+            entry.size = getUInt();
+            entry.is_loaded = false;
+            if ( entry.offset < BITCODE_HEADER_SIZE || entry.offset > index_offset
+                 || entry.size > index_offset - entry.offset )
+            {
+                error( "function is out of data");
+            }
+            if ( funcs_by_sym.size() <= entry.name.id() )
+            {
+                funcs_by_sym.resize( entry.name.id() + 1, READER_NO_ID);
+            }
+            if ( funcs_by_sym[ entry.name.id()] != READER_NO_ID)
+            {
+                error( "function is in the index twice");
+            }
+            funcs_by_sym[ entry.name.id()] = i;
+        }
+    }
+
+    /** Map the file and read its header and index, the file stays mapped until the reader is destroyed */
+    template <class MDesType>
+    void
+    BitcodeReader< MDesType>::openFile( const char *path)
+    {
+        MappedFile *new_file = new MappedFile( path);
+
+        delete file;
+        file = new_file;
+        open( file->data(), file->size());
+    }
+
+    /** Get number of functions in the bitcode */
+    template <class MDesType>
+    UInt32
+    BitcodeReader< MDesType>::numFunctions() const
+    {
+        return (UInt32)funcs.size();
+    }
+
+    /** Get name of the function in the module's symbol table */
+    template <class MDesType>
+    Symbol
+    BitcodeReader< MDesType>::functionName( UInt32 i) const
+    {
+        IR_ASSERTD( i < funcs.size());
+        return funcs[ i].name;
+    }
+
+    /** Check that the function is loaded into the module */
+    template <class MDesType>
+    bool
+    BitcodeReader< MDesType>::isLoaded( UInt32 i) const
+    {
+        IR_ASSERTD( i < funcs.size());
+        return funcs[ i].is_loaded;
+    }
+
+    /** Get the function by its number in the index loading it on the first access */
+    template <class MDesType>
+    Function< MDesType> *
+    BitcodeReader< MDesType>::function( UInt32 i)
+    {
+        IR_ASSERTD( i < funcs.size());
+        if ( !funcs[ i].is_loaded)
+        {
+            load( funcs[ i]);
+        }
+        return module->findFunction( funcs[ i].name);
+    }
+
+    /** Get the function by its name loading it on the first access, NULL if the bitcode has no such function */
+    template <class MDesType>
+    Function< MDesType> *
+    BitcodeReader< MDesType>::function( const string &name)
+    {
+        Symbol sym = module->symbols().find( name);
+
+        if ( !sym.isValid() || sym.id() >= funcs_by_sym.size() || funcs_by_sym[ sym.id()] == READER_NO_ID)
+        {
+            return NULL;
+        }
+        return function( funcs_by_sym[ sym.id()]);
+    }
+
+    /** Load all the functions that are not loaded yet, returns their number */
+    template <class MDesType>
+    UInt32
+    BitcodeReader< MDesType>::loadAll()
+    {
+        UInt32 num = 0;
+
+        for ( UInt32 i = 0; i < funcs.size(); i++)
+        {
+            if ( !funcs[ i].is_loaded)
+            {
+                load( funcs[ i]);
+                num++;
+            }
+        }
+        return num;
+    }
+
+    /** Create the function from its bytes */
+    template <class MDesType>
+    void
+    BitcodeReader< MDesType>::load( FuncEntry &entry)
+    {
+        if ( isNotNullP( module->findFunction( entry.name)) )
+        {
+            error( "function is already in the module");
+        }
+        func = module->newFunction( module->symbols().str( entry.name));
+        pos = data + entry.offset;
+        end = pos + entry.size;
+        try
+        {
+            UInt8 flags = getByte();
+
+            if ( flags > 1)
+            {
+                error( "unknown function flags");
+            }
+            is_cfg = ( flags != 0);
+            loadObjects();
+            loadOpers();
+            if ( is_cfg)
+            {
+                loadCFG();
+            }
+            loadSeq();
+            if ( pos != end)
+            {
+                error( "unexpected data after the function");
+            }
+        } catch ( ReadError &)
+        {
+            module->removeFunction( func);
+            func = NULL;
+            throw;
+        }
+        func->cfg().setValid( is_cfg);
+        func = NULL;
+        entry.is_loaded = true;
+    }
+
+    /** Create objects and arguments of the function */
+    template <class MDesType>
+    void
+    BitcodeReader< MDesType>::loadObjects()
+    {
+        for ( UInt32 t = 0; t < MDesType::num_objs; t++)
+        {
+            /* Eight objects take at least a byte of flags */
+            UInt32 num = getId( ( end - pos) * (UInt64)8 + 1);
+
+            for ( UInt32 i = 0; i < num; i++)
+            {
+                func->newObject( (ObjectName)t);
+            }
+            for ( UInt32 i = 0; i < num; i += 8)
+            {
+                UInt8 bits = getByte();
+
+                for ( UInt32 j = 0; j < 8 && i + j < num; j++)
+                {
+                    func->object( (ObjectName)t, i + j)->setVirtual( ( bits & ( 1 << j)) != 0);
+                }
+            }
+        }
+        UInt32 num_args = getId( (UInt64)1 << 16);
+
+        for ( UInt32 i = 0; i < num_args; i++)
+        {
+            func->setArg( (UInt16)i, getObject());
+        }
+    }
+
+    /** Read object reference */
+    template <class MDesType>
+    Object< MDesType> *
+    BitcodeReader< MDesType>::getObject()
+    {
+        ObjectName type = (ObjectName)getId( MDesType::num_objs);
+
+        return func->object( type, getId( func->numObjects( type)));
+    }
+
+    /** Create operations with their operands in the order of their ids */
+    template <class MDesType>
+    void
+    BitcodeReader< MDesType>::loadOpers()
+    {
+        /* Every operation takes at least two bytes */
+        UInt32 num = getId( ( end - pos) / 2 + 1);
+        UInt64 next_id = 0;
+
+        opers_by_id.clear();
+        fixups.clear();
+        for ( UInt32 i = 0; i < num; i++)
+        {
+            UInt64 id = next_id + getUInt();
+            OperName name = (OperName)getId( MDesType::num_opers);
+
+            if ( id >= READER_NO_ID)
+            {
+                error( "operation id is too large");
+            }
+            OperationType *oper = func->newOper( name);
+
+            /* Operations that are not in the bitcode are created and deleted to skip their ids */
+            while ( oper->id() < id)
+            {
+                func->deleteOper( oper);
+                oper = func->newOper( name);
+            }
+            opers_by_id.resize( (size_t)id + 1, NULL);
+            opers_by_id[ (size_t)id] = oper;
+            next_id = id + 1;
+
+            const typename MDesType::OperDes *des = oper->archDes();
+
+            for ( UInt32 j = 0; j < oper->numRess(); j++)
+            {
+                if ( des->resDes( j)->canBeSet() )
+                {
+                    loadSet( oper, OPERAND_DIR_RES);
+                } else
+                {
+                    loadOperand( oper, OPERAND_DIR_RES, j);
+                }
+            }
+            for ( UInt32 j = 0; j < oper->numArgs(); j++)
+            {
+                if ( des->argDes( j)->canBeSet() )
+                {
+                    loadSet( oper, OPERAND_DIR_ARG);
+                } else
+                {
+                    loadOperand( oper, OPERAND_DIR_ARG, j);
+                }
+            }
+        }
+        for ( UInt32 i = 0; i < fixups.size(); i++)
+        {
+            const TargetFixup &fixup = fixups[ i];
+
+            if ( fixup.target_id >= opers_by_id.size() || isNullP( opers_by_id[ fixup.target_id]) )
+            {
+                error( "target operation is not in the function");
+            }
+            fixup.oper->setArgTarget( fixup.arg, opers_by_id[ fixup.target_id]);
+        }
+    }
+
+    /** Read constant of the given kind */
+    template <class MDesType>
+    Const
+    BitcodeReader< MDesType>::getConst( UInt8 kind)
+    {
+        if ( kind == BITCODE_OP_INT)
+        {
+            return Const( getInt());
+        } else if ( kind == BITCODE_OP_FLOAT)
+        {
+            UInt64 bits = getFixed( sizeof( bits));
+            Double d_val;
+
+            memcpy( &d_val, &bits, sizeof( d_val));
+            return Const( d_val);
+        }
+        return Const( symbols[ getId( symbols.size())]);
+    }
+
+    /** Read the operand and set it to the operation */
+    template <class MDesType>
+    void
+    BitcodeReader< MDesType>::loadOperand( OperationType *oper, OpDir dir, UInt32 i)
+    {
+        const typename MDesType::OperDes *des = oper->archDes();
+        const OpDes *op_des = ( dir == OPERAND_DIR_ARG) ? des->argDes( i) : des->resDes( i);
+        UInt8 kind = getByte();
+
+        switch ( kind)
+        {
+            case BITCODE_OP_UNSET:
+                break;
+            case BITCODE_OP_OBJ:
+            {
+                Object< MDesType> *obj = getObject();
+
+                if ( !op_des->isProperName( obj->type()) )
+                {
+                    error( "object of this type can't be the operand");
+                }
+                if ( dir == OPERAND_DIR_ARG)
+                {
+                    oper->setArgObj( i, obj);
+                } else
+                {
+                    oper->setResObj( i, obj);
+                }
+                break;
+            }
+            case BITCODE_OP_INT:
+            case BITCODE_OP_FLOAT:
+            case BITCODE_OP_SYMBOL:
+                if ( dir != OPERAND_DIR_ARG || !op_des->canBeImm() )
+                {
+                    error( "operand can't be immediate");
+                }
+                oper->setArgImm( i, getConst( kind));
+                break;
+            case BITCODE_OP_TARGET:
+            {
+                UInt32 id = getId( READER_NO_ID);
+
+                if ( dir != OPERAND_DIR_ARG || !op_des->canBeTarget() )
+                {
+                    error( "operand can't be target");
+                }
+                /* Targets that are not created yet are set after all the operations */
+                if ( id < opers_by_id.size() && isNotNullP( opers_by_id[ id]) )
+                {
+                    oper->setArgTarget( i, opers_by_id[ id]);
+                } else
+                {
+                    TargetFixup fixup = { oper, i, id };
+
+                    fixups.push_back( fixup);
+                }
+                break;
+            }
+            default:
+                error( "unknown operand kind");
+        }
+    }
+
+    /** Read the set and add its operands to the operation */
+    template <class MDesType>
+    void
+    BitcodeReader< MDesType>::loadSet( OperationType *oper, OpDir dir)
+    {
+        /* Every operand takes at least two bytes */
+        UInt32 num = getId( ( end - pos) / 2 + 1);
+
+        for ( UInt32 i = 0; i < num; i++)
+        {
+            UInt8 kind = getByte();
+
+            if ( kind == BITCODE_OP_OBJ)
+            {
+                if ( dir == OPERAND_DIR_ARG)
+                {
+                    oper->addArgToSet( getObject());
+                } else
+                {
+                    oper->addResToSet( getObject());
+                }
+            } else if ( dir == OPERAND_DIR_ARG
+                        && ( kind == BITCODE_OP_INT || kind == BITCODE_OP_FLOAT || kind == BITCODE_OP_SYMBOL) )
+            {
+                oper->addArgToSet( getConst( kind));
+            } else
+            {
+                error( "operand can't be in the set");
+            }
+        }
+    }
+
+    /** Create CF nodes and edges in the order of their ids */
+    template <class MDesType>
+    void
+    BitcodeReader< MDesType>::loadCFG()
+    {
+        CFG< MDesType> &cfg = func->cfg();
+        UInt32 num_nodes = getId( ( end - pos) / 2 + 1);
+
+        nodes_by_id.clear();
+        for ( UInt32 i = 0; i < num_nodes; i++)
+        {
+            UInt32 id = getId( READER_NO_ID);
+            UInt8 kind = getByte();
+            CFNode< MDesType> *node = NULL;
+
+            if ( kind == BITCODE_NODE_START)
+            {
+                node = cfg.startNode();
+            } else if ( kind == BITCODE_NODE_STOP)
+            {
+                node = cfg.stopNode();
+            } else if ( kind == BITCODE_NODE_REGULAR)
+            {
+                node = cfg.newNode();
+                while ( node->id() < id)
+                {
+                    cfg.deleteNode( node);
+                    node = cfg.newNode();
+                }
+            } else
+            {
+                error( "unknown CF node kind");
+            }
+            if ( node->id() != id || ( id < nodes_by_id.size() && isNotNullP( nodes_by_id[ id])) )
+            {
+                error( "CF node id doesn't match the order of the nodes");
+            }
+            nodes_by_id.resize( max< size_t>( nodes_by_id.size(), id + 1), NULL);
+            nodes_by_id[ id] = node;
+        }
+
+        UInt32 num_edges = getId( ( end - pos) / 4 + 1);
+
+        for ( UInt32 i = 0; i < num_edges; i++)
+        {
+            UInt32 id = getId( READER_NO_ID);
+            UInt32 pred_id = getId( nodes_by_id.size());
+            UInt32 succ_id = getId( nodes_by_id.size());
+            UInt32 src = getId( opers_by_id.size() + 1);
+            CFNode< MDesType> *pred = nodes_by_id[ pred_id];
+            CFNode< MDesType> *succ = nodes_by_id[ succ_id];
+
+            if ( isNullP( pred) || isNullP( succ) )
+            {
+                error( "CF edge connects unknown node");
+            }
+            CFEdge< MDesType> *edge = cfg.newEdge( pred, succ);
+
+            while ( edge->id() < id)
+            {
+                cfg.deleteEdge( edge);
+                edge = cfg.newEdge( pred, succ);
+            }
+            if ( edge->id() != id)
+            {
+                error( "CF edge id doesn't match the order of the edges");
+            }
+            if ( src != 0)
+            {
+                if ( isNullP( opers_by_id[ src - 1]) )
+                {
+                    error( "unknown source operation of CF edge");
+                }
+                edge->setSrcOper( opers_by_id[ src - 1]);
+            }
+        }
+    }
+
+    /** Link the operations into the sequence and the CF nodes */
+    template <class MDesType>
+    void
+    BitcodeReader< MDesType>::loadSeq()
+    {
+        OperationType *prev = NULL;
+        UInt32 num = 0;
+
+        for ( UInt32 i = 0; i < opers_by_id.size(); i++)
+        {
+            if ( isNotNullP( opers_by_id[ i]) )
+            {
+                num++;
+            }
+        }
+        for ( UInt32 i = 0; i < num; i++)
+        {
+            UInt32 id = getId( opers_by_id.size());
+            OperationType *oper = opers_by_id[ id];
+
+            /* Every operation is in the sequence once */
+            if ( isNullP( oper) || areEqP( oper, prev) || isNotNullP( oper->prevOper())
+                 || areEqP( oper, func->firstOper()) )
+            {
+                error( "operation is in the sequence twice");
+            }
+            if ( isNullP( prev) )
+            {
+                func->setFirstOper( oper);
+            } else
+            {
+                oper->insertAfter( prev);
+            }
+            if ( is_cfg)
+            {
+                UInt32 node = getId( nodes_by_id.size() + 1);
+
+                if ( node != 0)
+                {
+                    CFNode< MDesType> *cf_node = nodes_by_id[ node - 1];
+
+                    if ( isNullP( cf_node) )
+                    {
+                        error( "operation is in unknown CF node");
+                    }
+                    if ( isNotNullP( cf_node->lastOper()) && !areEqP( cf_node->lastOper(), prev) )
+                    {
+                        error( "operations of CF node are not adjacent in the sequence");
+                    }
+                    cf_node->extend( oper);
+                }
+            }
+            prev = oper;
+        }
+    }
+}
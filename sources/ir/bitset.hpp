@@ -0,0 +1,283 @@
+/**
+ * @file: ir/bitset.hpp
+ * Dense set of small numbers packed into machine words
+ * @ingroup IR
+ */
+ /*
+  * Copyright 2012 MIPT-COMPILER team
+  */
+
+#pragma once
+
+#if defined(_MSC_VER)
+#  include <intrin.h>
+#endif
+
+namespace IR
+{
+    /** Number of bits in the word of the bit set */
+    const UInt32 BITSET_WORD_BITS = 64;
+
+    /** Returned by the search of the next bit when there is none */
+    const UInt32 BITSET_NO_BIT = (UInt32)-1;
+
+    /**
+     * @class BitSet
+     * @brief Set of numbers from 0 to size - 1 with a bit per number
+     *
+     * The operations on whole sets go over the words in straight loops without branches inside
+     * so that the compiler vectorizes them. Sets that take part in one operation must be of the same size
+     * @ingroup IR
+     */
+    class BitSet
+    {
+    public:
+        inline BitSet( UInt32 size = 0);
+
+        inline void resize( UInt32 size); /**< Change the size, the new numbers are not in the set */
+        inline UInt32 size() const;       /**< Get number of the numbers the set can hold */
+        inline void clear();              /**< Remove all the numbers */
+
+        inline void set( UInt32 i);        /**< Add the number */
+        inline void reset( UInt32 i);      /**< Remove the number */
+        inline bool test( UInt32 i) const; /**< Check that the number is in the set */
+
+        inline UInt32 count() const;       /**< Get number of the numbers in the set */
+        inline bool isEmpty() const;       /**< Check that the set has no numbers */
+
+        /** Get the least number in the set not less than the given one, BITSET_NO_BIT if there is none */
+        inline UInt32 next( UInt32 from) const;
+
+        /** Add the numbers of the other set, returns true if the set is changed */
+        inline bool unite( const BitSet &s);
+
+        /** Remove the numbers of the other set */
+        inline void subtract( const BitSet &s);
+
+        /** Keep only the numbers that are in the other set too */
+        inline void intersect( const BitSet &s);
+
+        /** Make the set equal to gen | ( in & ~kill), returns true if the set is changed */
+        inline bool assignTransfer( const BitSet &gen, const BitSet &in, const BitSet &kill);
+
+        inline bool operator == ( const BitSet &s) const;
+        inline bool operator != ( const BitSet &s) const;
+    private:
+        /** Get number of words for the given number of bits */
+        static inline UInt32 numWords( UInt32 size);
+
+        /** Get number of the lowest set bit of nonzero word */
+        static inline UInt32 lowestBit( UInt64 word);
+
+        UInt32 size_;
+        vector< UInt64> words;
+    };
+
+    BitSet::BitSet( UInt32 size): size_( size), words( numWords( size), 0)
+    {
+    }
+
+    /** Get number of words for the given number of bits */
+    UInt32 BitSet::numWords( UInt32 size)
+    {
+        return ( size + BITSET_WORD_BITS - 1) / BITSET_WORD_BITS;
+    }
+
+    /** Get number of the lowest set bit of nonzero word */
+    UInt32 BitSet::lowestBit( UInt64 word)
+    {
+        IR_ASSERTD( word != 0);
+#if defined(_MSC_VER) && defined(_M_X64)
+        unsigned long index;
+
+        _BitScanForward64( &index, word);
+        return (UInt32)index;
+#elif defined(__GNUC__)
+        return (UInt32)__builtin_ctzll( word);
+#else
+        UInt32 index = 0;
+
+        while ( ( word & 1) == 0)
+        {
+            word >>= 1;
+            index++;
+        }
+        return index;
+#endif
+    }
+
+    /** Change the size, the new numbers are not in the set */
+    void BitSet::resize( UInt32 size)
+    {
+        if ( size < size_ && size % BITSET_WORD_BITS != 0 && numWords( size) > 0)
+        {
+            /* Bits beyond the size are kept zero */
+            words[ numWords( size) - 1] &= ( (UInt64)1 << ( size % BITSET_WORD_BITS)) - 1;
+        }
+        size_ = size;
+        words.resize( numWords( size), 0);
+    }
+
+    /** Get number of the numbers the set can hold */
+    UInt32 BitSet::size() const
+    {
+        return size_;
+    }
+
+    /** Remove all the numbers */
+    void BitSet::clear()
+    {
+        for ( UInt32 i = 0; i < words.size(); i++)
+        {
+            words[ i] = 0;
+        }
+    }
+
+    /** Add the number */
+    void BitSet::set( UInt32 i)
+    {
+        IR_ASSERTD( i < size_);
+        words[ i / BITSET_WORD_BITS] |= (UInt64)1 << ( i % BITSET_WORD_BITS);
+    }
+
+    /** Remove the number */
+    void BitSet::reset( UInt32 i)
+    {
+        IR_ASSERTD( i < size_);
+        words[ i / BITSET_WORD_BITS] &= ~( (UInt64)1 << ( i % BITSET_WORD_BITS));
+    }
+
+    /** Check that the number is in the set */
+    bool BitSet::test( UInt32 i) const
+    {
+        IR_ASSERTD( i < size_);
+        return ( words[ i / BITSET_WORD_BITS] >> ( i % BITSET_WORD_BITS) & 1) != 0;
+    }
+
+    /** Get number of the numbers in the set */
+    UInt32 BitSet::count() const
+    {
+        UInt32 num = 0;
+
+        for ( UInt32 i = 0; i < words.size(); i++)
+        {
+            for ( UInt64 w = words[ i]; w != 0; w &= w - 1)
+            {
+                num++;
+            }
+        }
+        return num;
+    }
+
+    /** Check that the set has no numbers */
+    bool BitSet::isEmpty() const
+    {
+        UInt64 any = 0;
+
+        for ( UInt32 i = 0; i < words.size(); i++)
+        {
+            any |= words[ i];
+        }
+        return any == 0;
+    }
+
+    /** Get the least number in the set not less than the given one, BITSET_NO_BIT if there is none */
+    UInt32 BitSet::next( UInt32 from) const
+    {
+        if ( from >= size_)
+            return BITSET_NO_BIT;
+
+        UInt32 w = from / BITSET_WORD_BITS;
+        UInt64 word = words[ w] & ( ~(UInt64)0 << ( from % BITSET_WORD_BITS));
+
+        while ( word == 0)
+        {
+            if ( ++w == words.size() )
+                return BITSET_NO_BIT;
+            word = words[ w];
+        }
+        return w * BITSET_WORD_BITS + lowestBit( word);
+    }
+
+    /** Add the numbers of the other set, returns true if the set is changed */
+    bool BitSet::unite( const BitSet &s)
+    {
+        IR_ASSERTD( s.size_ == size_);
+
+        UInt64 *dst = words.empty() ? NULL : &words[ 0];
+        const UInt64 *src = s.words.empty() ? NULL : &s.words[ 0];
+        UInt32 n = (UInt32)words.size();
+        UInt64 diff = 0;
+
+        for ( UInt32 i = 0; i < n; i++)
+        {
+            UInt64 w = dst[ i] | src[ i];
+
+            diff |= w ^ dst[ i];
+            dst[ i] = w;
+        }
+        return diff != 0;
+    }
+
+    /** Remove the numbers of the other set */
+    void BitSet::subtract( const BitSet &s)
+    {
+        IR_ASSERTD( s.size_ == size_);
+
+        UInt64 *dst = words.empty() ? NULL : &words[ 0];
+        const UInt64 *src = s.words.empty() ? NULL : &s.words[ 0];
+        UInt32 n = (UInt32)words.size();
+
+        for ( UInt32 i = 0; i < n; i++)
+        {
+            dst[ i] &= ~src[ i];
+        }
+    }
+
+    /** Keep only the numbers that are in the other set too */
+    void BitSet::intersect( const BitSet &s)
+    {
+        IR_ASSERTD( s.size_ == size_);
+
+        UInt64 *dst = words.empty() ? NULL : &words[ 0];
+        const UInt64 *src = s.words.empty() ? NULL : &s.words[ 0];
+        UInt32 n = (UInt32)words.size();
+
+        for ( UInt32 i = 0; i < n; i++)
+        {
+            dst[ i] &= src[ i];
+        }
+    }
+
+    /** Make the set equal to gen | ( in & ~kill), returns true if the set is changed */
+    bool BitSet::assignTransfer( const BitSet &gen, const BitSet &in, const BitSet &kill)
+    {
+        IR_ASSERTD( gen.size_ == size_ && in.size_ == size_ && kill.size_ == size_);
+
+        UInt64 *dst = words.empty() ? NULL : &words[ 0];
+        const UInt64 *g = gen.words.empty() ? NULL : &gen.words[ 0];
+        const UInt64 *a = in.words.empty() ? NULL : &in.words[ 0];
+        const UInt64 *k = kill.words.empty() ? NULL : &kill.words[ 0];
+        UInt32 n = (UInt32)words.size();
+        UInt64 diff = 0;
+
+        for ( UInt32 i = 0; i < n; i++)
+        {
+            UInt64 w = g[ i] | ( a[ i] & ~k[ i]);
+
+            diff |= w ^ dst[ i];
+            dst[ i] = w;
+        }
+        return diff != 0;
+    }
+
+    bool BitSet::operator == ( const BitSet &s) const
+    {
+        return size_ == s.size_ && words == s.words;
+    }
+
+    bool BitSet::operator != ( const BitSet &s) const
+    {
+        return !( *this == s);
+    }
+}
@@ -52,6 +52,9 @@ namespace IR
 
         inline void append( Operation<MDesType> *oper); /**< Insert given operation to the end of the node */
         inline void prepend( Operation<MDesType> *oper);/**< Insert given operation in the begining of the node */
+        inline void insertBefore( Operation<MDesType> *oper, Operation<MDesType> *next_oper); /**< Insert operation before given one of the node */
+        inline void remove( Operation<MDesType> *oper); /**< Remove operation from the node and from the operation sequence */
+        inline void extend( Operation<MDesType> *oper); /**< Add operation that follows the node's operations in the sequence to the node */
 
         /** Print node to stream */
         inline void toStream(ostream& os);
@@ -154,6 +154,59 @@ CFNode<MDesType>::prepend( Operation<MDesType> *oper)
     oper->setNode( this);
 }
 
+// Insert operation before the given operation of the node
+template <class MDesType>
+void 
+CFNode<MDesType>::insertBefore( Operation<MDesType> *oper, Operation<MDesType> *next_oper)
+{
+    IR_ASSERTD( isNotNullP( oper));
+    IR_ASSERTD( areEqP( next_oper->node(), this));
+
+    oper->insertBefore( next_oper);
+    if ( areEqP( first, next_oper) )
+    {
+        first = oper;
+    }
+    oper->setNode( this);
+}
+
+// Remove operation from the node and from the operation sequence
+template <class MDesType>
+void 
+CFNode<MDesType>::remove( Operation<MDesType> *oper)
+{
+    IR_ASSERTD( areEqP( oper->node(), this));
+
+    if ( areEqP( first, oper) && areEqP( last, oper) )
+    {
+        first = NULL;
+        last = NULL;
+    } else if ( areEqP( first, oper) )
+    {
+        first = oper->nextOper();
+    } else if ( areEqP( last, oper) )
+    {
+        last = oper->prevOper();
+    }
+    oper->detachFromSeq();
+    oper->setNode( NULL);
+}
+
+// Add operation that follows the node's operations in the sequence to the end of the node
+template <class MDesType>
+void 
+CFNode<MDesType>::extend( Operation<MDesType> *oper)
+{
+    IR_ASSERTD( isNullP( last) || areEqP( last->nextOper(), oper));
+
+    if ( isNullP( first))
+    {
+        first = oper;
+    }
+    last = oper;
+    oper->setNode( this);
+}
+
 /** Number nodes in topological order. Nodes that are not reachable from start will have arbitrary order */
 template <class MDesType>
 Numeration
@@ -164,8 +217,8 @@ CFG<MDesType>::makeTopologicalNumeration()
      * doing the depth-first search on the CFG and assigning numbers
      * to a node AFTER all successors of the node have been visited.
      */
-    Marker m = MarkerManager::newMarker();
-    Numeration num = NumManager::newNum();
+    Marker m = this->newMarker();
+    Numeration num = this->newNum();
     GraphNum i = this->numNodes() - 1;
     
     /* 
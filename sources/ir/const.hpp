@@ -29,27 +29,26 @@ namespace IR
     public:
         inline Const( Int64 int_val); /**< Constructor of integer constant        */
         inline Const( Double f_val);  /**< Constructor of floating point constant */
-        inline Const( string str);    /**< Constructor of symbolic constant       */
+        inline Const( Symbol sym);    /**< Constructor of symbolic constant       */
         
         inline ConstType type()      const; /**< Get type of constant */
 
         inline Int64     intVal()    const; /**< Get integer constant value        */
         inline Double    floatVal()  const; /**< Get floating point constant value */
-        inline string    strVal()    const; /**< Get integer constant value        */
+        inline Symbol    symVal()    const; /**< Get symbolic constant value       */
 
 
-        /** Print constant to stream */
-        inline void toStream(ostream& os) const;
+        /** Print constant to stream, symbols are printed as strings if the table is given */
+        inline void toStream(ostream& os, const SymbolTable *symtab = NULL) const;
     private:
         /** Pod data representation */
         union ConstData
         {
             Int64 int_val;
             Double d_val;
+            UInt32 sym_id;
         } data;
         
-        std::string str_val;/**< Placeholder for string data */
-        
         ConstType type_; /**< Type of the constant */
     };
  
@@ -66,9 +65,9 @@ namespace IR
     }  
 
     // Constructor of symbolic constant
-    Const::Const( string str): type_( CONST_TYPE_SYMBOL)
+    Const::Const( Symbol sym): type_( CONST_TYPE_SYMBOL)
     {
-        str_val = str;
+        data.sym_id = sym.id();
     }    
 
     // Get type of constant
@@ -91,14 +90,14 @@ namespace IR
         return data.d_val;
     } 
     
-    // Get integer constant value
-    inline string Const::strVal() const
+    // Get symbolic constant value
+    inline Symbol Const::symVal() const
     {
         IR_ASSERTD( type() == CONST_TYPE_SYMBOL);
-        return str_val;
+        return Symbol( data.sym_id);
     } 
     /** Print operand to stream */
-    inline void Const::toStream(ostream& os) const
+    inline void Const::toStream(ostream& os, const SymbolTable *symtab) const
     {
         switch ( type())
         {
@@ -109,7 +108,13 @@ namespace IR
                 os << floatVal();
                 break;
     case CONST_TYPE_SYMBOL:
-                os << strVal();
+                if ( isNotNullP( symtab))
+                {
+                    os << symtab->str( symVal());
+                } else
+                {
+                    os << "sym_" << symVal().id();
+                }
                 break;
             default:
                 IR_ASSERTD( 0);
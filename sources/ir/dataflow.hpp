@@ -0,0 +1,622 @@
+/**
+ * @file: ir/dataflow.hpp
+ * Iterative dataflow solver over the control flow graph
+ * @ingroup CF
+ */
+ /*
+  * Copyright 2012 MIPT-COMPILER team
+  */
+
+#pragma once
+
+namespace IR
+{
+    /** Direction the values flow in */
+    enum DataflowDir
+    {
+        DATAFLOW_FORWARD,  /**< From the start node along the edges */
+        DATAFLOW_BACKWARD  /**< From the stop node against the edges */
+    };
+
+    /**
+     * Sparse set turns dense when it has more than one element per this number of
+     * the universe's elements: the dense set takes a bit per element, the sparse one takes 32 bits per member
+     */
+    const UInt32 DATAFLOW_DENSE_RATIO = 32;
+
+    /** Dense set turns sparse when it has less than one element per this number of the universe's elements */
+    const UInt32 DATAFLOW_SPARSE_RATIO = 64;
+
+    /**
+     * @class DataflowSet
+     * @brief Set of numbers from 0 to universe - 1 that is a sorted array or a bit set depending on its density
+     *
+     * A set starts sparse and is switched to the other form after the operations that change it
+     * when its density crosses the thresholds. The thresholds differ so that a set near one of them
+     * isn't converted back and forth. Operations on a dense and a sparse set go over the members of the sparse one
+     * @ingroup CF
+     */
+    class DataflowSet
+    {
+    public:
+        inline DataflowSet( UInt32 universe = 0);
+
+        inline UInt32 universe() const;    /**< Get number of the numbers the set can hold */
+        inline bool isDense() const;       /**< Check that the set is a bit set now */
+        inline UInt32 count() const;       /**< Get number of the numbers in the set */
+        inline bool test( UInt32 i) const; /**< Check that the number is in the set */
+
+        inline void set( UInt32 i);        /**< Add the number */
+        inline void reset( UInt32 i);      /**< Remove the number */
+        inline void clear();               /**< Remove all the numbers, the set becomes sparse */
+
+        /** Get the least number in the set not less than the given one, BITSET_NO_BIT if there is none */
+        inline UInt32 next( UInt32 from) const;
+
+        /** Add the numbers of the other set, returns true if the set is changed */
+        inline bool unite( const DataflowSet &s);
+
+        /** Remove the numbers of the other set */
+        inline void subtract( const DataflowSet &s);
+
+        /** Make the set equal to gen | ( in & ~kill), returns true if the set is changed */
+        inline bool assignTransfer( const DataflowSet &gen, const DataflowSet &in, const DataflowSet &kill);
+
+        inline bool operator == ( const DataflowSet &s) const;
+        inline bool operator != ( const DataflowSet &s) const;
+    private:
+        /** Switch the form of the set if its density crossed the threshold */
+        inline void adapt();
+
+        /** Convert the set to a bit set */
+        inline void makeDense();
+
+        UInt32 universe_;
+        bool dense;
+        BitSet bits;             /**< Members of the dense set */
+        vector< UInt32> members; /**< Sorted members of the sparse set */
+    };
+
+    /**
+     * @class DataflowSolver
+     * @brief Solves a dataflow problem over the CFG by iterating to the fixed point
+     *
+     * The problem gives the type of the values and the functions of the lattice:
+     * @code
+     *   typedef ... Value;
+     *   DataflowDir direction() const;
+     *   void init( Value &v) const;                         // value every node starts with, the identity of meet
+     *   void boundary( Value &v) const;                     // value that enters the start or the stop node
+     *   void meet( Value &dst, const Value &src) const;     // combine the value of a neighbour into dst
+     *   bool transfer( CFNode *node, UInt32 index,
+     *                  const Value &in, Value &out) const;  // out = f( in), returns true if out is changed
+     * @endcode
+     * For a forward problem in is the value on entry of the node and out is the value on exit,
+     * for a backward one it is the other way round. The index of the node is the solver's one,
+     * so the problem may keep its per node data in arrays.
+     *
+     * The worklist is a priority queue of the nodes in reverse postorder for the forward problems
+     * and in postorder for the backward ones, so every node is visited after its predecessors
+     * (successors) except along the back edges and an acyclic graph takes one visit per node.
+     * The pending nodes are bits of a bit set, the least one is taken next. The solver keeps
+     * the topological numeration of the CFG while it exists, so the CFG must not be changed
+     * @ingroup CF
+     */
+    template <class MDesType, class Problem> class DataflowSolver
+    {
+    public:
+        typedef typename Problem::Value Value;
+
+        DataflowSolver( CFG< MDesType> *cfg, const Problem &problem); /**< Prepare solver for the graph */
+        ~DataflowSolver();                                            /**< Release the numeration of the graph */
+
+        inline UInt32 numNodes() const;                    /**< Get number of the graph's nodes */
+        inline UInt32 index( CFNode< MDesType> *n) const;  /**< Get index of the node from 0 to the number of nodes - 1 */
+        inline CFNode< MDesType> *node( UInt32 i) const;   /**< Get node by its index */
+
+        /** Iterate to the fixed point, may be called again after the problem's data changed */
+        void solve();
+
+        /** Get the value on entry of the node */
+        inline const Value &entry( CFNode< MDesType> *n) const;
+
+        /** Get the value on exit of the node */
+        inline const Value &exit( CFNode< MDesType> *n) const;
+
+        /** Get number of the nodes' visits the last solving took */
+        inline UInt32 numVisits() const;
+    private:
+        DataflowSolver( const DataflowSolver &);
+        DataflowSolver &operator = ( const DataflowSolver &);
+
+        /** Get priority of the node by its index, the lesser is visited first */
+        inline UInt32 priority( UInt32 i) const;
+
+        CFG< MDesType> *cfg_;
+        const Problem &problem_;
+        Numeration topo_num;              /**< Topological numeration, numbers are the indices of the nodes */
+        vector< CFNode< MDesType> *> nodes;
+        vector< Value> ins;               /**< Values the transfer functions start from */
+        vector< Value> outs;              /**< Results of the transfer functions */
+        UInt32 num_visits;
+    };
+
+    /**
+     * @class GenKillProblem
+     * @brief Problem of the sets where every node generates and kills some numbers, meet is the union
+     *
+     * Covers may problems like liveness and reaching definitions. The gen and kill sets are filled
+     * by the user for the indices of the solver's nodes before solving
+     * @ingroup CF
+     */
+    class GenKillProblem
+    {
+    public:
+        typedef DataflowSet Value;
+
+        /** Create problem for the given number of nodes over the numbers from 0 to universe - 1 */
+        inline GenKillProblem( DataflowDir dir, UInt32 num_nodes, UInt32 universe);
+
+        inline DataflowSet &gen( UInt32 index);  /**< Get the numbers generated by the node */
+        inline DataflowSet &kill( UInt32 index); /**< Get the numbers killed by the node */
+
+        inline DataflowDir direction() const;
+        inline void init( DataflowSet &v) const;
+        inline void boundary( DataflowSet &v) const;
+        inline void meet( DataflowSet &dst, const DataflowSet &src) const;
+
+        template <class MDesType>
+        inline bool transfer( CFNode< MDesType> *node, UInt32 index, const DataflowSet &in, DataflowSet &out) const;
+    private:
+        DataflowDir dir_;
+        UInt32 universe_;
+        vector< DataflowSet> gens;
+        vector< DataflowSet> kills;
+    };
+
+    DataflowSet::DataflowSet( UInt32 universe): universe_( universe), dense( false)
+    {
+    }
+
+    /** Get number of the numbers the set can hold */
+    UInt32 DataflowSet::universe() const
+    {
+        return universe_;
+    }
+
+    /** Check that the set is a bit set now */
+    bool DataflowSet::isDense() const
+    {
+        return dense;
+    }
+
+    /** Get number of the numbers in the set */
+    UInt32 DataflowSet::count() const
+    {
+        return dense ? bits.count() : (UInt32)members.size();
+    }
+
+    /** Check that the number is in the set */
+    bool DataflowSet::test( UInt32 i) const
+    {
+        IR_ASSERTD( i < universe_);
+        return dense ? bits.test( i) : std::binary_search( members.begin(), members.end(), i);
+    }
+
+    /** Convert the set to a bit set */
+    void DataflowSet::makeDense()
+    {
+        if ( dense)
+            return;
+
+        bits.resize( universe_);
+        bits.clear();
+        for ( UInt32 k = 0; k < members.size(); k++)
+        {
+            bits.set( members[ k]);
+        }
+        members.clear();
+        dense = true;
+    }
+
+    /** Switch the form of the set if its density crossed the threshold */
+    void DataflowSet::adapt()
+    {
+        if ( !dense && (UInt64)members.size() * DATAFLOW_DENSE_RATIO > universe_)
+        {
+            makeDense();
+        } else if ( dense && (UInt64)bits.count() * DATAFLOW_SPARSE_RATIO < universe_)
+        {
+            members.clear();
+            for ( UInt32 i = bits.next( 0); i != BITSET_NO_BIT; i = bits.next( i + 1))
+            {
+                members.push_back( i);
+            }
+            bits.resize( 0);
+            dense = false;
+        }
+    }
+
+    /** Add the number */
+    void DataflowSet::set( UInt32 i)
+    {
+        IR_ASSERTD( i < universe_);
+        if ( dense)
+        {
+            bits.set( i);
+            return;
+        }
+        vector< UInt32>::iterator it = std::lower_bound( members.begin(), members.end(), i);
+
+        if ( it == members.end() || *it != i )
+        {
+            members.insert( it, i);
+            adapt();
+        }
+    }
+
+    /** Remove the number */
+    void DataflowSet::reset( UInt32 i)
+    {
+        IR_ASSERTD( i < universe_);
+        if ( dense)
+        {
+            bits.reset( i);
+            adapt();
+            return;
+        }
+        vector< UInt32>::iterator it = std::lower_bound( members.begin(), members.end(), i);
+
+        if ( it != members.end() && *it == i )
+        {
+            members.erase( it);
+        }
+    }
+
+    /** Remove all the numbers, the set becomes sparse */
+    void DataflowSet::clear()
+    {
+        members.clear();
+        bits.resize( 0);
+        dense = false;
+    }
+
+    /** Get the least number in the set not less than the given one, BITSET_NO_BIT if there is none */
+    UInt32 DataflowSet::next( UInt32 from) const
+    {
+        if ( dense)
+            return bits.next( from);
+
+        vector< UInt32>::const_iterator it = std::lower_bound( members.begin(), members.end(), from);
+
+        return it == members.end() ? BITSET_NO_BIT : *it;
+    }
+
+    /** Add the numbers of the other set, returns true if the set is changed */
+    bool DataflowSet::unite( const DataflowSet &s)
+    {
+        IR_ASSERTD( s.universe_ == universe_);
+
+        bool changed = false;
+
+        if ( !dense && !s.dense)
+        {
+            vector< UInt32> res( members.size() + s.members.size());
+
+            res.resize( std::set_union( members.begin(), members.end(), s.members.begin(), s.members.end(),
+                                        res.begin()) - res.begin());
+            changed = res.size() != members.size();
+            members.swap( res);
+        } else
+        {
+            makeDense();
+            if ( s.dense)
+            {
+                changed = bits.unite( s.bits);
+            } else
+            {
+                for ( UInt32 k = 0; k < s.members.size(); k++)
+                {
+                    changed = changed || !bits.test( s.members[ k]);
+                    bits.set( s.members[ k]);
+                }
+            }
+        }
+        if ( changed)
+        {
+            adapt();
+        }
+        return changed;
+    }
+
+    /** Remove the numbers of the other set */
+    void DataflowSet::subtract( const DataflowSet &s)
+    {
+        IR_ASSERTD( s.universe_ == universe_);
+        if ( !dense && !s.dense)
+        {
+            members.resize( std::set_difference( members.begin(), members.end(), s.members.begin(), s.members.end(),
+                                                 members.begin()) - members.begin());
+        } else if ( !dense)
+        {
+            UInt32 num = 0;
+
+            for ( UInt32 k = 0; k < members.size(); k++)
+            {
+                if ( !s.bits.test( members[ k]) )
+                {
+                    members[ num++] = members[ k];
+                }
+            }
+            members.resize( num);
+        } else
+        {
+            if ( s.dense)
+            {
+                bits.subtract( s.bits);
+            } else
+            {
+                for ( UInt32 k = 0; k < s.members.size(); k++)
+                {
+                    bits.reset( s.members[ k]);
+                }
+            }
+            adapt();
+        }
+    }
+
+    /** Make the set equal to gen | ( in & ~kill), returns true if the set is changed */
+    bool DataflowSet::assignTransfer( const DataflowSet &gen, const DataflowSet &in, const DataflowSet &kill)
+    {
+        IR_ASSERTD( gen.universe_ == universe_ && in.universe_ == universe_ && kill.universe_ == universe_);
+
+        if ( dense && gen.dense && in.dense && kill.dense)
+        {
+            /* Word kernel of the bit sets */
+            bool changed = bits.assignTransfer( gen.bits, in.bits, kill.bits);
+
+            if ( changed)
+            {
+                adapt();
+            }
+            return changed;
+        }
+        DataflowSet res( in);
+
+        res.subtract( kill);
+        res.unite( gen);
+        if ( res == *this)
+            return false;
+
+        *this = res;
+        return true;
+    }
+
+    bool DataflowSet::operator == ( const DataflowSet &s) const
+    {
+        if ( universe_ != s.universe_)
+            return false;
+
+        if ( dense == s.dense)
+            return dense ? bits == s.bits : members == s.members;
+
+        const DataflowSet &sparse = dense ? s : *this;
+        const DataflowSet &other = dense ? *this : s;
+
+        if ( other.bits.count() != sparse.members.size() )
+            return false;
+
+        for ( UInt32 k = 0; k < sparse.members.size(); k++)
+        {
+            if ( !other.bits.test( sparse.members[ k]) )
+                return false;
+        }
+        return true;
+    }
+
+    bool DataflowSet::operator != ( const DataflowSet &s) const
+    {
+        return !( *this == s);
+    }
+
+    /** Prepare solver for the graph */
+    template <class MDesType, class Problem>
+    DataflowSolver< MDesType, Problem>::DataflowSolver( CFG< MDesType> *cfg, const Problem &problem):
+        cfg_( cfg), problem_( problem), topo_num( cfg->makeTopologicalNumeration()), num_visits( 0)
+    {
+        nodes.resize( cfg->numNodes(), NULL);
+        for ( CFNode< MDesType> *n = cfg->firstNode(); isNotNullP( n); n = n->nextNode())
+        {
+            nodes[ index( n)] = n;
+        }
+    }
+
+    /** Release the numeration of the graph */
+    template <class MDesType, class Problem>
+    DataflowSolver< MDesType, Problem>::~DataflowSolver()
+    {
+        cfg_->freeNum( topo_num);
+    }
+
+    /** Get number of the graph's nodes */
+    template <class MDesType, class Problem>
+    UInt32
+    DataflowSolver< MDesType, Problem>::numNodes() const
+    {
+        return (UInt32)nodes.size();
+    }
+
+    /** Get index of the node from 0 to the number of nodes - 1 */
+    template <class MDesType, class Problem>
+    UInt32
+    DataflowSolver< MDesType, Problem>::index( CFNode< MDesType> *n) const
+    {
+        return n->number( topo_num);
+    }
+
+    /** Get node by its index */
+    template <class MDesType, class Problem>
+    CFNode< MDesType> *
+    DataflowSolver< MDesType, Problem>::node( UInt32 i) const
+    {
+        return nodes[ i];
+    }
+
+    /**
+     * Get priority of the node by its index, the lesser is visited first. Indices are the topological
+     * numbers with the reachable nodes at the end in reverse postorder
+     */
+    template <class MDesType, class Problem>
+    UInt32
+    DataflowSolver< MDesType, Problem>::priority( UInt32 i) const
+    {
+        return problem_.direction() == DATAFLOW_FORWARD ? i : numNodes() - 1 - i;
+    }
+
+    /** Iterate to the fixed point, may be called again after the problem's data changed */
+    template <class MDesType, class Problem>
+    void
+    DataflowSolver< MDesType, Problem>::solve()
+    {
+        UInt32 n = numNodes();
+        bool forward = problem_.direction() == DATAFLOW_FORWARD;
+        CFNode< MDesType> *boundary_node = forward ? cfg_->startNode() : cfg_->stopNode();
+        BitSet pending( n);
+        UInt32 cursor = 0;
+
+        ins.resize( n);
+        outs.resize( n);
+        for ( UInt32 i = 0; i < n; i++)
+        {
+            problem_.init( ins[ i]);
+            problem_.init( outs[ i]);
+            pending.set( i);
+        }
+        num_visits = 0;
+
+        /* Bits of the pending set are the priorities, the cursor is not greater than the least of them */
+        for ( UInt32 p = pending.next( cursor); p != BITSET_NO_BIT; p = pending.next( cursor))
+        {
+            UInt32 i = priority( p);
+            CFNode< MDesType> *n = nodes[ i];
+            Value &in = ins[ i];
+
+            pending.reset( p);
+            cursor = p;
+            num_visits++;
+
+            if ( areEqP( n, boundary_node) )
+            {
+                problem_.boundary( in);
+            } else
+            {
+                problem_.init( in);
+            }
+            if ( forward)
+            {
+                for ( CFEdge< MDesType> *e = n->firstPred(); isNotNullP( e); e = e->nextPred())
+                {
+                    problem_.meet( in, outs[ index( e->pred())]);
+                }
+            } else
+            {
+                for ( CFEdge< MDesType> *e = n->firstSucc(); isNotNullP( e); e = e->nextSucc())
+                {
+                    problem_.meet( in, outs[ index( e->succ())]);
+                }
+            }
+            if ( !problem_.transfer( n, i, in, outs[ i]) )
+                continue;
+
+            /* Neighbours the value flows to are pending again */
+            for ( CFEdge< MDesType> *e = forward ? n->firstSucc() : n->firstPred();
+                  isNotNullP( e);
+                  e = forward ? e->nextSucc() : e->nextPred() )
+            {
+                UInt32 q = priority( index( forward ? e->succ() : e->pred()));
+
+                pending.set( q);
+                cursor = min( cursor, q);
+            }
+        }
+    }
+
+    /** Get the value on entry of the node */
+    template <class MDesType, class Problem>
+    const typename DataflowSolver< MDesType, Problem>::Value &
+    DataflowSolver< MDesType, Problem>::entry( CFNode< MDesType> *n) const
+    {
+        return problem_.direction() == DATAFLOW_FORWARD ? ins[ index( n)] : outs[ index( n)];
+    }
+
+    /** Get the value on exit of the node */
+    template <class MDesType, class Problem>
+    const typename DataflowSolver< MDesType, Problem>::Value &
+    DataflowSolver< MDesType, Problem>::exit( CFNode< MDesType> *n) const
+    {
+        return problem_.direction() == DATAFLOW_FORWARD ? outs[ index( n)] : ins[ index( n)];
+    }
+
+    /** Get number of the nodes' visits the last solving took */
+    template <class MDesType, class Problem>
+    UInt32
+    DataflowSolver< MDesType, Problem>::numVisits() const
+    {
+        return num_visits;
+    }
+
+    /** Create problem for the given number of nodes over the numbers from 0 to universe - 1 */
+    GenKillProblem::GenKillProblem( DataflowDir dir, UInt32 num_nodes, UInt32 universe):
+        dir_( dir), universe_( universe),
+        gens( num_nodes, DataflowSet( universe)), kills( num_nodes, DataflowSet( universe))
+    {
+    }
+
+    /** Get the numbers generated by the node */
+    DataflowSet &GenKillProblem::gen( UInt32 index)
+    {
+        return gens[ index];
+    }
+
+    /** Get the numbers killed by the node */
+    DataflowSet &GenKillProblem::kill( UInt32 index)
+    {
+        return kills[ index];
+    }
+
+    DataflowDir GenKillProblem::direction() const
+    {
+        return dir_;
+    }
+
+    /** Nodes start with the empty sets */
+    void GenKillProblem::init( DataflowSet &v) const
+    {
+        if ( v.universe() != universe_)
+        {
+            v = DataflowSet( universe_);
+        } else
+        {
+            v.clear();
+        }
+    }
+
+    /** Nothing comes from outside of the function */
+    void GenKillProblem::boundary( DataflowSet &v) const
+    {
+        init( v);
+    }
+
+    /** Union of the neighbours' sets */
+    void GenKillProblem::meet( DataflowSet &dst, const DataflowSet &src) const
+    {
+        dst.unite( src);
+    }
+
+    /** out = gen | ( in & ~kill) */
+    template <class MDesType>
+    bool GenKillProblem::transfer( CFNode< MDesType> *, UInt32 index, const DataflowSet &in, DataflowSet &out) const
+    {
+        return out.assignTransfer( gens[ index], in, kills[ index]);
+    }
+}
@@ -11,18 +11,48 @@
 namespace IR
 {
     using namespace Graph;
+
+    /**
+     * Types of dependences
+     * @ingroup DG
+     */
+    enum DepType
+    {
+        DEP_TRUE,   /**< Successor reads what predecessor writes        */
+        DEP_ANTI,   /**< Successor writes what predecessor reads        */
+        DEP_OUTPUT, /**< Successor writes what predecessor writes       */
+        DEP_TYPES_NUM
+    };
+
     /**
      * @class DepEdge
      * @brief Dependence edge class
+     *
+     * The edge is annotated with the type of the dependence, whether it goes through
+     * an object or through memory and the latency: number of cycles that must pass
+     * between the issue of the predecessor and the issue of the successor
      * @ingroup DG
      */
-    template <class MDesType> class DepEdge: 
+    template <class MDesType> class DepEdge:
         public Edge< DG <MDesType>, typename MDesType::OperationType, DepEdge<MDesType> >
     {
     public:
-        /** Control flow edge constructor */
-        inline DepEdge( DG<MDesType> *g, typename MDesType::OperationType *pred, typename MDesType::OperationType *succ);
+        /** Dependence edge constructor */
+        inline DepEdge( typename MDesType::OperationType *pred, typename MDesType::OperationType *succ);
+
+        inline DepType type() const;         /**< Get type of the dependence  */
+        inline void setType( DepType t);     /**< Set type of the dependence  */
+        inline bool isMem() const;           /**< Check that the dependence goes through memory */
+        inline void setMem( bool is_mem);    /**< Set whether the dependence goes through memory */
+        inline UInt32 latency() const;       /**< Get latency of the dependence */
+        inline void setLatency( UInt32 lat); /**< Set latency of the dependence */
+
+        /** Print edge to stream */
+        inline void toStream(ostream& os);
     private:
+        UInt32 latency_;
+        UInt8 type_;
+        bool is_mem_;
     };
 
     /**
@@ -31,18 +61,116 @@ namespace IR
      * @defgroup DG
      * @ingroup IR
      */
-    template <class MDesType> class DG: 
+    template <class MDesType> class DG:
     public Graph< DG <MDesType>, typename MDesType::OperationType, DepEdge<MDesType> >
     {
-        
+    public:
+        /** Create dependence edge of the given type and latency */
+        inline DepEdge< MDesType> *newDep( typename MDesType::OperationType *pred,
+                                           typename MDesType::OperationType *succ,
+                                           DepType type,
+                                           bool is_mem,
+                                           UInt32 latency);
+
+        /** Delete the dependence edges of the operation */
+        inline void removeDeps( typename MDesType::OperationType *oper);
+
+        /** Delete all dependence edges */
+        inline void clearDeps();
     };
 
     /** Dependence edge constructor */
-    template < class MDesType> DepEdge<MDesType>::DepEdge( DG <MDesType> *g, typename MDesType::OperationType *pred, typename MDesType::OperationType *succ):
-        Edge< DG <MDesType>, typename MDesType::OperationType, DepEdge<MDesType> >( g, pred, succ)
+    template < class MDesType> DepEdge<MDesType>::DepEdge( typename MDesType::OperationType *pred, typename MDesType::OperationType *succ):
+        Edge< DG <MDesType>, typename MDesType::OperationType, DepEdge<MDesType> >( pred, succ),
+        latency_( 0),
+        type_( DEP_TRUE),
+        is_mem_( false)
     {
-    
+
     }
 
+    /** Get type of the dependence */
+    template < class MDesType> DepType DepEdge<MDesType>::type() const
+    {
+        return (DepType)type_;
+    }
 
+    /** Set type of the dependence */
+    template < class MDesType> void DepEdge<MDesType>::setType( DepType t)
+    {
+        type_ = (UInt8)t;
+    }
+
+    /** Check that the dependence goes through memory */
+    template < class MDesType> bool DepEdge<MDesType>::isMem() const
+    {
+        return is_mem_;
+    }
+
+    /** Set whether the dependence goes through memory */
+    template < class MDesType> void DepEdge<MDesType>::setMem( bool is_mem)
+    {
+        is_mem_ = is_mem;
+    }
+
+    /** Get latency of the dependence */
+    template < class MDesType> UInt32 DepEdge<MDesType>::latency() const
+    {
+        return latency_;
+    }
+
+    /** Set latency of the dependence */
+    template < class MDesType> void DepEdge<MDesType>::setLatency( UInt32 lat)
+    {
+        latency_ = lat;
+    }
+
+    /** Print edge to stream */
+    template < class MDesType> void DepEdge<MDesType>::toStream(ostream& os)
+    {
+        static const char *type_names[ DEP_TYPES_NUM] = { "true", "anti", "output"};
+
+        os << "Dep Edge " << this->id() << ": ";
+        os << this->pred()->id() << "->" << this->succ()->id();
+        os << ", " << type_names[ type()] << ( isMem() ? " mem" : "");
+        os << ", latency " << latency() << endl;
+    }
+
+    /** Create dependence edge of the given type and latency */
+    template < class MDesType> DepEdge< MDesType> *
+    DG<MDesType>::newDep( typename MDesType::OperationType *pred,
+                          typename MDesType::OperationType *succ,
+                          DepType type,
+                          bool is_mem,
+                          UInt32 latency)
+    {
+        DepEdge< MDesType> *edge = this->newEdge( pred, succ);
+
+        edge->setType( type);
+        edge->setMem( is_mem);
+        edge->setLatency( latency);
+        return edge;
+    }
+
+    /** Delete the dependence edges of the operation */
+    template < class MDesType> void DG<MDesType>::removeDeps( typename MDesType::OperationType *oper)
+    {
+        while ( isNotNullP( oper->firstSucc()) )
+        {
+            this->deleteEdge( oper->firstSucc());
+        }
+        while ( isNotNullP( oper->firstPred()) )
+        {
+            this->deleteEdge( oper->firstPred());
+        }
+    }
+
+    /** Delete all dependence edges */
+    template < class MDesType> void DG<MDesType>::clearDeps()
+    {
+        while ( isNotNullP( this->firstEdge()) )
+        {
+            this->deleteEdge( this->firstEdge());
+        }
+    }
 };
\ No newline at end of file
@@ -0,0 +1,268 @@
+/**
+ * @file: ir/dom.hpp
+ * Dominator tree and dominance frontiers of the control flow graph
+ * @ingroup CF
+ */
+ /*
+  * Copyright 2012 MIPT-COMPILER team
+  */
+
+#pragma once
+
+namespace IR
+{
+    /**
+     * @class DomTree
+     * @brief Dominator tree of the control flow graph along with dominance frontiers
+     *
+     * Immediate dominators are computed by the iterative algorithm of Cooper, Harvey and Kennedy
+     * over the topological (reverse postorder) numbers of the nodes, the frontiers are collected
+     * by walking up from the predecessors of every join node. The tree keeps the topological numeration
+     * of the CFG while it exists, so the CFG must not be changed while the tree is in use.
+     * Nodes that are not reachable from the start node are not in the tree.
+     * @ingroup CF
+     */
+    template <class MDesType> class DomTree
+    {
+    public:
+        DomTree( CFG< MDesType> *cfg); /**< Build the tree for the given graph */
+        ~DomTree();                    /**< Release the numeration of the graph */
+
+        inline CFG< MDesType> *cfg() const;                /**< Get the graph of the tree */
+        inline UInt32 numNodes() const;                    /**< Get number of reachable nodes */
+        inline CFNode< MDesType> *node( UInt32 num) const; /**< Get the node by its number, the start node has number 0 */
+        inline UInt32 num( CFNode< MDesType> *n) const;    /**< Get the topological number of reachable node */
+        inline bool isReachable( CFNode< MDesType> *n) const;  /**< Check that the node is in the tree */
+        inline CFNode< MDesType> *idom( CFNode< MDesType> *n) const; /**< Get immediate dominator, NULL for the start node */
+
+        /** Check that the first node dominates the second one, every node dominates itself */
+        inline bool dominates( CFNode< MDesType> *dom, CFNode< MDesType> *n) const;
+
+        /** Get the nodes immediately dominated by the given one */
+        inline const vector< CFNode< MDesType> *> &children( CFNode< MDesType> *n) const;
+
+        /** Get the dominance frontier of the node */
+        inline const vector< CFNode< MDesType> *> &frontier( CFNode< MDesType> *n) const;
+    private:
+        /** Find the common dominator of two nodes given by numbers */
+        inline UInt32 intersect( UInt32 a, UInt32 b) const;
+
+        CFG< MDesType> *cfg_;     /**< The graph */
+        Numeration topo_num;      /**< Topological numeration of the graph */
+        GraphNum start_num;       /**< Topological number of the start node */
+        vector< CFNode< MDesType> *> nodes; /**< Reachable nodes in topological order */
+        vector< UInt32> idoms;              /**< Immediate dominator numbers indexed by node numbers */
+        vector< UInt32> enter;              /**< Preorder numbers of the nodes in the tree */
+        vector< UInt32> leave;              /**< Numbers of the nodes after their subtrees in preorder */
+        vector< vector< CFNode< MDesType> *> > kids;      /**< Children of the nodes in the tree */
+        vector< vector< CFNode< MDesType> *> > frontiers; /**< Dominance frontiers of the nodes */
+    };
+
+    /** Undefined number of immediate dominator */
+    const UInt32 DOM_NO_NUM = (UInt32)-1;
+
+    /** Build the tree for the given graph */
+    template <class MDesType>
+    DomTree< MDesType>::DomTree( CFG< MDesType> *cfg):
+        cfg_( cfg), topo_num( cfg->makeTopologicalNumeration())
+    {
+        start_num = cfg->startNode()->number( topo_num);
+
+        UInt32 n = cfg->numNodes() - start_num;
+
+        nodes.resize( n, NULL);
+        idoms.resize( n, DOM_NO_NUM);
+        kids.resize( n);
+        frontiers.resize( n);
+        for ( CFNode< MDesType> *node = cfg->firstNode();
+              isNotNullP( node);
+              node = node->nextNode() )
+        {
+            if ( isReachable( node) )
+            {
+                nodes[ num( node)] = node;
+            }
+        }
+
+        /* Immediate dominators, iterate until the fixed point */
+        bool changed = true;
+
+        idoms[ 0] = 0;
+        while ( changed)
+        {
+            changed = false;
+            for ( UInt32 i = 1; i < n; i++)
+            {
+                UInt32 new_idom = DOM_NO_NUM;
+
+                for ( CFEdge< MDesType> *e = nodes[ i]->firstPred(); isNotNullP( e); e = e->nextPred())
+                {
+                    if ( !isReachable( e->pred()) )
+                        continue;
+
+                    UInt32 p = num( e->pred());
+
+                    if ( idoms[ p] == DOM_NO_NUM )
+                        continue;
+                    new_idom = ( new_idom == DOM_NO_NUM) ? p : intersect( p, new_idom);
+                }
+                if ( idoms[ i] != new_idom)
+                {
+                    idoms[ i] = new_idom;
+                    changed = true;
+                }
+            }
+        }
+
+        /* Frontiers, walk up from the predecessors of every join node to its immediate dominator */
+        for ( UInt32 i = 1; i < n; i++)
+        {
+            kids[ idoms[ i]].push_back( nodes[ i]);
+
+            if ( isNullP( nodes[ i]->firstPred()) || isNullP( nodes[ i]->firstPred()->nextPred()) )
+                continue;
+
+            for ( CFEdge< MDesType> *e = nodes[ i]->firstPred(); isNotNullP( e); e = e->nextPred())
+            {
+                if ( !isReachable( e->pred()) )
+                    continue;
+
+                for ( UInt32 runner = num( e->pred()); runner != idoms[ i]; runner = idoms[ runner])
+                {
+                    if ( frontiers[ runner].empty() || frontiers[ runner].back() != nodes[ i] )
+                    {
+                        frontiers[ runner].push_back( nodes[ i]);
+                    }
+                }
+            }
+        }
+
+        /* Preorder numbers for constant time dominance check */
+        vector< pair< UInt32, UInt32> > stack;
+        UInt32 counter = 0;
+
+        enter.resize( n);
+        leave.resize( n);
+        stack.push_back( make_pair( 0U, 0U));
+        enter[ 0] = counter++;
+        while ( !stack.empty() )
+        {
+            UInt32 i = stack.back().first;
+            UInt32 k = stack.back().second;
+
+            if ( k < kids[ i].size() )
+            {
+                UInt32 kid = num( kids[ i][ k]);
+
+                stack.back().second++;
+                enter[ kid] = counter++;
+                stack.push_back( make_pair( kid, 0U));
+            } else
+            {
+                leave[ i] = counter;
+                stack.pop_back();
+            }
+        }
+    }
+
+    /** Release the numeration of the graph */
+    template <class MDesType>
+    DomTree< MDesType>::~DomTree()
+    {
+        cfg_->freeNum( topo_num);
+    }
+
+    /** Find the common dominator of two nodes given by numbers */
+    template <class MDesType>
+    UInt32
+    DomTree< MDesType>::intersect( UInt32 a, UInt32 b) const
+    {
+        while ( a != b)
+        {
+            while ( a > b)
+                a = idoms[ a];
+            while ( b > a)
+                b = idoms[ b];
+        }
+        return a;
+    }
+
+    /** Get the graph of the tree */
+    template <class MDesType>
+    CFG< MDesType> *
+    DomTree< MDesType>::cfg() const
+    {
+        return cfg_;
+    }
+
+    /** Get number of reachable nodes */
+    template <class MDesType>
+    UInt32
+    DomTree< MDesType>::numNodes() const
+    {
+        return (UInt32)nodes.size();
+    }
+
+    /** Get the node by its number */
+    template <class MDesType>
+    CFNode< MDesType> *
+    DomTree< MDesType>::node( UInt32 n) const
+    {
+        IR_ASSERTD( n < nodes.size());
+        return nodes[ n];
+    }
+
+    /** Get the topological number of reachable node */
+    template <class MDesType>
+    UInt32
+    DomTree< MDesType>::num( CFNode< MDesType> *n) const
+    {
+        IR_ASSERTD( isReachable( n));
+        return n->number( topo_num) - start_num;
+    }
+
+    /** Check that the node is in the tree */
+    template <class MDesType>
+    bool
+    DomTree< MDesType>::isReachable( CFNode< MDesType> *n) const
+    {
+        return n->number( topo_num) >= start_num;
+    }
+
+    /** Get immediate dominator, NULL for the start node */
+    template <class MDesType>
+    CFNode< MDesType> *
+    DomTree< MDesType>::idom( CFNode< MDesType> *n) const
+    {
+        UInt32 i = num( n);
+
+        return ( i == 0) ? NULL : nodes[ idoms[ i]];
+    }
+
+    /** Check that the first node dominates the second one */
+    template <class MDesType>
+    bool
+    DomTree< MDesType>::dominates( CFNode< MDesType> *dom, CFNode< MDesType> *n) const
+    {
+        UInt32 d = num( dom);
+        UInt32 i = num( n);
+
+        return enter[ d] <= enter[ i] && enter[ i] < leave[ d];
+    }
+
+    /** Get the nodes immediately dominated by the given one */
+    template <class MDesType>
+    const vector< CFNode< MDesType> *> &
+    DomTree< MDesType>::children( CFNode< MDesType> *n) const
+    {
+        return kids[ num( n)];
+    }
+
+    /** Get the dominance frontier of the node */
+    template <class MDesType>
+    const vector< CFNode< MDesType> *> &
+    DomTree< MDesType>::frontier( CFNode< MDesType> *n) const
+    {
+        return frontiers[ num( n)];
+    }
+};
@@ -21,7 +21,7 @@ template <class MDesType> class Function:
 {
 public:
     Function( Module<MDesType> *m);                   /**< Create function in given module */
-    Function( Module<MDesType> *m, string func_name); /**< Create named function in given module */
+    Function( Module<MDesType> *m, Symbol func_name); /**< Create named function in given module */
     
     virtual ~Function();  /**< Delete function */
 
@@ -33,13 +33,40 @@ public:
         
     /** Create new operaiton and insert it into sequence */
     inline typename MDesType::OperationType * newOperAfter( typename MDesType::OperName name, typename MDesType::OperationType *prev_oper); 
+
+    /** Create new operation and insert it into sequence and control flow node before the given operation */
+    inline typename MDesType::OperationType * newOperBefore( typename MDesType::OperName name, Operation< MDesType> *next_oper);
+
+    /** Remove operation from sequence and control flow node and delete it */
+    inline void deleteOper( Operation< MDesType> *oper);
         
-    /** Create new object */
+    /** Create new object, its id is the next one among the objects of the given type */
     inline Object< MDesType> * newObject( typename MDesType::ObjectName name);
     
     /** Create new object */
     inline Object< MDesType> * newArg( UInt16 arg_num, typename MDesType::ObjectName name);
 
+    /** Make the existing object the argument with the given number */
+    inline void setArg( UInt16 arg_num, Object< MDesType> *obj);
+
+    /** Get number of the function's arguments */
+    inline UInt16 numArgs() const;
+
+    /** Get the argument object with the given number */
+    inline Object< MDesType> *arg( UInt16 arg_num) const;
+
+    /** Get the arena that holds the function's objects, operand arrays and use lists */
+    inline Arena &arena();
+
+    /** Get number of objects of the given type, object ids of the type are less than this number */
+    inline UInt32 numObjects( typename MDesType::ObjectName name) const;
+
+    /** Get object of the given type by its id */
+    inline Object< MDesType> * object( typename MDesType::ObjectName name, UInt32 id) const;
+
+    /** Check that the function is being destroyed, operations need not clean up after themselves then */
+    inline bool isBeingDestroyed() const;
+
     /** Get function's first operation in sequence */
     inline typename MDesType::OperationType * firstOper() const;
 
@@ -49,37 +76,58 @@ public:
     /** Print function to stream */
     inline void toStream(ostream& os);
 
+    /** Print memory usage of function's DG, CFG and arena to stream in one line */
+    inline void memStatsToStream( ostream& os);
+
+    /** Get number of bytes taken by function's DG, CFG and arena */
+    inline UInt64 memBytes();
+
     /** Get the function name */
     inline string name() const;
 
-    /** Get the function name */
+    /** Get the function name symbol */
+    inline Symbol nameSym() const;
+
+    /** Set the function name */
     inline void setName( string new_name);
 private:
     typename MDesType::OperationType *newNode();   /**< Create new dep graph node (operation without a name) */
     Module< MDesType> *module_p;       /**< Pointer to the module */
-    list< Object< MDesType> *> objects;/**< List of function's objects */
+    Arena arena_;                      /**< Memory of objects and operand arrays, must outlive operations */
+    vector< Object< MDesType> *> objects[ MDesType::num_objs]; /**< Function's objects by type and id */
     CFG< MDesType> cfg_;               /**< Control flow graph */
         
     /** First operation in linear sequence of operaitons in this function */
     typename MDesType::OperationType *first_oper_in_seq;
-    /** Next object id */
-    UInt32 obj_id[ MDesType::num_objs];
-    /** Name of the function */
-    string name_;
+    /** Set in the destructor */
+    bool being_destroyed;
+    /** Name of the function in the module's symbol table */
+    Symbol name_;
     /** Arguments */
     vector< Object< MDesType> *> args;
 };
 
 /** Get the function name */
 template <class MDesType> string Function< MDesType>::name() const
+{
+    if ( !name_.isValid() )
+    {
+        return string();
+    }
+    return module_p->symbols().str( name_);
+}
+
+/** Get the function name symbol */
+template <class MDesType> Symbol Function< MDesType>::nameSym() const
 {
     return name_;
 }
 
-/** Get the function name */
+/** Set the function name */
 template <class MDesType> void Function< MDesType>::setName( string new_name)
 {
-    name_ = new_name;
+    IR_ASSERTD( isNotNullP( module_p));
+    name_ = module_p->symbols().intern( new_name);
 }
     
 /** Get function's first operation in sequence */
@@ -97,37 +145,33 @@ template <class MDesType> void Function< MDesType>::setFirstOper( typename MDesT
 /** 
  * Create function in given module
  */
-template <class MDesType> Function< MDesType>::Function( Module<MDesType> *m): module_p( m) 
+template <class MDesType> Function< MDesType>::Function( Module<MDesType> *m):
+    module_p( m), first_oper_in_seq( NULL), being_destroyed( false)
 {
-    for ( int i = 0; i < MDesType::num_objs; ++i)
-    {
-        obj_id[ i] = 0;
-    }
+
 }
 
 /** 
  * Create named function in given module
  */
-template <class MDesType> Function< MDesType>::Function( Module<MDesType> *m, string func_name):
-    module_p( m), name_( func_name) 
+template <class MDesType> Function< MDesType>::Function( Module<MDesType> *m, Symbol func_name):
+    module_p( m), first_oper_in_seq( NULL), being_destroyed( false), name_( func_name)
 {
-    for ( int i = 0; i < MDesType::num_objs; ++i)
-    {
-        obj_id[ i] = 0;
-    }
+
 }
 
 /** 
- * Function destructor
+ * Function destructor. Objects are not destructed one by one: the arena releases them along with
+ * the operand arrays and use lists chunk by chunk, so operations skip unlinking their operands
  */
 template <class MDesType> 
 Function< MDesType>::~Function()
 {
-    for ( typename list< Object< MDesType> *>::iterator it = objects.begin(), end =  objects.end();
-            it != end;
-            ++it)
+    being_destroyed = true;
+    this->clearDeps();
+    for ( typename DG< MDesType>::NodeIter it = this->nodesBegin(), end = this->nodesEnd(); it != end; ++it)
     {
-        delete *it;
+        this->deleteNode( *it);
     }
 }
 
@@ -170,38 +214,132 @@ Function< MDesType>::newOperAfter( typename MDesType::OperName name, typename MD
     return oper;
 }
 
+template <class MDesType>
+typename MDesType::OperationType * 
+Function< MDesType>::newOperBefore( typename MDesType::OperName name, Operation< MDesType> *next_oper)
+{
+    typename MDesType::OperationType * oper = newOper( name);
+    
+    if ( isNotNullP( next_oper->node()) )
+    {
+        next_oper->node()->insertBefore( oper, next_oper);
+    } else
+    {
+        oper->insertBefore( next_oper);
+    }
+    if ( areEqP( first_oper_in_seq, next_oper) )
+    {
+        first_oper_in_seq = oper;
+    }
+    return oper;
+}
+
+template <class MDesType>
+void
+Function< MDesType>::deleteOper( Operation< MDesType> *oper)
+{
+    IR_ASSERTD( areEqP( oper->function(), this) );
+
+    if ( areEqP( first_oper_in_seq, oper) )
+    {
+        first_oper_in_seq = static_cast< typename MDesType::OperationType *>( oper->nextOper());
+    }
+    if ( isNotNullP( oper->node()) )
+    {
+        oper->node()->remove( oper);
+    } else
+    {
+        oper->detachFromSeq();
+    }
+    this->removeDeps( static_cast< typename MDesType::OperationType *>( oper));
+    this->deleteNode( static_cast< typename MDesType::OperationType *>( oper));
+}
+
 template <class MDesType>
 Object< MDesType> * 
 Function< MDesType>::newObject( typename MDesType::ObjectName name)
 {
-    Object< MDesType> * obj = new Object< MDesType>();
+    IR_ASSERTD( name < MDesType::num_objs);
+    Object< MDesType> * obj = new ( arena_.allocate( sizeof( Object< MDesType>))) Object< MDesType>();
     obj->setType( name);
-    obj->setId( obj_id[ name]++);
-    objects.push_back( obj);
+    obj->setId( (UInt32)objects[ name].size());
+    objects[ name].push_back( obj);
     return obj;
 }
 
+template <class MDesType>
+Arena &
+Function< MDesType>::arena()
+{
+    return arena_;
+}
+
+template <class MDesType>
+UInt32
+Function< MDesType>::numObjects( typename MDesType::ObjectName name) const
+{
+    IR_ASSERTD( name < MDesType::num_objs);
+    return (UInt32)objects[ name].size();
+}
+
+template <class MDesType>
+Object< MDesType> *
+Function< MDesType>::object( typename MDesType::ObjectName name, UInt32 id) const
+{
+    IR_ASSERTD( name < MDesType::num_objs && id < objects[ name].size());
+    return objects[ name][ id];
+}
+
+template <class MDesType>
+bool
+Function< MDesType>::isBeingDestroyed() const
+{
+    return being_destroyed;
+}
+
 template <class MDesType>
 Object< MDesType> * 
 Function< MDesType>::newArg( UInt16 arg_num, typename MDesType::ObjectName name)
 {
     Object< MDesType> * obj = newObject( name);
+    setArg( arg_num, obj);
+    return obj;
+}
+
+template <class MDesType>
+void
+Function< MDesType>::setArg( UInt16 arg_num, Object< MDesType> *obj)
+{
     if ( ( arg_num + 1 ) > args.size() )
     {
         args.resize( arg_num + 1);
     }
     args[ arg_num] = obj;
-    return obj;
+}
+
+template <class MDesType>
+UInt16
+Function< MDesType>::numArgs() const
+{
+    return (UInt16)args.size();
+}
+
+template <class MDesType>
+Object< MDesType> *
+Function< MDesType>::arg( UInt16 arg_num) const
+{
+    IR_ASSERTD( arg_num < args.size());
+    return args[ arg_num];
 }
 
 template <class MDesType>
 void
 Function< MDesType>::toStream(ostream& os)
 {
-    Marker m = MarkerManager::newMarker();
+    Marker m = this->newMarker();
 
     /** Print function header */
-    os << "Function " << name_;
+    os << "Function " << name();
 
     /** Print arguments */
     os << "( ";
@@ -251,6 +389,36 @@ Function< MDesType>::toStream(ostream& os)
     this->freeMarker( m);
 }
 
+/** Print memory usage of function's DG, CFG and arena to stream in one line */
+template <class MDesType>
+void
+Function< MDesType>::memStatsToStream( ostream& os)
+{
+    GraphMemStats dg_stats = this->memStats();
+    GraphMemStats cfg_stats = cfg_.memStats();
+    UInt64 obj_num = 0;
+
+    for ( UInt32 i = 0; i < MDesType::num_objs; i++)
+    {
+        obj_num += objects[ i].size();
+    }
+    os << "Function " << name() << " memory: dg { ";
+    dg_stats.toStream( os);
+    os << " } cfg { ";
+    cfg_stats.toStream( os);
+    os << " } objects { live " << obj_num << ", object " << sizeof( Object< MDesType>) << "B }";
+    os << " arena { chunks " << arena_.numChunks() << ", total " << arena_.bytes() << "B }";
+    os << " total " << dg_stats.bytes() + cfg_stats.bytes() + arena_.bytes() << "B" << endl;
+}
+
+/** Get number of bytes taken by function's DG, CFG and arena */
+template <class MDesType>
+UInt64
+Function< MDesType>::memBytes()
+{
+    return this->memStats().bytes() + cfg_.memStats().bytes() + arena_.bytes();
+}
+
 template <class MDesType> 
 std::ostream& operator<<(std::ostream& os, const Function<MDesType> &f) 
 {   
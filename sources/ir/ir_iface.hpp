@@ -7,10 +7,16 @@
 #pragma once 
 #include "predecls.hpp"
 
+#include "symtab.hpp"
 #include "const.hpp"
 #include "mdes.hpp"
+#include "arena.hpp"
+#include "bitset.hpp"
+#include "thread.hpp"
 #include "oper.hpp"
 #include "cf.hpp"
+#include "dom.hpp"
+#include "dataflow.hpp"
 #include "dep_graph.hpp"
 #include "function.hpp"
 #include "module.hpp"
@@ -18,3 +24,9 @@
 /* Implementation of inline functionality */
 #include "oper_inline.hpp"
 #include "cf_inline.hpp"
+
+/* Reader of the printed IR */
+#include "reader.hpp"
+
+/* Binary IR */
+#include "bitcode.hpp"
@@ -56,38 +56,45 @@ Args<reg_imm_32, reg_imm_32>, Ress<reg_32>
     typedef MDes::OpType<Reg, 32, CANNOT_BE_IMM> reg_32;
 @endcode
  * Now we have enums for all possible objects, operations and we have defined feasible operands of
- * target architecture. To fill the machine description with actual objects we have to implement full
- * specialization of MDesImpl() constructor routine in some .cpp file. The objects descriptions are built
- * by the call of MDesImpl::initObjDes routine and the operation descriptions are built by the call 
- * to MDesImpl::initOperDes routine. These routines fill the objects and operation description array, 
- * statically declared within the MDesImpl template. The defintion of these templates should also be placed
- * in .cpp file. All of the above is illistrated by the following example:
+ * target architecture. The descriptions themselves are constant tables indexed by the names:
+ * MDesImpl::opers, MDesImpl::objects and MDesImpl::units. They are plain aggregates without constructors,
+ * so the client defines them in some .cpp file with brace initializers made of compile time constants.
+ * Such tables are filled by the compiler, they need no code at startup and can't be changed at run time.
+ * The operand descriptions of an operation are taken from its signature type MDesImpl::OperSig and
+ * the classes are given as a bitmask built by OperClassMask:
 @code
     //
     //Mdes implementation .cpp file
     //
+    typedef MDes::OperSig< MDes::Args<reg_imm_32, reg_imm_32>, MDes::Ress<reg_32> > AddSig;
 
-    //For more readable form of operation definition
-    #define OPER( name, str, ...) initOperDes< __VA_ARGS__>( name, str);
-    
-    //Definition of description arrays
-    template <> MDes::OperDes MDes::opers[ MDes::num_opers] = {};
-    template <> MDes::ObjDes MDes::objects[ MDes::num_objs] = {};
+    #define OP_DES( T) { T::obj_name, T::size, T::can_be_imm, T::can_be_target, T::can_be_set }
 
-    //Initialization of operation descriptions
-    template <> MDes::MDesImpl()
+    template <> const MDes::ObjDes MDes::objects[ MDes::num_objs] =
+    {
+        { INTEGER_REG, "r", 32, 0, REGISTER, true },
+        { FP_REG,      "f", 32, 0, REGISTER, true }
+    };
+
+    template <> const MDes::OperDes MDes::opers[ MDes::num_opers] =
+    {
+        { ADD, "add", AddSig::num_args, AddSig::num_ress,
+          { OP_DES( AddSig::Arg0), OP_DES( AddSig::Arg1), OP_DES( AddSig::Arg2) }, { OP_DES( AddSig::Res0) },
+          AddSig::has_arg_set, AddSig::has_res_set, OperClassMask< ALU>::mask, ALU, 1, 1 },
+        //...
+    };
+@endcode
+ * Usually the rows are generated by including the list of operations with X-macros several times.
+ * For instruction scheduling the description also has functional units. Every unit kind is given
+ * the number of units that may work in the same cycle, and every operation is given its unit, its latency
+ * and the number of cycles it keeps the unit busy. Operations without a unit have num_units there, 
+ * take 1 cycle and use no resources:
+@code
+    template <> const MDes::UnitDes MDes::units[ MDes::num_units] =
     {
-        //Objects
-        initObjDes( INTEGER_REG, "r", 32, 0, REGISTER, true);
-        initObjDes( FP_REG, "f", 32, 0, REGISTER, true);
-
-        //Operations
-        OPER( Add,  "add",  Args<reg_imm_32, reg_imm_32>, Ress<reg_32> )
-        OPER( Sub,  "sub",  Args<reg_imm_32, reg_imm_32>, Ress<reg_32> )
-        OPER( Mul,  "mul",  Args<reg_imm_32, reg_imm_32>, Ress<reg_32> )
-        OPER( Ld,   "ld",   Args<reg_imm_32>            , Ress<reg_32> )
-        OPER( St,   "st",   Args<reg_imm_32, reg_imm_32>, Ress<>       )
-    }
+        { ALU, "alu", 2 },
+        { MEM, "mem", 1 }
+    };
 @endcode
  **
  */
@@ -124,26 +131,45 @@ namespace IR
         STORAGE_CLASSES_NUM
     };
     
-    class OP_NONE
+    /** Placeholder of the missing operand in operation signature */
+    class OP_NONE{};
+
+    /** Bit of the operation class in the classes mask, -1 stands for no class */
+    template < int c> struct OperClassBit
     {
-    public:
-        static bool isNone(){return true;}
-        static void initOp( void *des){};
+        static const UInt32 bit = (UInt32)1 << c;
+    };
+
+    template <> struct OperClassBit< -1>
+    {
+        static const UInt32 bit = 0;
+    };
+
+    /** Compile time mask of the operation classes */
+    template < int c0, int c1 = -1, int c2 = -1, int c3 = -1> struct OperClassMask
+    {
+        static const UInt32 mask = OperClassBit< c0>::bit | OperClassBit< c1>::bit
+                                   | OperClassBit< c2>::bit | OperClassBit< c3>::bit;
     };
 
     template < typename Operation, typename OperName_t , typename ObjectName_t, typename OperClass_t, UInt32 num_objs_, UInt32 num_opers_,
-               UInt32 max_args_, UInt32 max_ress_, UInt32 oper_class_num> class MDesImpl
+               UInt32 max_args_, UInt32 max_ress_, UInt32 oper_class_num, typename UnitName_t, UInt32 num_units_> class MDesImpl
     {
     public:
         typedef Operation OperationType;
         typedef ObjectName_t ObjectName;
         typedef OperName_t OperName;
         typedef OperClass_t OperClass;
+        typedef UnitName_t UnitName;
 
         static const  UInt32 num_opers = num_opers_;
         static const  UInt32 num_objs = num_objs_;
+        static const  UInt32 num_units = num_units_;
         static const  UInt32 max_args = max_args_;
-        static const  UInt32 max_ress = max_args_;
+        static const  UInt32 max_ress = max_ress_;
+
+        /** Operation classes are kept in one word */
+        typedef char ClassesFitInMask[ ( oper_class_num <= 32) ? 1 : -1];
 
         /**
          * Object description structure
@@ -151,12 +177,21 @@ namespace IR
         struct ObjDes
         {
             ObjectName name;
-            string prefix;
+            const char *prefix;
             UInt32 max_size;
             UInt32 num;
+            StorageClass storage_class;
             bool can_be_virtual;
+        };
 
-            ObjDes(): name( (ObjectName)num_objs){}
+        /**
+         * Functional unit description structure
+         */
+        struct UnitDes
+        {
+            UnitName name;
+            const char *name_str;
+            UInt32 num; /**< Number of units of this kind that can be busy in the same cycle */
         };
 
         /**
@@ -170,28 +205,26 @@ namespace IR
             CanBeTarget can_be_target;
             CanBeSet can_be_set;
 
-            OpDes(){};
-
-            bool isProperName( ObjectName obj_name)
+            bool isProperName( ObjectName obj_name) const
             {
                 return name == obj_name;
             }
 
-            bool canBeImm()
+            bool canBeImm() const
             {
                 return can_be_imm == CAN_BE_IMM;
             }
 
-            bool canBeObj()
+            bool canBeObj() const
             {
                 return name != num_objs;
             }
 
-            bool canBeTarget()
+            bool canBeTarget() const
             {
                 return can_be_target == CAN_BE_TARGET;
             }
-            bool canBeSet()
+            bool canBeSet() const
             {
                 return can_be_set == CAN_BE_SET;
             }
@@ -203,118 +236,90 @@ namespace IR
         struct OperDes
         {
             OperName name;
-            string mnemonic_str;
+            const char *mnemonic_str;
             UInt32 num_args;
             UInt32 num_ress;
             OpDes args[ max_args];
             OpDes ress[ max_ress];
             bool can_have_arg_set;
             bool can_have_res_set;
-            std::bitset< oper_class_num> classes;
-
-            OperDes():
-                name( (OperName)num_opers),
-                can_have_arg_set( false), 
-                can_have_res_set( false)
-            {
-                
-            };
-
+            UInt32 classes; /**< Mask of the classes, see OperClassMask */
+            UnitName unit;  /**< Functional unit that executes the operation, num_units if none  */
+            UInt32 latency; /**< Cycles from the issue of the operation until its results are ready */
+            UInt32 busy;    /**< Cycles the unit is busy with the operation */
 
             static UInt32 maxArgs(){ return max_args;}
             static UInt32 maxRess(){ return max_ress;}
 
-            OpDes *argDes( UInt32 num)  { return (num < num_args) ? &args[ num] : NULL;}
-            OpDes *resDes( UInt32 num)  { return (num < num_ress) ? &ress[ num] : NULL;}
-            inline bool canHaveArgSet() { return can_have_arg_set;                     }
-            inline bool canHaveResSet() { return can_have_res_set;                     }
-            inline bool belongsToClass( OperClass c)
+            const OpDes *argDes( UInt32 num) const { return (num < num_args) ? &args[ num] : NULL;}
+            const OpDes *resDes( UInt32 num) const { return (num < num_ress) ? &ress[ num] : NULL;}
+            inline bool canHaveArgSet() const      { return can_have_arg_set;                     }
+            inline bool canHaveResSet() const      { return can_have_res_set;                     }
+            inline bool belongsToClass( OperClass c) const
             {
-                return classes.test( c);
-            }
-            inline void addClass( OperClass c)
-            {
-                classes.set( c);
+                return ( classes & ( (UInt32)1 << c)) != 0;
             }
+            inline bool usesUnit() const { return unit != num_units; }
         };
 
-        template <ObjectName obj_name,
-                  UInt32 size,
-                  CanBeImm can_be_imm = CANNOT_BE_IMM,
-                  CanBeTarget can_be_target = CANNOT_BE_TARGET,
-                  CanBeSet can_be_set = CANNOT_BE_SET> class OpType
+        /** Feasible operand of the operations, its properties are compile time constants */
+        template <ObjectName obj_name_,
+                  UInt32 size_,
+                  CanBeImm can_be_imm_ = CANNOT_BE_IMM,
+                  CanBeTarget can_be_target_ = CANNOT_BE_TARGET,
+                  CanBeSet can_be_set_ = CANNOT_BE_SET> class OpType
         {
         public:    
-            static bool isNone(){ return false;}
-            static UInt32 opSize(){ return size;}
-            static CanBeImm canBeImm(){ return can_be_imm;}
-            static CanBeTarget canBeTarget(){ return can_be_target;}
-            static ObjectName name(){ return obj_name;}
-            static void initOp( OpDes *obj)
-            {
-                obj->can_be_imm = can_be_imm;
-                obj->name = obj_name;
-                obj->size = size;
-                obj->can_be_target = can_be_target;
-                obj->can_be_set = can_be_set;
-            }
+            static const UInt32 is_op = 1;
+            static const ObjectName obj_name = obj_name_;
+            static const UInt32 size = size_;
+            static const CanBeImm can_be_imm = can_be_imm_;
+            static const CanBeTarget can_be_target = can_be_target_;
+            static const CanBeSet can_be_set = can_be_set_;
         };
 
-        template < bool dir,           //fake arg, prevents full specialization of template
-                   class Op1 = OP_NONE,
-                   class Op2 = OP_NONE,
-                   class Op3 = OP_NONE,
-                   class Op4 = OP_NONE> class OpsType
+        /** Description of the missing operand */
+        class NoOp
         {
         public:
-            static UInt32 numOps(){ return 0;}
-            static void initOps( OpDes *des) {}
-        };
-              
-        template <bool dir>
-        class OpsType <dir, OP_NONE, OP_NONE, OP_NONE, OP_NONE>
-        {
-        public:
-            static UInt32 numOps(){ return 0;}
-            static void initOps( OpDes *des) 
-            {
-            }
+            static const UInt32 is_op = 0;
+            static const ObjectName obj_name = (ObjectName)num_objs_;
+            static const UInt32 size = 0;
+            static const CanBeImm can_be_imm = CANNOT_BE_IMM;
+            static const CanBeTarget can_be_target = CANNOT_BE_TARGET;
+            static const CanBeSet can_be_set = CANNOT_BE_SET;
         };
 
-        template <bool dir, class Op1>
-        class OpsType <dir, Op1, OP_NONE, OP_NONE, OP_NONE>
+        /** Operand type of the signature slot */
+        template < class Op, bool dummy = true> class OpOf
         {
         public:
-            static UInt32 numOps(){ return 1;}
-            static void initOps( OpDes *des) 
-            {
-                Op1::initOp(&des[ 0]);
-            }
+            typedef Op Type;
         };
 
-        template <bool dir, class Op1, class Op2>
-        class OpsType <dir, Op1, Op2, OP_NONE, OP_NONE>
+        template < bool dummy> class OpOf< OP_NONE, dummy>
         {
         public:
-            static UInt32 numOps(){ return 2;}
-            static void initOps( OpDes *des) 
-            {
-                Op1::initOp(&des[ 0]);
-                Op2::initOp(&des[ 1]);
-            }
+            typedef NoOp Type;
         };
 
-        template <bool dir, class Op1, class Op2, class Op3>
-        class OpsType <dir, Op1, Op2, Op3, OP_NONE>
+        template < bool dir,           //fake arg, prevents full specialization of template
+                   class Op1 = OP_NONE,
+                   class Op2 = OP_NONE,
+                   class Op3 = OP_NONE,
+                   class Op4 = OP_NONE> class OpsType
         {
         public:
-            static UInt32 numOps(){ return 3;}
-            static void initOps( OpDes *des) 
-            {
-                Op1::initOp(&des[ 0]);
-                Op2::initOp(&des[ 1]);
-                Op3::initOp(&des[ 2]);
-            }
+            typedef typename OpOf< Op1>::Type Op0Type;
+            typedef typename OpOf< Op2>::Type Op1Type;
+            typedef typename OpOf< Op3>::Type Op2Type;
+            typedef typename OpOf< Op4>::Type Op3Type;
+
+            static const UInt32 num_ops = Op0Type::is_op + Op1Type::is_op + Op2Type::is_op + Op3Type::is_op;
+            static const bool has_set = Op0Type::can_be_set == CAN_BE_SET
+                                        || Op1Type::can_be_set == CAN_BE_SET
+                                        || Op2Type::can_be_set == CAN_BE_SET
+                                        || Op3Type::can_be_set == CAN_BE_SET;
         };
 
         template < class Op1 = OP_NONE,
@@ -329,89 +334,67 @@ namespace IR
                    class Op4 = OP_NONE> 
         class Ress: public OpsType< true, Op1, Op2, Op3, Op4>    {};
 
-        /** Constructor */
-        inline MDesImpl(){};
+        /** Signature of operation, the constants of its operands fill the operation's description */
+        template < class ArgsType, class RessType> class OperSig
+        {
+        public:
+            typedef typename ArgsType::Op0Type Arg0;
+            typedef typename ArgsType::Op1Type Arg1;
+            typedef typename ArgsType::Op2Type Arg2;
+            typedef typename ArgsType::Op3Type Arg3;
+            typedef typename RessType::Op0Type Res0;
+            typedef typename RessType::Op1Type Res1;
+            typedef typename RessType::Op2Type Res2;
+            typedef typename RessType::Op3Type Res3;
+
+            static const UInt32 num_args = ArgsType::num_ops;
+            static const UInt32 num_ress = RessType::num_ops;
+            static const bool has_arg_set = ArgsType::has_set;
+            static const bool has_res_set = RessType::has_set;
+        };
 
         /**
          * Check that name is valid for this MDes and operation's
-         * description structure is properly initialized
+         * description is in its place in the table
          */
         static bool checkName( OperName name)
         {
             IR_ASSERTD( name < num_opers);
-            IR_ASSERTXD( opers[ name].name != num_opers, "Operation description is not initialized");
+            IR_ASSERTXD( opers[ name].name == name, "Operation description is out of place");
             return name < num_opers
-                   && opers[ name].name != num_opers;
+                   && opers[ name].name == name;
         }
 
 
         /** Accessor of operation description */
-        static OperDes *operDescription( OperName name)
+        static const OperDes *operDescription( OperName name)
         {
             IR_ASSERTD( name < num_opers);
 
-            IR_ASSERTXD( opers[ name].name != num_opers, "Operation description is not initialized");
+            IR_ASSERTXD( opers[ name].name == name, "Operation description is out of place");
             return &opers[ name];
         }
         /** Accessor of operation description */
-        static ObjDes *objectDescription( ObjectName name)
+        static const ObjDes *objectDescription( ObjectName name)
         {
             IR_ASSERTD( name < num_objs);
 
-            IR_ASSERTXD( objects[ name].name != num_objs, "Object description is not initialized");
+            IR_ASSERTXD( objects[ name].name == name, "Object description is out of place");
             return &objects[ name];
         }
 
-        /** Operation initializer routine */
-        template <class ArgsType, class RessType>
-        void
-        initOperDes( OperName name, string str)
+        /** Accessor of functional unit description */
+        static const UnitDes *unitDescription( UnitName name)
         {
-            OperDes * des = &opers[ name];
-            des->name = name;
-            des->mnemonic_str = str;
-            des->num_args = ArgsType::numOps();
-            des->num_ress = RessType::numOps();
-
-            IR_ASSERTD( des->num_args <= OperDes::maxArgs() );
-            IR_ASSERTD( des->num_ress <= OperDes::maxRess() );
-
-            ArgsType::initOps( des->args);
-            RessType::initOps( des->ress);
+            IR_ASSERTD( name < num_units);
 
-            for ( UInt32 arg = 0; arg < des->num_args; arg++)
-            {
-                if ( des->argDes( arg)->canBeSet())
-                    des->can_have_arg_set = true;
-            }
-            for ( UInt32 res = 0; res < des->num_ress; res++)
-            {
-                if ( des->resDes( res)->canBeSet())
-                    des->can_have_res_set = true;
-            }
-        }
-
-        void initOperClasses( OperName name, int num_classes, OperClass *classes)
-        {
-            for ( int i = 0; i < num_classes; ++i)
-            {
-                opers[name].addClass( classes[ i]);
-            }
-        }
-
-        void
-        initObjDes( ObjectName name, string str, UInt32 max_size, UInt32 num, StorageClass stor_class, bool can_be_virtual)
-        {
-            ObjDes * des = &objects[ name];
-            des->name = name;
-            des->prefix = str;
-            des->max_size = max_size;
-            des->num = num;
-            des->can_be_virtual = can_be_virtual;
+            IR_ASSERTXD( units[ name].name == name, "Unit description is out of place");
+            return &units[ name];
         }
 
     private:    
-        static OperDes opers[ num_opers];
-        static ObjDes objects[ num_objs];
+        static const OperDes opers[ num_opers];
+        static const ObjDes objects[ num_objs];
+        static const UnitDes units[ num_units];
     }; /* MDes definition */
 };
\ No newline at end of file
@@ -25,21 +25,31 @@ namespace IR
         
         inline Func * newFunction();                   /**< Create a new function */
         inline Func * newFunction( string name);       /**< Create a new named function */
-        inline Func * findFunctionByName( string name);/**< Find function by its name string */
+        inline Func * findFunctionByName( const string &name);            /**< Find function by its name string */
+        inline Func * findFunctionByName( const char *chars, UInt32 len); /**< Find function by its name characters */
+        inline Func * findFunction( Symbol name);                         /**< Find function by its name symbol */
         inline void removeFunction( Func *f);          /**< Remove function from the module */
+        inline Func * firstFunction() const;           /**< Get the first function of the module's list */
         
         /** Find function with the given name, rename it and adjust the symbol table */
-        inline void renameFunction( string name, string new_name); 
+        inline void renameFunction( const string &name, const string &new_name); 
         /** Change function name and adjust the symbol table */
-        inline void renameFunction( Func *f, string new_name);
+        inline void renameFunction( Func *f, const string &new_name);
+
+        /** Get the symbol table of the module */
+        inline SymbolTable &symbols();
+        /** Get the symbol table of the module */
+        inline const SymbolTable &symbols() const;
 
         /** Print module to stream */
         inline void toStream(ostream& os);
     private:
+        /** Symbols of the module */
+        SymbolTable symtab;
         /** Pointer to the first function */
         Func* first_function;
-        /** Functions map */
-        map< string, Func *> func_table;
+        /** Functions indexed by the ids of their name symbols */
+        vector< Func *> func_table;
         
         /** Next function id */
         UInt32 f_id;
@@ -71,14 +81,21 @@ namespace IR
     Function<MDesType> *
     Module<MDesType>::newFunction( string name)
     {
-        Function<MDesType> *f = new Function<MDesType>( this, name); // Create the new function 
+        Symbol sym = symtab.intern( name);
+        IR_ASSERTXD( isNullP( findFunction( sym)), "Function with the given name already exists");
+
+        Function<MDesType> *f = new Function<MDesType>( this, sym); // Create the new function 
         
         // Function list bookkeeping
         f->attach( first_function);
         first_function = f;
         
         // Symbol table mangement
-        func_table[ name] = f;
+        if ( func_table.size() <= sym.id() )
+        {
+            func_table.resize( symtab.numSymbols(), NULL);
+        }
+        func_table[ sym.id()] = f;
 
         return f;
     }
@@ -98,13 +115,32 @@ namespace IR
         return newFunction( name);
     }
 
+    /** Find function by its name symbol */
+    template <class MDesType>
+    Function<MDesType> *
+    Module<MDesType>::findFunction( Symbol name)
+    {
+        if ( !name.isValid() || name.id() >= func_table.size() )
+        {
+            return NULL;
+        }
+        return func_table[ name.id()];
+    }
+
+    /** Find function by its name characters, no string is created for the lookup */
+    template <class MDesType>
+    Function<MDesType> *
+    Module<MDesType>::findFunctionByName( const char *chars, UInt32 len)
+    {
+        return findFunction( symtab.find( chars, len));
+    }
+
     /** Find function by its name string */
     template <class MDesType>
     Function<MDesType> *
-    Module<MDesType>::findFunctionByName( string name)
+    Module<MDesType>::findFunctionByName( const string &name)
     {
-        IR_ASSERTXD( 0, "Not implemented");
-        return NULL;
+        return findFunction( symtab.find( name));
     }
 
     /** Remove function from the module */
@@ -112,33 +148,86 @@ namespace IR
     void
     Module<MDesType>::removeFunction( Func *f)
     {
+        IR_ASSERTD( areEqP( f->module(), this) );
+
         /** Replace first function if needed */
         if ( f == first_function)
         {
             first_function = f->next();
         }
-        typename map< string, Func *>::iterator it = func_table.find( f->name);
-        if ( it != func_table.end() )
+        f->detach();
+        Symbol sym = f->nameSym();
+        if ( areEqP( findFunction( sym), f) )
         {
-            func_table.erase( it);
+            func_table[ sym.id()] = NULL;
         }
         delete f;
     }
         
+    /** Get the first function of the module's list, the last created function goes first */
+    template <class MDesType>
+    Function<MDesType> *
+    Module<MDesType>::firstFunction() const
+    {
+        return first_function;
+    }
+
     /** Find function with the given name, rename it and adjust the symbol table */
     template <class MDesType>
     void
-    Module<MDesType>::renameFunction( string name, string new_name)
+    Module<MDesType>::renameFunction( const string &name, const string &new_name)
     {
-        IR_ASSERTXD( 0, "Not implemented");
+        Func *f = findFunctionByName( name);
+
+        IR_ASSERTXD( isNotNullP( f), "No function with the given name");
+        renameFunction( f, new_name);
     }
     
     /** Change function name and adjust the symbol table */
     template <class MDesType>
     void
-    Module<MDesType>::renameFunction( Func *f, string new_name)
+    Module<MDesType>::renameFunction( Func *f, const string &new_name)
+    {
+        IR_ASSERTD( areEqP( f->module(), this) );
+
+        Symbol sym = f->nameSym();
+        Symbol new_sym = symtab.intern( new_name);
+
+        if ( sym == new_sym)
+        {
+            return;
+        }
+        IR_ASSERTXD( isNullP( findFunction( new_sym)), "Function with the new name already exists");
+
+        /* Release the old name */
+        if ( areEqP( findFunction( sym), f) )
+        {
+            func_table[ sym.id()] = NULL;
+        }
+
+        /* Take the new one */
+        f->setName( new_name);
+        if ( func_table.size() <= new_sym.id() )
+        {
+            func_table.resize( symtab.numSymbols(), NULL);
+        }
+        func_table[ new_sym.id()] = f;
+    }
+
+    /** Get the symbol table of the module */
+    template <class MDesType>
+    SymbolTable &
+    Module<MDesType>::symbols()
+    {
+        return symtab;
+    }
+
+    /** Get the symbol table of the module */
+    template <class MDesType>
+    const SymbolTable &
+    Module<MDesType>::symbols() const
     {
-        IR_ASSERTXD( 0, "Not implemented");
+        return symtab;
     }
 
     /** Output module to stream */
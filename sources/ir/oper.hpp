@@ -8,15 +8,71 @@
 namespace IR
 {
 
+/**
+ * @brief Reference from an object to the operand that holds it
+ * @ingroup IR
+ */
+template <class MDesType> struct Use
+{
+    Operation< MDesType> *oper; /**< Operation of the operand */
+    Operand< MDesType> *op;     /**< Operand that holds the object */
+};
+
+/**
+ * @class UseList
+ * @brief Array of the references to the operands that hold an object
+ *
+ * The array is kept in the blocks of the function's arena, so the list needs no destruction.
+ * The removed reference is replaced by the last one, the order of references is not kept
+ * @ingroup IR
+ */
+template <class MDesType> class UseList
+{
+public:
+    typedef Use< MDesType> *iterator;             /**< Iterator over the references */
+    typedef const Use< MDesType> *const_iterator; /**< Iterator over the references */
+
+    inline UseList();
+
+    inline UInt32 size() const; /**< Get number of references */
+    inline bool empty() const;  /**< Check that there are no references */
+
+    inline Use< MDesType> &operator[]( UInt32 i);             /**< Get i-th reference   */
+    inline const Use< MDesType> &operator[]( UInt32 i) const; /**< Get i-th reference   */
+    inline Use< MDesType> &back();                            /**< Get the last reference */
+    inline const Use< MDesType> &back() const;                /**< Get the last reference */
+
+    inline iterator begin();             /**< Get iterator pointing to the first reference */
+    inline iterator end();               /**< Get iterator pointing past the last reference */
+    inline const_iterator begin() const; /**< Get iterator pointing to the first reference */
+    inline const_iterator end() const;   /**< Get iterator pointing past the last reference */
+
+    /** Add reference to the end, the array grows in the given arena */
+    inline void push_back( const Use< MDesType> &use, Arena &arena);
+    inline void pop_back(); /**< Remove the last reference */
+    inline void clear();    /**< Remove all references, the memory is kept */
+private:
+    Use< MDesType> *refs;
+    UInt32 num;
+    UInt32 capacity;
+};
+
 /**
  * @class Object
  * @brief Representation of an object
+ *
+ * Object keeps the lists of operands that use and define it. The lists are updated
+ * by the operations when operand objects are set, so they are always in sync with the operations.
+ * Objects are created by the function in its arena and are released along with it without destruction
  * @ingroup IR
  */
 template <class MDesType> class Object
 {
 public:
     typedef typename MDesType::ObjectName ObjectName;
+
+    /** Type of the list of object's uses or definitions */
+    typedef IR::UseList< MDesType> UseList;
         
     /** Set virtual flag to object */
     inline void setVirtual( bool is_virtual); 
@@ -39,22 +95,37 @@ public:
 
     /** Print object to stream */
     inline void toStream(ostream& os) const;
+
+    inline const UseList &uses() const; /**< Get the argument operands that hold the object */
+    inline const UseList &defs() const; /**< Get the result operands that hold the object   */
+    inline UInt32 numUses() const;      /**< Get number of uses of the object        */
+    inline UInt32 numDefs() const;      /**< Get number of definitions of the object */
+
+    /** Make all the argument operands that hold this object hold the given one instead */
+    inline void replaceAllUsesWith( Object< MDesType> *obj);
+
+    /** Add operand to the object's uses or definitions */
+    inline void addRef( OpDir dir, Operation< MDesType> *oper, Operand< MDesType> *op);
+    /** Remove operand from the object's uses or definitions */
+    inline void removeRef( OpDir dir, Operand< MDesType> *op);
+    /** Update the reference of the operand that was moved to the new place */
+    inline void moveRef( OpDir dir, Operand< MDesType> *op);
 private:
     ObjectName type_;
     bool is_virtual;
     UInt32 id_;
+    UseList refs[ OPERAND_DIRS_NUM]; /**< Uses and definitions of the object */
 };
 
-/** Tag type for list */
-template <class MDesType> class OperandList{};
-
 /**
  * @class Operand
  * @brief Representation of Operand
+ *
+ * The operand is a tagged union of object, immediate constant and target operation
+ * that takes 16 bytes. Symbolic constants are kept as symbols of the module's symbol table
  * @ingroup IR
  */
-template <class MDesType> class Operand: 
-    public ListItem< Operand< MDesType> >
+template <class MDesType> class Operand
 {
 public:
     /** Set object to operand */
@@ -81,6 +152,11 @@ public:
     inline Operation< MDesType> * target() const;
     /** Return type of operand */
     inline OperandType type() const;
+
+    /** Return index of the operand in its object's list of uses or definitions */
+    inline UInt32 refIndex() const;
+    /** Set index of the operand in its object's list of uses or definitions */
+    inline void setRefIndex( UInt32 index);
     
     /** Check that operand is target */
     inline bool isTarget() const { return type() == OP_TYPE_TARGET;};
@@ -90,15 +166,55 @@ public:
     /** Destructor */
     inline ~Operand();
 
-    /** Print operand to stream */
-    inline void toStream(ostream& os) const;
+    /** Print operand to stream, symbols are printed as strings if the table is given */
+    inline void toStream(ostream& os, const SymbolTable *symtab = NULL) const;
+private:
+    /** Operand value, the member in use is defined by the operand type */
+    union OperandData
+    {
+        Object< MDesType> *obj;      /**< Object of OP_TYPE_OBJ operand        */
+        Operation< MDesType> *target;/**< Target of OP_TYPE_TARGET operand     */
+        Int64 int_val;               /**< Integer value of OP_TYPE_IMM operand */
+        Double d_val;                /**< Float value of OP_TYPE_IMM operand   */
+        UInt32 sym_id;               /**< Symbol of OP_TYPE_IMM operand        */
+    } data;
+    UInt8 type_;       /**< Operand type, OperandType value  */
+    UInt8 const_type;  /**< Type of immediate, ConstType value */
+    bool is_implicit;  /**< Implicit operand flag */
+    UInt32 ref_index;  /**< Index in the object's list of uses or definitions */
+};
+
+/** Number of set operands kept in the operation's block, larger sets go to the function's arena */
+const UInt32 OPERAND_SET_INLINE_NUM = 2;
+
+/**
+ * @class OperandSet
+ * @brief Argument or result set of operation
+ *
+ * The operands of the set are kept in one array. Small sets fit into the inline buffer, larger ones
+ * are moved into the arrays from the function's arena. The set is ordered from the last
+ * added operand to the first one. The set lives in the operands' block of its operation
+ * and is managed by it
+ * @ingroup IR
+ */
+template <class MDesType> class OperandSet
+{
+public:
+    inline OperandSet();
+
+    inline UInt32 num() const;                        /**< Get number of operands in the set   */
+    inline UInt32 capacity() const;                   /**< Get number of operands that fit     */
+    inline bool isInline() const;                     /**< Check that operands are in the inline buffer */
+    inline Operand< MDesType> &operator[]( UInt32 i); /**< Get i-th operand in the set order   */
+    inline const Operand< MDesType> &operator[]( UInt32 i) const; /**< Get i-th operand in the set order */
+    inline Operand< MDesType> *data();                /**< Get the array of operands in the order of addition */
 private:
-    Object< MDesType> * obj;
-    //DF* df_;
-    bool is_implicit : 1;
-    Const i_value;
-    OperandType type_;
-    Operation< MDesType> *target_;
+    friend class Operation< MDesType>;
+
+    Operand< MDesType> *ops; /**< Array from the arena, NULL while the operands are inline */
+    UInt32 num_;
+    UInt32 capacity_;
+    Operand< MDesType> inline_ops[ OPERAND_SET_INLINE_NUM];
 };
 
 /** Tag type for list */
@@ -156,14 +272,17 @@ public:
     /** Set result's object */
     inline void setResObj( UInt32 res_num, Object< MDesType> *obj);
 
-    /** Set name of operation */
+    /**
+     * Set name of operation. The operands are allocated according to the operation's description,
+     * if the new name has another number of operands the old operands are dropped
+     */
     inline void setName( OperName nm);
 
     /** Print operation to stream */
     inline void toStream(ostream& os) const;
 
     /** Get the mnemonic string of the operation */
-    inline string & nameStr() const;
+    inline const char *nameStr() const;
 
     /** Detach from operation sequence */
     inline void detachFromSeq();
@@ -187,38 +306,66 @@ public:
     /* Add an result to set, only objects can be in results set */
     inline const Operand< MDesType> * addResToSet( Object< MDesType> *obj); /**< Add object result */
 
-    /** Get first argument operand in argument set */
-    inline Operand< MDesType> * firstArgInSet() const;
-    
-    /** Get first result in result set */
-    inline Operand< MDesType> * firstResInSet() const;
+    inline UInt32 numArgsInSet() const; /**< Get number of operands in argument set */
+    inline UInt32 numRessInSet() const; /**< Get number of operands in result set   */
+
+    /** Get argument from the set, the last added argument has number 0 */
+    inline const Operand< MDesType> &argInSet( UInt32 i) const;
+    /** Get result from the set, the last added result has number 0 */
+    inline const Operand< MDesType> &resInSet( UInt32 i) const;
+
+    /** Set object of the argument from the set */
+    inline void setArgObjInSet( UInt32 i, Object< MDesType> *obj);
+    /** Set object of the result from the set */
+    inline void setResObjInSet( UInt32 i, Object< MDesType> *obj);
 
     inline CFNode< MDesType> * node() const;    /**< Get the control flow node of the operation */
     inline void setNode( CFNode< MDesType> *n); /**< Set the control flow node of the operation */
 
     inline bool isLastInNode() const;  /**< Check if the operation is last in its CF node  */
+    inline Operation< MDesType> *nextInNode() const; /**< Next operation of the CF node, NULL for the last one */
     inline bool isFirstInNode() const; /**< Check if the operation is first in its CF node */
 
-    inline typename MDesType::OperDes *archDes();
+    /** Get the description of the operation from MDes */
+    inline const typename MDesType::OperDes *archDes() const;
     
 private:
-    /* Arrays of operands */
-    Operand<MDesType> args[ MDesType::max_args]; /**< Array of argument operands */
-    Operand<MDesType> ress[ MDesType::max_ress]; /**< Array of result operands   */
-    
-    /* 
-     * Argument and result sets of arbitrary length (e.g. in operations like call)
-     * are implemented as the lists of operands. Memory is still controlled by the operation.
+    /**
+     * Arguments followed by results and then by the argument and the result sets (e.g. in operations
+     * like call) if MDes allows them for the operation's name. The block is sized for the name
+     * and is allocated in the function's arena. Operations without operands have no block
      */
-    Operand<MDesType> *first_arg; /**< First argument in set */
-    Operand<MDesType> *first_res; /**< First result in set   */
+    Operand<MDesType> *ops;
 
     OperName name_; /**< Operation name */
 
     CFNode< MDesType> * node_; /**< Control flow node of the operation */
 
-    /** Print operand list to stream */
-    inline void opListToStream(ostream& os, Operand< MDesType>* op) const;
+    inline Operand< MDesType> &argOp( UInt32 i); /**< Get argument operand for change */
+    inline Operand< MDesType> &resOp( UInt32 i); /**< Get result operand for change   */
+
+    /** Get size of the operands' block for the operation's description */
+    static inline UInt32 blockSize( const typename MDesType::OperDes *des);
+
+    inline OperandSet< MDesType> *argSet() const; /**< Get argument set, NULL if the operation can't have it */
+    inline OperandSet< MDesType> *resSet() const; /**< Get result set, NULL if the operation can't have it   */
+
+    /** Remove the operands from the objects' lists and return the block to the function's arena */
+    inline void freeOperands();
+
+    /** Remove the set's operands from the objects' lists and return a large set's array to the arena */
+    inline void freeSet( OperandSet< MDesType> *set, OpDir dir);
+
+    /** Print operand set to stream */
+    inline void opListToStream(ostream& os, const OperandSet< MDesType> &set, const SymbolTable *symtab) const;
+
+    /** Add operand to the end of the set, the set grows into the function's arena if needed */
+    inline Operand< MDesType> *newSetOperand( OperandSet< MDesType> &set, OpDir dir);
+
+    /** Make the operand hold the given object and register it in the object's uses or definitions */
+    inline void linkOperand( Operand< MDesType> *op, OpDir dir, Object< MDesType> *obj);
+    /** Remove the operand from the lists of its object if it holds one */
+    inline void unlinkOperand( Operand< MDesType> *op, OpDir dir);
 };
 
 template <class MDesType> 
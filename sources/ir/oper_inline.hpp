@@ -8,8 +8,8 @@
 namespace IR
 {
     
-template <class MDesType> typename MDesType::OperDes *
-Operation<MDesType>::archDes()
+template <class MDesType> const typename MDesType::OperDes *
+Operation<MDesType>::archDes() const
 {
     return MDesType::operDescription( name());
 }
@@ -54,17 +54,222 @@ Object<MDesType>::~Object()
 template <class MDesType> void
 Object<MDesType>::toStream(ostream& os) const
 {
-    typename MDesType::ObjDes *des = MDesType::objectDescription( type());
+    const typename MDesType::ObjDes *des = MDesType::objectDescription( type());
     
     if ( isVirtual() )
         os << 'v';
     os << des->prefix << id();    
 }
 
+/** Create empty list */
+template <class MDesType>
+UseList<MDesType>::UseList(): refs( NULL), num( 0), capacity( 0)
+{
+
+}
+
+/** Get number of references */
+template <class MDesType> UInt32
+UseList<MDesType>::size() const
+{
+    return num;
+}
+
+/** Check that there are no references */
+template <class MDesType> bool
+UseList<MDesType>::empty() const
+{
+    return num == 0;
+}
+
+/** Get i-th reference */
+template <class MDesType> Use< MDesType> &
+UseList<MDesType>::operator[]( UInt32 i)
+{
+    IR_ASSERTD( i < num);
+    return refs[ i];
+}
+
+/** Get i-th reference */
+template <class MDesType> const Use< MDesType> &
+UseList<MDesType>::operator[]( UInt32 i) const
+{
+    IR_ASSERTD( i < num);
+    return refs[ i];
+}
+
+/** Get the last reference */
+template <class MDesType> Use< MDesType> &
+UseList<MDesType>::back()
+{
+    IR_ASSERTD( num > 0);
+    return refs[ num - 1];
+}
+
+/** Get the last reference */
+template <class MDesType> const Use< MDesType> &
+UseList<MDesType>::back() const
+{
+    IR_ASSERTD( num > 0);
+    return refs[ num - 1];
+}
+
+/** Get iterator pointing to the first reference */
+template <class MDesType> typename UseList<MDesType>::iterator
+UseList<MDesType>::begin()
+{
+    return refs;
+}
+
+/** Get iterator pointing past the last reference */
+template <class MDesType> typename UseList<MDesType>::iterator
+UseList<MDesType>::end()
+{
+    return refs + num;
+}
+
+/** Get iterator pointing to the first reference */
+template <class MDesType> typename UseList<MDesType>::const_iterator
+UseList<MDesType>::begin() const
+{
+    return refs;
+}
+
+/** Get iterator pointing past the last reference */
+template <class MDesType> typename UseList<MDesType>::const_iterator
+UseList<MDesType>::end() const
+{
+    return refs + num;
+}
+
+/** Add reference to the end, the array doubles in the given arena when it is full */
+template <class MDesType> void
+UseList<MDesType>::push_back( const Use< MDesType> &use, Arena &arena)
+{
+    if ( num == capacity)
+    {
+        UInt32 new_capacity = ( capacity == 0) ? 2 : 2 * capacity;
+        Use< MDesType> *new_refs =
+            static_cast< Use< MDesType> *>( arena.allocateArray( new_capacity * sizeof( Use< MDesType>)));
+
+        for ( UInt32 i = 0; i < num; i++)
+        {
+            new_refs[ i] = refs[ i];
+        }
+        if ( isNotNullP( refs) )
+        {
+            arena.deallocateArray( refs, capacity * sizeof( Use< MDesType>));
+        }
+        refs = new_refs;
+        capacity = new_capacity;
+    }
+    refs[ num++] = use;
+}
+
+/** Remove the last reference */
+template <class MDesType> void
+UseList<MDesType>::pop_back()
+{
+    IR_ASSERTD( num > 0);
+    num--;
+}
+
+/** Remove all references, the memory is kept */
+template <class MDesType> void
+UseList<MDesType>::clear()
+{
+    num = 0;
+}
+
+/** Get the argument operands that hold the object */
+template <class MDesType> 
+const typename Object<MDesType>::UseList &
+Object<MDesType>::uses() const
+{
+    return refs[ OPERAND_DIR_USE];
+}
+
+/** Get the result operands that hold the object */
+template <class MDesType> 
+const typename Object<MDesType>::UseList &
+Object<MDesType>::defs() const
+{
+    return refs[ OPERAND_DIR_DEF];
+}
+
+/** Get number of uses of the object */
+template <class MDesType> UInt32
+Object<MDesType>::numUses() const
+{
+    return refs[ OPERAND_DIR_USE].size();
+}
+
+/** Get number of definitions of the object */
+template <class MDesType> UInt32
+Object<MDesType>::numDefs() const
+{
+    return refs[ OPERAND_DIR_DEF].size();
+}
+
+/** Add operand to the object's uses or definitions */
+template <class MDesType> void
+Object<MDesType>::addRef( OpDir dir, Operation< MDesType> *oper, Operand< MDesType> *op)
+{
+    Use< MDesType> use;
+
+    use.oper = oper;
+    use.op = op;
+    op->setRefIndex( refs[ dir].size());
+    refs[ dir].push_back( use, oper->function()->arena());
+}
+
+/** Remove operand from the object's uses or definitions, the last reference takes its place */
+template <class MDesType> void
+Object<MDesType>::removeRef( OpDir dir, Operand< MDesType> *op)
+{
+    UseList &list = refs[ dir];
+    UInt32 i = op->refIndex();
+
+    IR_ASSERTD( i < list.size() && areEqP( list[ i].op, op) );
+    list[ i] = list.back();
+    list[ i].op->setRefIndex( i);
+    list.pop_back();
+}
+
+/** Update the reference of the operand that was moved to the new place */
+template <class MDesType> void
+Object<MDesType>::moveRef( OpDir dir, Operand< MDesType> *op)
+{
+    IR_ASSERTD( op->refIndex() < refs[ dir].size());
+    refs[ dir][ op->refIndex()].op = op;
+}
+
+/**
+ * Make all the argument operands that hold this object hold the given one instead.
+ * Takes time proportional to the number of uses
+ */
+template <class MDesType> void
+Object<MDesType>::replaceAllUsesWith( Object< MDesType> *obj)
+{
+    IR_ASSERTD( isNotNullP( obj));
+    
+    if ( areEqP( obj, this) )
+        return;
+
+    UseList &list = refs[ OPERAND_DIR_USE];
+
+    for ( typename UseList::iterator it = list.begin(), end = list.end(); it != end; ++it)
+    {
+        it->op->setObject( obj);
+        obj->addRef( OPERAND_DIR_USE, it->oper, it->op);
+    }
+    list.clear();
+}
+
 template <class MDesType> void 
 Operand<MDesType>::setObject( Object<MDesType>* obj)
 {
-    this->obj = obj;
+    data.obj = obj;
 }
 
 template <class MDesType> void 
@@ -76,20 +281,35 @@ Operand<MDesType>::setImplicit( bool is_implicit)
 template <class MDesType> void 
 Operand<MDesType>::setConstValue( Const i_value)
 {
-    this->i_value = i_value;
+    const_type = (UInt8)i_value.type();
+    switch ( i_value.type())
+    {
+        case CONST_TYPE_INTEGER:
+            data.int_val = i_value.intVal();
+            break;
+        case CONST_TYPE_FLOAT:
+            data.d_val = i_value.floatVal();
+            break;
+        case CONST_TYPE_SYMBOL:
+            data.sym_id = i_value.symVal().id();
+            break;
+        default:
+            IR_ASSERTD( 0);
+    }
 }
 
 template <class MDesType> void 
 Operand<MDesType>::setType( OperandType type)
 {
-    this->type_ = type;
+    this->type_ = (UInt8)type;
 }
 
 template <class MDesType> 
 Object<MDesType> *
 Operand<MDesType>::object() const
 {
-    return obj;
+    IR_ASSERTD( type() == OP_TYPE_OBJ);
+    return data.obj;
 }
 
 template <class MDesType> bool 
@@ -101,33 +321,58 @@ Operand<MDesType>::isImplicit() const
 template <class MDesType> Const 
 Operand<MDesType>::constValue() const
 {
-    return i_value;
+    IR_ASSERTD( type() == OP_TYPE_IMM);
+    switch ( const_type)
+    {
+        case CONST_TYPE_FLOAT:
+            return Const( data.d_val);
+        case CONST_TYPE_SYMBOL:
+            return Const( Symbol( data.sym_id));
+        default:
+            IR_ASSERTD( const_type == CONST_TYPE_INTEGER);
+            return Const( data.int_val);
+    }
 }
 
 template <class MDesType>
 Operation< MDesType> *
 Operand<MDesType>::target() const
 {
-    return target_;
+    IR_ASSERTD( type() == OP_TYPE_TARGET);
+    return data.target;
 }
 
 template <class MDesType>
 void
 Operand<MDesType>::setTarget( Operation< MDesType> *target_oper)
 {
-    target_ = target_oper;
+    data.target = target_oper;
 }
 
 template <class MDesType> OperandType
 Operand<MDesType>::type() const
 {
-    return type_;
+    return (OperandType)type_;
+}
+
+/** Return index of the operand in its object's list of uses or definitions */
+template <class MDesType> UInt32
+Operand<MDesType>::refIndex() const
+{
+    return ref_index;
+}
+
+/** Set index of the operand in its object's list of uses or definitions */
+template <class MDesType> void
+Operand<MDesType>::setRefIndex( UInt32 index)
+{
+    ref_index = index;
 }
 
 template <class MDesType> 
-Operand<MDesType>::Operand(): target_( NULL), i_value( (Int64)0) 
+Operand<MDesType>::Operand(): const_type( CONST_TYPE_INTEGER), ref_index( 0)
 {
-    setObject( NULL);
+    data.int_val = 0;
     setImplicit( false);
     setType( OP_TYPES_NUM);
 }
@@ -139,7 +384,7 @@ Operand<MDesType>::~Operand()
 }
 
 template <class MDesType> void
-Operand<MDesType>::toStream(ostream& os) const
+Operand<MDesType>::toStream(ostream& os, const SymbolTable *symtab) const
 {
     switch ( type() )
     {
@@ -150,7 +395,7 @@ Operand<MDesType>::toStream(ostream& os) const
             break;
         }
         case OP_TYPE_IMM:
-            os << constValue(); 
+            constValue().toStream( os, symtab);
             break;
         case OP_TYPE_TARGET:
         {
@@ -186,7 +431,7 @@ const Operand<MDesName>&
 Operation<MDesName>::arg( unsigned i) const
 {
     IR_ASSERTXD( i < numArgs(), "Invalid argument number");
-    return args[ i];
+    return ops[ i];
 }
 
 template <class MDesName> 
@@ -194,7 +439,7 @@ const Operand<MDesName>&
 Operation<MDesName>::res( unsigned i) const
 {
     IR_ASSERTXD( i < numRess(), "Invalid result number");
-    return ress[ i];
+    return ops[ numArgs() + i];
 }
 
 /** Set type of object */
@@ -211,18 +456,15 @@ Operation<MDesType>::setArgObj( UInt32 arg_num, Object< MDesType> *obj)
     IR_ASSERTD( arg_num < numArgs());
     
     /** Check that given operand can actually hold object according to MDes */
-    typename MDesType::OperDes *des = MDesType::operDescription( name());
-    typename MDesType::OpDes *op_des = des->argDes( arg_num);
+    const typename MDesType::OperDes *des = MDesType::operDescription( name());
+    const typename MDesType::OpDes *op_des = des->argDes( arg_num);
 
     IR_ASSERTD( isNotNullP( op_des));
     IR_ASSERTD( op_des->isProperName( obj->type()) );
-    IR_ASSERTD( args[ arg_num].type() != OP_TYPE_TARGET);
+    IR_ASSERTD( argOp( arg_num).type() != OP_TYPE_TARGET);
 
-    /** Set proper operand type */
-    args[ arg_num].setType( OP_TYPE_OBJ);
-
-    /** Set operand object */
-    args[ arg_num].setObject( obj);
+    /** Set operand type and object, the operand becomes a use of the object */
+    linkOperand( &argOp( arg_num), OPERAND_DIR_USE, obj);
 }
 
 /** Set operation's argument object */
@@ -232,17 +474,18 @@ Operation<MDesType>::setArgTarget( UInt32 arg_num, Operation<MDesType> *target)
     IR_ASSERTD( arg_num < numArgs());
     
     /** Check that given operand can actually hold object according to MDes */
-    typename MDesType::OperDes *des = MDesType::operDescription( name());
-    typename MDesType::OpDes *op_des = des->argDes( arg_num);
+    const typename MDesType::OperDes *des = MDesType::operDescription( name());
+    const typename MDesType::OpDes *op_des = des->argDes( arg_num);
 
     IR_ASSERTD( isNotNullP( op_des));
     IR_ASSERTD( op_des->canBeTarget() );
 
     /** Set proper operand type */
-    args[ arg_num].setType( OP_TYPE_TARGET);
+    unlinkOperand( &argOp( arg_num), OPERAND_DIR_USE);
+    argOp( arg_num).setType( OP_TYPE_TARGET);
 
     /** Set operand object */
-    args[ arg_num].setTarget( target);
+    argOp( arg_num).setTarget( target);
 
 }
 
@@ -253,18 +496,19 @@ Operation<MDesType>::setArgImm( UInt32 arg_num, Const imm_val)
     IR_ASSERTD( arg_num < numArgs());
     
     /** Check that given operand can actually be immediate according to MDes */
-    typename MDesType::OperDes *des = MDesType::operDescription( name());
-    typename MDesType::OpDes *op_des = des->argDes( arg_num);
+    const typename MDesType::OperDes *des = MDesType::operDescription( name());
+    const typename MDesType::OpDes *op_des = des->argDes( arg_num);
 
     IR_ASSERTD( isNotNullP( op_des));
     IR_ASSERTD( op_des->canBeImm() );
-    IR_ASSERTD( args[ arg_num].type() != OP_TYPE_TARGET);
+    IR_ASSERTD( argOp( arg_num).type() != OP_TYPE_TARGET);
 
     /** Set proper operand type */
-    args[ arg_num].setType( OP_TYPE_IMM);
+    unlinkOperand( &argOp( arg_num), OPERAND_DIR_USE);
+    argOp( arg_num).setType( OP_TYPE_IMM);
 
     /** Set operand immediate value */
-    args[ arg_num].setConstValue( imm_val);
+    argOp( arg_num).setConstValue( imm_val);
 }
 
 /** Set operation's argument object */
@@ -274,17 +518,14 @@ Operation<MDesType>::setResObj( UInt32 res_num, Object< MDesType> *obj)
     IR_ASSERTD( res_num < numRess());
     
     /** Check that given operand can actually hold object according to MDes */
-    typename MDesType::OperDes *des = MDesType::operDescription( name());
-    typename MDesType::OpDes *op_des = des->resDes( res_num);
+    const typename MDesType::OperDes *des = MDesType::operDescription( name());
+    const typename MDesType::OpDes *op_des = des->resDes( res_num);
 
     IR_ASSERTD( isNotNullP( op_des));
     IR_ASSERTD( op_des->isProperName( obj->type()) );
 
-    /** Set proper operand type */
-    ress[ res_num].setType( OP_TYPE_OBJ);
-
-    /** Set operand object */
-    ress[ res_num].setObject( obj);
+    /** Set operand type and object, the operand becomes a definition of the object */
+    linkOperand( &resOp( res_num), OPERAND_DIR_DEF, obj);
 }
 
 /** Return type of object */
@@ -300,9 +541,134 @@ template <class MDesType>
 void Operation<MDesType>::setName( OperName nm)
 {
     IR_ASSERTD( nm < MDesType::num_opers);
+    const typename MDesType::OperDes *des = MDesType::operDescription( nm);
+    UInt32 num = des->num_args + des->num_ress;
+
+    if ( name_ != MDesType::num_opers
+         && numArgs() == des->num_args && numRess() == des->num_ress
+         && archDes()->canHaveArgSet() == des->canHaveArgSet()
+         && archDes()->canHaveResSet() == des->canHaveResSet() )
+    {
+        name_ = nm;
+        return;
+    }
+    freeOperands();
     name_ = nm;
+
+    UInt32 size = blockSize( des);
+
+    if ( size > 0)
+    {
+        ops = static_cast< Operand< MDesType> *>( function()->arena().allocateArray( size));
+        for ( UInt32 i = 0; i < num; i++)
+        {
+            new ( &ops[ i]) Operand< MDesType>();
+        }
+        if ( des->canHaveArgSet() )
+        {
+            new ( argSet()) OperandSet< MDesType>();
+        }
+        if ( des->canHaveResSet() )
+        {
+            new ( resSet()) OperandSet< MDesType>();
+        }
+    }
 }   
 
+/** Get argument operand for change */
+template <class MDesType> 
+Operand< MDesType> &
+Operation<MDesType>::argOp( UInt32 i)
+{
+    IR_ASSERTXD( i < numArgs(), "Invalid argument number");
+    return ops[ i];
+}
+
+/** Get result operand for change */
+template <class MDesType> 
+Operand< MDesType> &
+Operation<MDesType>::resOp( UInt32 i)
+{
+    IR_ASSERTXD( i < numRess(), "Invalid result number");
+    return ops[ numArgs() + i];
+}
+
+/** Get size of the operands' block for the operation's description */
+template <class MDesType> 
+UInt32 Operation<MDesType>::blockSize( const typename MDesType::OperDes *des)
+{
+    UInt32 num_sets = ( des->canHaveArgSet() ? 1 : 0) + ( des->canHaveResSet() ? 1 : 0);
+
+    return ( des->num_args + des->num_ress) * sizeof( Operand< MDesType>)
+           + num_sets * sizeof( OperandSet< MDesType>);
+}
+
+/** Get argument set, NULL if the operation can't have it */
+template <class MDesType> 
+OperandSet< MDesType> *
+Operation<MDesType>::argSet() const
+{
+    if ( !archDes()->canHaveArgSet() )
+        return NULL;
+
+    return reinterpret_cast< OperandSet< MDesType> *>( ops + numArgs() + numRess());
+}
+
+/** Get result set, NULL if the operation can't have it */
+template <class MDesType> 
+OperandSet< MDesType> *
+Operation<MDesType>::resSet() const
+{
+    if ( !archDes()->canHaveResSet() )
+        return NULL;
+
+    /* The result set follows the argument set */
+    OperandSet< MDesType> *sets = reinterpret_cast< OperandSet< MDesType> *>( ops + numArgs() + numRess());
+
+    return archDes()->canHaveArgSet() ? sets + 1 : sets;
+}
+
+/** Remove the operands from the objects' lists and return the block to the function's arena */
+template <class MDesType> 
+void Operation<MDesType>::freeOperands()
+{
+    if ( isNullP( ops) )
+        return;
+
+    UInt32 num_args = numArgs();
+    UInt32 num_ress = numRess();
+
+    for ( UInt32 i = 0; i < num_args; i++)
+    {
+        unlinkOperand( &ops[ i], OPERAND_DIR_USE);
+    }
+    for ( UInt32 i = 0; i < num_ress; i++)
+    {
+        unlinkOperand( &ops[ num_args + i], OPERAND_DIR_DEF);
+    }
+    freeSet( argSet(), OPERAND_DIR_USE);
+    freeSet( resSet(), OPERAND_DIR_DEF);
+    function()->arena().deallocateArray( ops, blockSize( archDes()));
+    ops = NULL;
+}
+
+/** Remove the set's operands from the objects' lists and return a large set's array to the arena */
+template <class MDesType> 
+void Operation<MDesType>::freeSet( OperandSet< MDesType> *set, OpDir dir)
+{
+    if ( isNullP( set) )
+        return;
+
+    for ( UInt32 i = 0; i < set->num(); i++)
+    {
+        unlinkOperand( &( *set)[ i], dir);
+    }
+    if ( !set->isInline() )
+    {
+        function()->arena().deallocateArray( set->ops, set->capacity() * sizeof( Operand< MDesType>));
+    }
+}
+
 /** Return name of operation */
 template <class MDesName> 
 typename Operation<MDesName>::OperName
@@ -311,12 +677,69 @@ Operation<MDesName>::name() const
     return name_;    
 }
 
+/** Create empty operand set */
+template < class MDesType>
+OperandSet<MDesType>::OperandSet(): ops( NULL), num_( 0), capacity_( OPERAND_SET_INLINE_NUM)
+{
+
+}
+
+/** Get number of operands in the set */
+template < class MDesType>
+UInt32
+OperandSet<MDesType>::num() const
+{
+    return num_;
+}
+
+/** Get number of operands that fit */
+template < class MDesType>
+UInt32
+OperandSet<MDesType>::capacity() const
+{
+    return capacity_;
+}
+
+/** Check that operands are in the inline buffer */
+template < class MDesType>
+bool
+OperandSet<MDesType>::isInline() const
+{
+    return isNullP( ops);
+}
+
+/** Get the array of operands in the order of addition */
+template < class MDesType>
+Operand< MDesType> *
+OperandSet<MDesType>::data()
+{
+    return isInline() ? inline_ops : ops;
+}
+
+/** Get i-th operand in the set order */
+template < class MDesType>
+Operand< MDesType> &
+OperandSet<MDesType>::operator[]( UInt32 i)
+{
+    IR_ASSERTD( i < num_);
+    return data()[ num_ - 1 - i];
+}
+
+/** Get i-th operand in the set order */
+template < class MDesType>
+const Operand< MDesType> &
+OperandSet<MDesType>::operator[]( UInt32 i) const
+{
+    IR_ASSERTD( i < num_);
+    return ( isInline() ? inline_ops : ops)[ num_ - 1 - i];
+}
+
 /** Operation constructor */
 template < class MDesType> 
 Operation<MDesType>::Operation():
     Node< DG< MDesType>, typename MDesType::OperationType, DepEdge<MDesType> >(), // Dependence graph node constructor
-    first_arg( NULL), // We don't have any arguments in the set on operation construction
-    first_res( NULL), // We don't have any results in the set on operation construction
+    ops( NULL),       // Operands are allocated when the name is set
+    name_( (OperName)MDesType::num_opers),
     node_( NULL)      // Node is not define at the moment of operation construction
 {
     
@@ -326,44 +749,101 @@ Operation<MDesType>::Operation():
 template < class MDesType> 
 Operation<MDesType>::~Operation()
 {
-    deleteList< Operand<MDesType> >( first_arg);
-    deleteList< Operand<MDesType> >( first_res);
+    /* The function releases its objects and operand arrays all at once */
+    if ( function()->isBeingDestroyed() )
+        return;
+
+    /* Remove the operands from the objects' uses and definitions */
+    freeOperands();
 }
 
 
-/** Print operand list to stream */
+/** Print operand set to stream */
 template < class MDesType> 
 void
-Operation<MDesType>::opListToStream(ostream& os, Operand< MDesType>* op) const
+Operation<MDesType>::opListToStream(ostream& os, const OperandSet< MDesType> &set, const SymbolTable *symtab) const
 {
-    if ( isNotNullP( op))
+    if ( set.num() > 0)
     {        
-        bool first = true;
         os << '(';
-        while ( isNotNullP( op) )
+        for ( UInt32 i = 0; i < set.num(); i++)
         {
-            if ( !first )
+            if ( i > 0)
             {
                 os << ", ";   
             }
-            else
+            set[ i].toStream( os, symtab);
+        }
+        os << ')';
+    }
+}
+
+/** Add operand to the end of the set, the set grows into the function's arena if needed */
+template < class MDesType> 
+Operand< MDesType> *
+Operation<MDesType>::newSetOperand( OperandSet< MDesType> &set, OpDir dir)
+{
+    if ( set.num_ == set.capacity_)
+    {
+        Arena &arena = function()->arena();
+        UInt32 capacity = 2 * set.capacity_;
+        Operand< MDesType> *ops =
+            static_cast< Operand< MDesType> *>( arena.allocateArray( capacity * sizeof( Operand< MDesType>)));
+        Operand< MDesType> *old_ops = set.data();
+
+        /* Moved operands must be updated in the lists of their objects */
+        for ( UInt32 i = 0; i < set.num_; i++)
+        {
+            ops[ i] = old_ops[ i];
+            if ( ops[ i].type() == OP_TYPE_OBJ && isNotNullP( ops[ i].object()) )
             {
-                first = false;
+                ops[ i].object()->moveRef( dir, &ops[ i]);
             }
-            os << *op;
-            op = op->next();
         }
-        os << ')';
+        if ( !set.isInline() )
+        {
+            arena.deallocateArray( set.ops, set.capacity_ * sizeof( Operand< MDesType>));
+        }
+        set.ops = ops;
+        set.capacity_ = capacity;
+    }
+    Operand< MDesType> *op = &set.data()[ set.num_++];
+
+    *op = Operand< MDesType>();
+    return op;
+}
+
+/** Make the operand hold the given object and register it in the object's uses or definitions */
+template < class MDesType> 
+void
+Operation<MDesType>::linkOperand( Operand< MDesType> *op, OpDir dir, Object< MDesType> *obj)
+{
+    unlinkOperand( op, dir);
+    op->setType( OP_TYPE_OBJ);
+    op->setObject( obj);
+    if ( isNotNullP( obj) )
+    {
+        obj->addRef( dir, this, op);
     }
 }
 
+/** Remove the operand from the lists of its object if it holds one */
+template < class MDesType> 
+void
+Operation<MDesType>::unlinkOperand( Operand< MDesType> *op, OpDir dir)
+{
+    if ( op->type() == OP_TYPE_OBJ && isNotNullP( op->object()) )
+    {
+        op->object()->removeRef( dir, op);
+    }
+}
 
 /** Get the mnemonic string of the operation */
 template < class MDesType> 
-string &
+const char *
 Operation<MDesType>::nameStr() const
 {
-    typename MDesType::OperDes *des = MDesType::operDescription( name());
+    const typename MDesType::OperDes *des = MDesType::operDescription( name());
 
     return des->mnemonic_str;
 }
@@ -373,7 +853,14 @@ template < class MDesType>
 void
 Operation<MDesType>::toStream(ostream& os) const
 {
-    typename MDesType::OperDes *des = MDesType::operDescription( name());
+    const typename MDesType::OperDes *des = MDesType::operDescription( name());
+    const SymbolTable *symtab = NULL;
+
+    /* Symbolic constants are printed with the module's symbol table */
+    if ( isNotNullP( function()) && isNotNullP( function()->module()) )
+    {
+        symtab = &function()->module()->symbols();
+    }
 
     /* Print id */
     os << '{' << this->id() << "} ";
@@ -389,7 +876,7 @@ Operation<MDesType>::toStream(ostream& os) const
         /* Skip results if it have to be res set */
         if ( des->resDes( i)->can_be_set) 
         {
-            if ( isNotNullP( first_res))
+            if ( numRessInSet() > 0)
             {
                 if ( !first)
                    os << ',';   
@@ -398,7 +885,7 @@ Operation<MDesType>::toStream(ostream& os) const
                 
                 os << ' ';
                 
-                opListToStream( os, first_res);
+                opListToStream( os, *resSet(), symtab);
                 ress_printed++;
             }
        } else
@@ -407,7 +894,8 @@ Operation<MDesType>::toStream(ostream& os) const
                os << ',';   
            else
                first = 0;
-           os << ' ' << res( i);
+           os << ' ';
+           res( i).toStream( os, symtab);
            ress_printed++;
        }
    }
@@ -420,14 +908,14 @@ Operation<MDesType>::toStream(ostream& os) const
         /* Skip arguments if it have to be res set */
         if ( des->argDes( i)->can_be_set) 
         {
-            if ( isNotNullP( first_arg))
+            if ( numArgsInSet() > 0)
             {
                 if ( !first)
                    os << ',';   
                 else
                    first = 0;
                 os << ' ';
-                opListToStream( os, first_arg);
+                opListToStream( os, *argSet(), symtab);
             }
        } else
        {
@@ -435,7 +923,8 @@ Operation<MDesType>::toStream(ostream& os) const
                os << ',';
            else
                first = 0;   
-           os << ' ' << arg( i);
+           os << ' ';
+           arg( i).toStream( os, symtab);
        }
     }
     /* Newline */
@@ -472,7 +961,7 @@ void
 Operation<MDesType>::insertAfter( Operation< MDesType> *prev_oper)
 {
     OperSeqList::detach();
-    prev_oper->OperSeqList::attach( this);
+    OperSeqList::attachInDir( prev_oper, LIST_DIR_RDEFAULT);
 }
 
 /** Insert operation into sequence before the given operation */
@@ -481,7 +970,7 @@ void
 Operation<MDesType>::insertBefore( Operation< MDesType> *next_oper)
 {
     OperSeqList::detach();
-    next_oper->OperSeqList::attachInDir( this, LIST_DIR_RDEFAULT);
+    OperSeqList::attach( next_oper);
 }
 
 /** Get operation's function */
@@ -498,17 +987,12 @@ const Operand< MDesType> *
 Operation<MDesType>::addArgToSet( Object< MDesType> *obj)
 {
     /** Check that the operation can actually have argument set according to MDes */
-    typename MDesType::OperDes *des = MDesType::operDescription( name());
+    const typename MDesType::OperDes *des = MDesType::operDescription( name());
     IR_ASSERTD( des->canHaveArgSet() );
 
     /* Create new operand, set its type and assign object to it */
-    Operand< MDesType> *op = new Operand< MDesType>();
-    op->setType( OP_TYPE_OBJ);
-    op->setObject( obj);
-    
-    /* Operand list bookeeping */
-    op->attach( first_arg);
-    first_arg = op;
+    Operand< MDesType> *op = newSetOperand( *argSet(), OPERAND_DIR_USE);
+    linkOperand( op, OPERAND_DIR_USE, obj);
     return op;
 }
 
@@ -518,17 +1002,13 @@ const Operand< MDesType> *
 Operation<MDesType>::addArgToSet( Const imm_val)
 {
     /** Check that the operation can actually have argument set according to MDes */
-    typename MDesType::OperDes *des = MDesType::operDescription( name());
+    const typename MDesType::OperDes *des = MDesType::operDescription( name());
     IR_ASSERTD( des->canHaveArgSet() );
     
     /* Create new operand, set its type and assign object to it */
-    Operand< MDesType> *op = new Operand< MDesType>();
+    Operand< MDesType> *op = newSetOperand( *argSet(), OPERAND_DIR_USE);
     op->setType( OP_TYPE_IMM);
     op->setConstValue( imm_val);
-    
-    /* Operand list bookeeping */
-    op->attach( first_arg);
-    first_arg = op;
     return op;
 }
 
@@ -538,35 +1018,73 @@ const Operand< MDesType> *
 Operation<MDesType>::addResToSet( Object< MDesType> *obj)
 {
     /** Check that the operation can actually have result set according to MDes */
-    typename MDesType::OperDes *des = MDesType::operDescription( name());
+    const typename MDesType::OperDes *des = MDesType::operDescription( name());
     IR_ASSERTD( des->canHaveResSet() );
 
     /* Create new operand, set its type and assign object to it */
-    Operand< MDesType> *op = new Operand< MDesType>();
-    op->setType( OP_TYPE_OBJ);
-    op->setObject( obj);
-    
-    /* Operand list bookeeping */
-    op->attach( first_res);
-    first_res = op;
-
+    Operand< MDesType> *op = newSetOperand( *resSet(), OPERAND_DIR_DEF);
+    linkOperand( op, OPERAND_DIR_DEF, obj);
     return op;
 }
 
-/** Get first argument operand in argument set */
+/** Get number of operands in argument set */
 template < class MDesType> 
-Operand< MDesType> * 
-Operation<MDesType>::firstArgInSet() const
+UInt32
+Operation<MDesType>::numArgsInSet() const
 {
-    return first_arg;
+    OperandSet< MDesType> *set = argSet();
+
+    return isNotNullP( set) ? set->num() : 0;
 }
-    
-/** Get first result in result set */
+
+/** Get number of operands in result set */
 template < class MDesType> 
-Operand< MDesType> * 
-Operation<MDesType>::firstResInSet() const
+UInt32
+Operation<MDesType>::numRessInSet() const
 {
-    return first_res;
+    OperandSet< MDesType> *set = resSet();
+
+    return isNotNullP( set) ? set->num() : 0;
+}
+
+/** Get argument from the set */
+template < class MDesType> 
+const Operand< MDesType> &
+Operation<MDesType>::argInSet( UInt32 i) const
+{
+    IR_ASSERTD( isNotNullP( argSet()) );
+    return ( *argSet())[ i];
+}
+
+/** Get result from the set */
+template < class MDesType> 
+const Operand< MDesType> &
+Operation<MDesType>::resInSet( UInt32 i) const
+{
+    IR_ASSERTD( isNotNullP( resSet()) );
+    return ( *resSet())[ i];
+}
+
+/** Set object of the argument from the set */
+template < class MDesType> 
+void
+Operation<MDesType>::setArgObjInSet( UInt32 i, Object< MDesType> *obj)
+{
+    Operand< MDesType> &op = ( *argSet())[ i];
+
+    IR_ASSERTD( op.type() == OP_TYPE_OBJ);
+    linkOperand( &op, OPERAND_DIR_USE, obj);
+}
+
+/** Set object of the result from the set */
+template < class MDesType> 
+void
+Operation<MDesType>::setResObjInSet( UInt32 i, Object< MDesType> *obj)
+{
+    Operand< MDesType> &op = ( *resSet())[ i];
+
+    IR_ASSERTD( op.type() == OP_TYPE_OBJ);
+    linkOperand( &op, OPERAND_DIR_DEF, obj);
 }
 
 /** Get the control flow node of the operation */
@@ -596,6 +1114,17 @@ Operation<MDesType>::isLastInNode() const
     return areEqP( this->node()->lastOper(), this);
 }
 
+// Next operation of the CF node, NULL for the last one
+template < class MDesType> 
+Operation< MDesType> *
+Operation<MDesType>::nextInNode() const
+{
+    if ( isNullP( node()) || isLastInNode() )
+        return NULL;
+
+    return nextOper();
+}
+
 // Check if the operation is first in its CF node
 template < class MDesType> 
 bool
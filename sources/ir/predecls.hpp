@@ -63,6 +63,7 @@ namespace IR
 
     template <class MDesType> class  DG;
     template <class MDesType> class  Operation;
+    template <class MDesType> class  Operand;
     template <class MDesType> class  DepEdge;
 
     template <class MDesType> class  CFG;
@@ -0,0 +1,97 @@
+/**
+ * @file: ir/reader.cpp
+ * Implementation of the file mapping for the IR reader
+ * @ingroup IR
+ */
+ /*
+  * Copyright 2012 MIPT-COMPILER team
+  */
+#include "ir_iface.hpp"
+
+#if defined(_WIN32)
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <unistd.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#endif
+
+using namespace IR;
+
+/**
+ * Map the file, throws ReadError if it can't be mapped. The handles of the file are closed
+ * right away since the mapped view keeps the file open. Empty file is not mapped
+ */
+MappedFile::MappedFile( const char *path): data_( NULL), size_( 0)
+{
+#if defined(_WIN32)
+    HANDLE file = CreateFileA( path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                               FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    LARGE_INTEGER size;
+
+    if ( file == INVALID_HANDLE_VALUE)
+    {
+        throw ReadError( string( "Can't open file ") + path, 0);
+    }
+    if ( !GetFileSizeEx( file, &size) )
+    {
+        CloseHandle( file);
+        throw ReadError( string( "Can't get size of file ") + path, 0);
+    }
+    size_ = (size_t)size.QuadPart;
+    if ( size_ > 0)
+    {
+        HANDLE mapping = CreateFileMappingA( file, NULL, PAGE_READONLY, 0, 0, NULL);
+
+        if ( isNotNullP( mapping) )
+        {
+            data_ = static_cast< const char *>( MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0));
+            CloseHandle( mapping);
+        }
+    }
+    CloseHandle( file);
+#else
+    int fd = open( path, O_RDONLY);
+    struct stat st;
+
+    if ( fd < 0)
+    {
+        throw ReadError( string( "Can't open file ") + path, 0);
+    }
+    if ( fstat( fd, &st) != 0)
+    {
+        close( fd);
+        throw ReadError( string( "Can't get size of file ") + path, 0);
+    }
+    size_ = (size_t)st.st_size;
+    if ( size_ > 0)
+    {
+        void *addr = mmap( NULL, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if ( addr != MAP_FAILED)
+        {
+            /* The text is scanned from the beginning to the end */
+            madvise( addr, size_, MADV_SEQUENTIAL);
+            data_ = static_cast< const char *>( addr);
+        }
+    }
+    close( fd);
+#endif
+    if ( size_ > 0 && isNullP( data_) )
+    {
+        throw ReadError( string( "Can't map file ") + path, 0);
+    }
+}
+
+/** Unmap the file */
+MappedFile::~MappedFile()
+{
+    if ( isNullP( data_) )
+        return;
+#if defined(_WIN32)
+    UnmapViewOfFile( data_);
+#else
+    munmap( const_cast< char *>( data_), size_);
+#endif
+}
@@ -0,0 +1,1126 @@
+/**
+ * @file: ir/reader.hpp
+ * Reader of the textual IR printed by Function::toStream
+ * @ingroup IR
+ */
+ /*
+  * Copyright 2012 MIPT-COMPILER team
+  */
+
+#pragma once
+
+namespace IR
+{
+    /**
+     * @class ReadError
+     * @brief Error in the text of IR, tells the line where the reader stopped
+     *
+     * Errors that are not bound to a line of text like the errors of files and binary IR have line 0
+     * @ingroup IR
+     */
+    class ReadError: public exception
+    {
+    public:
+        ReadError( const string &what, UInt32 line):
+            msg( line > 0 ? "line " + toString( line) + ": " + what : what), line_( line)
+        {
+        }
+        ~ReadError() throw()
+        {
+        }
+        const char *what() const throw()
+        {
+            return msg.c_str();
+        }
+        UInt32 line() const /**< Get number of the line with the error, the first line is 1, 0 if none */
+        {
+            return line_;
+        }
+    private:
+        string msg;
+        UInt32 line_;
+    };
+
+    /**
+     * @class MappedFile
+     * @brief Read-only file mapped into memory
+     *
+     * The pages of the file are read by the system on the first access and nothing is copied,
+     * so big files are read as fast as the text is scanned
+     * @ingroup IR
+     */
+    class MappedFile
+    {
+    public:
+        MappedFile( const char *path); /**< Map the file, throws ReadError if it can't be mapped */
+        ~MappedFile();                 /**< Unmap the file */
+
+        inline const char *data() const; /**< Get the characters of the file */
+        inline size_t size() const;      /**< Get size of the file in bytes */
+    private:
+        MappedFile( const MappedFile &);
+        MappedFile &operator = ( const MappedFile &);
+
+        const char *data_;
+        size_t size_;
+    };
+
+    /** Get the characters of the file */
+    const char *MappedFile::data() const
+    {
+        return data_;
+    }
+
+    /** Get size of the file in bytes */
+    size_t MappedFile::size() const
+    {
+        return size_;
+    }
+
+    /** Id of the record that is absent in the text */
+    const UInt32 READER_NO_ID = (UInt32)-1;
+
+    /**
+     * @class Reader
+     * @brief Reader of the functions printed by Function::toStream and Module::toStream
+     *
+     * Both the linear form of the function and the form with the CFG are read. The text is
+     * scanned twice: first the lines of the function are classified and the operations, CF nodes and
+     * edges are recorded as pointers into the text, then the IR is built from the records. Every
+     * operation gets its operands right after it is created while it is still in the cache, the targets
+     * that are not created yet are set at the end. Operations, CF nodes, edges and objects are created
+     * in the order of their ids, and the ids missing from the text are taken by the entities that are
+     * deleted at once, so the read function has the ids of the printed one and prints the same text. The records are reused from function to function
+     * and the strings are only created for the new names, so reading takes little memory besides the IR.
+     * Floating point constants are read back with the precision they are printed with
+     * @ingroup IR
+     */
+    template <class MDesType> class Reader
+    {
+    public:
+        typedef typename MDesType::OperationType OperationType;
+        typedef typename MDesType::OperName OperName;
+        typedef typename MDesType::ObjectName ObjectName;
+        typedef typename MDesType::OpDes OpDes;
+
+        /** Create reader adding the functions to the given module */
+        Reader( Module< MDesType> *m);
+
+        /**
+         * Read the functions from the text and add them to the module. Returns the number of the read
+         * functions. Throws ReadError on malformed text, the function being read is removed then
+         */
+        UInt32 read( const char *text, size_t size);
+
+        /** Read the functions from the string */
+        UInt32 read( const string &text);
+
+        /** Read the functions from the file that is mapped into memory */
+        UInt32 readFile( const char *path);
+    private:
+        /** Operation line */
+        struct OperRec
+        {
+            UInt32 id;
+            OperName name;
+            UInt32 node;         /**< Id of the CF node, READER_NO_ID in the linear form */
+            const char *ops;     /**< Operands' text that follows the mnemonic */
+            const char *ops_end;
+            UInt32 line;
+        };
+
+        /** CF node header line */
+        struct NodeRec
+        {
+            UInt32 id;
+            bool is_start;
+            bool is_stop;
+            UInt32 line;
+        };
+
+        /** CF edge line, every edge is printed at its predecessor and at its successor */
+        struct EdgeRec
+        {
+            UInt32 id;
+            UInt32 pred;
+            UInt32 succ;
+            UInt32 src; /**< Id of the source operation, READER_NO_ID for fallthrough */
+            UInt32 line;
+        };
+
+        /** Operand value as it is written in the text */
+        struct Value
+        {
+            Value(): type( OP_TYPES_NUM), obj( NULL), imm( (Int64)0), target( NULL), target_id( 0){}
+
+            OperandType type; /**< OP_TYPES_NUM for unset operand */
+            Object< MDesType> *obj;
+            Const imm;
+            OperationType *target; /**< NULL if the target is not created yet */
+            UInt32 target_id;
+        };
+
+        /** Target argument that is set after all the operations are created */
+        struct TargetFixup
+        {
+            OperationType *oper;
+            UInt32 arg;
+            UInt32 target_id;
+            UInt32 line;
+        };
+
+        /** Order of the records by their ids */
+        template < class Rec> class IdLess
+        {
+        public:
+            IdLess( const vector< Rec> &r): recs( r){}
+
+            bool operator () ( const Rec &a, const Rec &b) const
+            {
+                return a.id < b.id;
+            }
+            bool operator () ( UInt32 a, UInt32 b) const
+            {
+                return recs[ a].id < recs[ b].id;
+            }
+        private:
+            const vector< Rec> &recs;
+        };
+
+        void readFunction();              /**< Read function starting at the current line */
+        void readArgs( const char *p, const char *e); /**< Read the arguments from the function header */
+        void readOperLine( const char *p, const char *e, UInt32 node); /**< Record operation line */
+        void readNodeLine( const char *p, const char *e);              /**< Record CF node header */
+        void readEdgeLine( const char *p, const char *e);              /**< Record CF edge line   */
+        void buildOpers();    /**< Create the recorded operations with their operands in the order of their ids */
+        void buildCFG();      /**< Create the recorded CF nodes and edges in the order of their ids */
+        void linkOpers();     /**< Link the operations into the sequence and the CF nodes in the order of the text */
+
+        /** Read operands of the operation */
+        void readOperands( OperationType *oper, const OperRec &rec);
+        /** Step to the next operand of the group, returns false if the optional operand is not there */
+        bool startOperand( const char *&p, const char *e, bool first, bool is_set);
+        /** Read the operand and set it to the operation */
+        void readOperand( OperationType *oper, OpDir dir, UInt32 i, const char *&p, const char *e);
+        /** Read the parenthesized set and add it to the operation */
+        void readSet( OperationType *oper, OpDir dir, const char *&p, const char *e);
+        /** Read object, constant, target or unset operand */
+        void readValue( Value &val, const char *&p, const char *e);
+        /** Read constant, returns false if the characters are not a number */
+        bool readNumber( Value &val, const char *p, const char *e);
+        /**
+         * Read object, returns false if the characters at p are not an object or if the object doesn't
+         * end at e when it must. The object is created only when it is read
+         */
+        bool readObject( Object< MDesType> *&obj, const char *&p, const char *e, bool to_end);
+
+        /** Get object by type and id creating the missing objects of the type */
+        Object< MDesType> *object( ObjectName type, UInt32 id);
+
+        /** Find the end of the current line */
+        inline void startLine();
+        /** Go to the next line */
+        inline void nextLine();
+        /** Check that the characters start with the given string and skip it */
+        static inline bool skip( const char *&p, const char *e, const char *str);
+        /** Skip the given string or throw ReadError */
+        inline void expect( const char *&p, const char *e, const char *str);
+        /** Read decimal number or throw ReadError */
+        inline UInt32 readUInt( const char *&p, const char *e);
+        /** Read id that must be less than the size of the text or throw ReadError */
+        inline UInt32 readId( const char *&p, const char *e);
+        /** Throw ReadError for the current line */
+        void error( const char *what) const;
+
+        Module< MDesType> *module;
+        Function< MDesType> *func;
+        SymbolTable mnemonics;            /**< Mnemonics, the ids of their symbols are the operation names */
+        size_t prefix_lens[ MDesType::num_objs]; /**< Lengths of the objects' prefixes */
+
+        const char *text_end;
+        UInt64 id_bound;                  /**< Ids are less than the size of the text */
+        const char *line_begin;           /**< Start of the current line */
+        const char *line_end;             /**< End of the current line without the line break */
+        const char *next_line;
+        UInt32 line_num;                  /**< Number of the current line, the first line is 1 */
+
+        vector< OperRec> opers;           /**< Operation lines in the order of the text */
+        vector< NodeRec> nodes;           /**< CF node headers in the order of the text */
+        vector< EdgeRec> edges;           /**< CF edge lines in the order of the text */
+        vector< UInt32> order;            /**< Indexes of the operation records in the order of ids */
+        vector< OperationType *> opers_by_id;
+        vector< CFNode< MDesType> *> nodes_by_id;
+        vector< Value> set_vals;          /**< Operands of the set being read */
+        vector< TargetFixup> fixups;      /**< Targets to set after the operations are created */
+        UInt32 max_oper_id;
+        UInt32 max_node_id;
+        bool ids_ascending;               /**< Operations are printed in the order of their ids */
+        bool is_cfg;                      /**< The function is printed with CFG */
+    };
+
+    /** Create reader adding the functions to the given module */
+    template <class MDesType>
+    Reader< MDesType>::Reader( Module< MDesType> *m):
+        module( m), func( NULL), text_end( NULL), id_bound( 0), line_begin( NULL), line_end( NULL), next_line( NULL),
+        line_num( 0), max_oper_id( 0), max_node_id( 0), ids_ascending( true), is_cfg( false)
+    {
+        for ( UInt32 i = 0; i < MDesType::num_opers; i++)
+        {
+            const char *mnem = MDesType::operDescription( (OperName)i)->mnemonic_str;
+            /* A new symbol gets the next id, so the id of the mnemonic is the operation name */
+            mnemonics.intern( mnem, (UInt32)strlen( mnem));
+            IR_ASSERTXD( mnemonics.numSymbols() == i + 1, "Mnemonics of the operations must be unique");
+        }
+        for ( UInt32 i = 0; i < MDesType::num_objs; i++)
+        {
+            prefix_lens[ i] = strlen( MDesType::objectDescription( (ObjectName)i)->prefix);
+        }
+    }
+
+    /** Throw ReadError for the current line */
+    template <class MDesType>
+    void
+    Reader< MDesType>::error( const char *what) const
+    {
+        throw ReadError( what, line_num);
+    }
+
+    /** Find the end of the current line */
+    template <class MDesType>
+    void
+    Reader< MDesType>::startLine()
+    {
+        const char *nl = static_cast< const char *>( memchr( line_begin, '\n', text_end - line_begin));
+
+        line_end = isNotNullP( nl) ? nl : text_end;
+        next_line = isNotNullP( nl) ? nl + 1 : text_end;
+        if ( line_end != line_begin && line_end[ -1] == '\r')
+        {
+            line_end--;
+        }
+    }
+
+    /** Go to the next line */
+    template <class MDesType>
+    void
+    Reader< MDesType>::nextLine()
+    {
+        line_begin = next_line;
+        line_num++;
+    }
+
+    /** Check that the characters start with the given string and skip it */
+    template <class MDesType>
+    bool
+    Reader< MDesType>::skip( const char *&p, const char *e, const char *str)
+    {
+        const char *q = p;
+
+        for ( ; *str != 0; str++, q++)
+        {
+            if ( q == e || *q != *str)
+                return false;
+        }
+        p = q;
+        return true;
+    }
+
+    /** Skip the given string or throw ReadError */
+    template <class MDesType>
+    void
+    Reader< MDesType>::expect( const char *&p, const char *e, const char *str)
+    {
+        if ( !skip( p, e, str) )
+        {
+            error( ( string( "'") + str + "' expected").c_str());
+        }
+    }
+
+    /** Read decimal number or throw ReadError */
+    template <class MDesType>
+    UInt32
+    Reader< MDesType>::readUInt( const char *&p, const char *e)
+    {
+        UInt64 val = 0;
+        const char *start = p;
+
+        for ( ; p != e && *p >= '0' && *p <= '9'; p++)
+        {
+            val = val * 10 + (UInt32)( *p - '0');
+            if ( val >= READER_NO_ID)
+            {
+                error( "Number is too large");
+            }
+        }
+        if ( p == start)
+        {
+            error( "Number expected");
+        }
+        return (UInt32)val;
+    }
+
+    /**
+     * Read id that must be less than the size of the text or throw ReadError. The objects, operations,
+     * CF nodes and edges are created up to the read ids, so the bound keeps it linear in the text
+     */
+    template <class MDesType>
+    UInt32
+    Reader< MDesType>::readId( const char *&p, const char *e)
+    {
+        UInt32 id = readUInt( p, e);
+
+        if ( id >= id_bound)
+        {
+            error( "Id is too large");
+        }
+        return id;
+    }
+
+    /** Read the functions from the string */
+    template <class MDesType>
+    UInt32
+    Reader< MDesType>::read( const string &text)
+    {
+        return read( text.data(), text.size());
+    }
+
+    /** Read the functions from the file that is mapped into memory */
+    template <class MDesType>
+    UInt32
+    Reader< MDesType>::readFile( const char *path)
+    {
+        MappedFile file( path);
+
+        return read( file.data(), file.size());
+    }
+
+    /**
+     * Read the functions from the text and add them to the module. Returns the number of the read
+     * functions. Throws ReadError on malformed text, the function being read is removed then
+     */
+    template <class MDesType>
+    UInt32
+    Reader< MDesType>::read( const char *text, size_t size)
+    {
+        UInt32 num = 0;
+
+        text_end = text + size;
+        id_bound = size;
+        line_begin = text;
+        line_num = 1;
+        while ( line_begin != text_end)
+        {
+            startLine();
+            if ( line_begin == line_end)
+            {
+                nextLine();
+                continue;
+            }
+            /* The function stops at the header of the next one */
+            readFunction();
+            num++;
+        }
+        return num;
+    }
+
+    /** Read function starting at the current line */
+    template <class MDesType>
+    void
+    Reader< MDesType>::readFunction()
+    {
+        const char *p = line_begin;
+        const char *e = line_end;
+
+        expect( p, e, "Function ");
+
+        const char *paren = static_cast< const char *>( memchr( p, '(', e - p));
+
+        if ( isNullP( paren) )
+        {
+            error( "Function arguments expected");
+        }
+        if ( isNotNullP( module->findFunctionByName( p, (UInt32)( paren - p))) )
+        {
+            error( "Function is already in the module");
+        }
+        func = module->newFunction( string( p, paren - p));
+        opers.clear();
+        nodes.clear();
+        edges.clear();
+        max_oper_id = 0;
+        max_node_id = 0;
+        ids_ascending = true;
+        is_cfg = false;
+        try
+        {
+            UInt32 node = READER_NO_ID;
+
+            readArgs( paren, e);
+
+            /* The lines of the function up to the next function's header */
+            for ( nextLine(); line_begin != text_end; nextLine())
+            {
+                startLine();
+                p = line_begin;
+                e = line_end;
+                if ( skip( p, e, "Function ") )
+                    break;
+
+                if ( p == e)
+                {
+                    continue;
+                } else if ( *p == '{')
+                {
+                    readOperLine( p, e, node);
+                } else if ( skip( p, e, "CF Node ") || skip( p, e, "unreachable CF Node ") )
+                {
+                    readNodeLine( p, e);
+                    node = nodes.back().id;
+                } else if ( skip( p, e, "CF Edge ") )
+                {
+                    readEdgeLine( p, e);
+                } else if ( skip( p, e, "label_") )
+                {
+                    /* Targets are printed with the ids of operations, labels are just for reading */
+                    readUInt( p, e);
+                    expect( p, e, ":");
+                } else
+                {
+                    error( "Operation, label or CF line expected");
+                }
+            }
+            /* Errors in the records are reported at their lines */
+            UInt32 stop_line = line_num;
+
+            buildOpers();
+            buildCFG();
+            linkOpers();
+            line_num = stop_line;
+        } catch ( ReadError &)
+        {
+            module->removeFunction( func);
+            func = NULL;
+            throw;
+        }
+        func->cfg().setValid( is_cfg);
+        func = NULL;
+    }
+
+    /** Read the arguments from the function header */
+    template <class MDesType>
+    void
+    Reader< MDesType>::readArgs( const char *p, const char *e)
+    {
+        UInt16 arg_num = 0;
+
+        /* Argument objects are printed one after another without separators */
+        expect( p, e, "( ");
+        while ( p != e && *p != ')')
+        {
+            Object< MDesType> *obj = NULL;
+
+            if ( !readObject( obj, p, e, false) )
+            {
+                error( "Argument object expected");
+            }
+            func->setArg( arg_num++, obj);
+        }
+        expect( p, e, ")");
+        if ( p != e)
+        {
+            error( "Unexpected characters after the function header");
+        }
+    }
+
+    /** Record operation line */
+    template <class MDesType>
+    void
+    Reader< MDesType>::readOperLine( const char *p, const char *e, UInt32 node)
+    {
+        OperRec rec;
+
+        expect( p, e, "{");
+        rec.id = readId( p, e);
+        expect( p, e, "} ");
+
+        const char *mnem = p;
+
+        while ( p != e && *p != ' ')
+        {
+            p++;
+        }
+        Symbol sym = mnemonics.find( mnem, (UInt32)( p - mnem));
+
+        if ( !sym.isValid() )
+        {
+            error( "Unknown operation");
+        }
+        rec.name = (OperName)sym.id();
+        rec.node = node;
+        rec.ops = p;
+        rec.ops_end = e;
+        rec.line = line_num;
+        if ( is_cfg && node == READER_NO_ID)
+        {
+            error( "Operation is out of CF nodes");
+        }
+        if ( !opers.empty() && rec.id <= opers.back().id)
+        {
+            ids_ascending = false;
+        }
+        max_oper_id = max< UInt32>( max_oper_id, rec.id);
+        opers.push_back( rec);
+    }
+
+    /** Record CF node header */
+    template <class MDesType>
+    void
+    Reader< MDesType>::readNodeLine( const char *p, const char *e)
+    {
+        NodeRec rec;
+
+        if ( !is_cfg && !opers.empty() )
+        {
+            error( "Operation is out of CF nodes");
+        }
+        is_cfg = true;
+        rec.id = readId( p, e);
+        rec.is_start = skip( p, e, " Start");
+        rec.is_stop = !rec.is_start && skip( p, e, " Stop");
+        rec.line = line_num;
+        if ( p != e)
+        {
+            error( "Unexpected characters after the CF node header");
+        }
+        max_node_id = max< UInt32>( max_node_id, rec.id);
+        nodes.push_back( rec);
+    }
+
+    /** Record CF edge line */
+    template <class MDesType>
+    void
+    Reader< MDesType>::readEdgeLine( const char *p, const char *e)
+    {
+        EdgeRec rec;
+
+        if ( nodes.empty() )
+        {
+            error( "CF edge is out of CF nodes");
+        }
+        rec.id = readId( p, e);
+        expect( p, e, ": ");
+        rec.pred = readUInt( p, e);
+        expect( p, e, "->");
+        rec.succ = readUInt( p, e);
+        rec.src = READER_NO_ID;
+        rec.line = line_num;
+        if ( !skip( p, e, ", fallthrough") )
+        {
+            expect( p, e, ", src: ");
+            rec.src = readUInt( p, e);
+
+            /* The mnemonic of the source is printed for the reader of the text only */
+            expect( p, e, " ");
+            p = e;
+        }
+        if ( p != e)
+        {
+            error( "Unexpected characters after the CF edge");
+        }
+        edges.push_back( rec);
+    }
+
+    /** Create the recorded operations with their operands in the order of their ids */
+    template <class MDesType>
+    void
+    Reader< MDesType>::buildOpers()
+    {
+        order.resize( opers.size());
+        for ( UInt32 i = 0; i < opers.size(); i++)
+        {
+            order[ i] = i;
+        }
+        /* Operations are usually printed in the order of ids */
+        if ( !ids_ascending)
+        {
+            sort( order.begin(), order.end(), IdLess< OperRec>( opers));
+        }
+        opers_by_id.assign( opers.empty() ? 0 : max_oper_id + 1, NULL);
+        fixups.clear();
+
+        for ( UInt32 i = 0; i < order.size(); i++)
+        {
+            const OperRec &rec = opers[ order[ i]];
+            OperationType *oper = func->newOper( rec.name);
+
+            /* Operations that are missing from the text are created and deleted to skip their ids */
+            while ( oper->id() < rec.id)
+            {
+                func->deleteOper( oper);
+                oper = func->newOper( rec.name);
+            }
+            if ( oper->id() != rec.id)
+            {
+                line_num = rec.line;
+                error( "Operation id is used twice");
+            }
+            opers_by_id[ rec.id] = oper;
+            readOperands( oper, rec);
+        }
+        for ( UInt32 i = 0; i < fixups.size(); i++)
+        {
+            const TargetFixup &fixup = fixups[ i];
+
+            line_num = fixup.line;
+            if ( isNullP( opers_by_id[ fixup.target_id]) )
+            {
+                error( "Target operation is not in the function");
+            }
+            fixup.oper->setArgTarget( fixup.arg, opers_by_id[ fixup.target_id]);
+        }
+    }
+
+    /** Create the recorded CF nodes and edges in the order of their ids */
+    template <class MDesType>
+    void
+    Reader< MDesType>::buildCFG()
+    {
+        CFG< MDesType> &cfg = func->cfg();
+
+        sort( nodes.begin(), nodes.end(), IdLess< NodeRec>( nodes));
+        nodes_by_id.assign( nodes.empty() ? 0 : max_node_id + 1, NULL);
+        for ( UInt32 i = 0; i < nodes.size(); i++)
+        {
+            const NodeRec &rec = nodes[ i];
+            CFNode< MDesType> *node = NULL;
+
+            line_num = rec.line;
+            if ( isNotNullP( nodes_by_id[ rec.id]) )
+            {
+                error( "CF node id is used twice");
+            }
+            if ( rec.is_start)
+            {
+                node = cfg.startNode();
+            } else if ( rec.is_stop)
+            {
+                node = cfg.stopNode();
+            } else
+            {
+                node = cfg.newNode();
+                while ( node->id() < rec.id)
+                {
+                    cfg.deleteNode( node);
+                    node = cfg.newNode();
+                }
+            }
+            if ( node->id() != rec.id)
+            {
+                error( "CF node id doesn't match the order of the nodes");
+            }
+            nodes_by_id[ rec.id] = node;
+        }
+
+        sort( edges.begin(), edges.end(), IdLess< EdgeRec>( edges));
+        for ( UInt32 i = 0; i < edges.size(); i++)
+        {
+            const EdgeRec &rec = edges[ i];
+
+            line_num = rec.line;
+            if ( i > 0 && edges[ i - 1].id == rec.id)
+            {
+                const EdgeRec &prev = edges[ i - 1];
+
+                if ( prev.pred != rec.pred || prev.succ != rec.succ || prev.src != rec.src)
+                {
+                    error( "CF edge is printed differently at its nodes");
+                }
+                continue;
+            }
+            if ( rec.pred > max_node_id || rec.succ > max_node_id
+                 || isNullP( nodes_by_id[ rec.pred]) || isNullP( nodes_by_id[ rec.succ]) )
+            {
+                error( "CF edge connects unknown node");
+            }
+            CFNode< MDesType> *pred = nodes_by_id[ rec.pred];
+            CFNode< MDesType> *succ = nodes_by_id[ rec.succ];
+            CFEdge< MDesType> *edge = cfg.newEdge( pred, succ);
+
+            while ( edge->id() < rec.id)
+            {
+                cfg.deleteEdge( edge);
+                edge = cfg.newEdge( pred, succ);
+            }
+            if ( edge->id() != rec.id)
+            {
+                error( "CF edge id doesn't match the order of the edges");
+            }
+            if ( rec.src != READER_NO_ID)
+            {
+                if ( rec.src >= opers_by_id.size() || isNullP( opers_by_id[ rec.src]) )
+                {
+                    error( "Unknown source operation of CF edge");
+                }
+                edge->setSrcOper( opers_by_id[ rec.src]);
+            }
+        }
+    }
+
+    /** Link the operations into the sequence and the CF nodes in the order of the text */
+    template <class MDesType>
+    void
+    Reader< MDesType>::linkOpers()
+    {
+        OperationType *prev = NULL;
+
+        for ( UInt32 i = 0; i < opers.size(); i++)
+        {
+            OperationType *oper = opers_by_id[ opers[ i].id];
+
+            if ( isNullP( prev) )
+            {
+                func->setFirstOper( oper);
+            } else
+            {
+                oper->insertAfter( prev);
+            }
+            if ( opers[ i].node != READER_NO_ID)
+            {
+                nodes_by_id[ opers[ i].node]->extend( oper);
+            }
+            prev = oper;
+        }
+    }
+
+    /** Read operands of the operation */
+    template <class MDesType>
+    void
+    Reader< MDesType>::readOperands( OperationType *oper, const OperRec &rec)
+    {
+        const typename MDesType::OperDes *des = oper->archDes();
+        const char *p = rec.ops;
+        const char *e = rec.ops_end;
+        bool first = true;
+
+        line_num = rec.line;
+
+        /* Results are printed with '=' after them and symbols don't have it */
+        if ( isNotNullP( memchr( p, '=', e - p)) )
+        {
+            for ( UInt32 i = 0; i < des->num_ress; i++)
+            {
+                bool is_set = des->resDes( i)->canBeSet();
+
+                if ( !startOperand( p, e, first, is_set) )
+                    continue;
+
+                if ( is_set)
+                {
+                    readSet( oper, OPERAND_DIR_RES, p, e);
+                } else
+                {
+                    readOperand( oper, OPERAND_DIR_RES, i, p, e);
+                }
+                first = false;
+            }
+            expect( p, e, " =");
+        }
+        first = true;
+        for ( UInt32 i = 0; i < des->num_args; i++)
+        {
+            bool is_set = des->argDes( i)->canBeSet();
+
+            if ( !startOperand( p, e, first, is_set) )
+                continue;
+
+            if ( is_set)
+            {
+                readSet( oper, OPERAND_DIR_ARG, p, e);
+            } else
+            {
+                readOperand( oper, OPERAND_DIR_ARG, i, p, e);
+            }
+            first = false;
+        }
+        if ( p != e)
+        {
+            error( "Unexpected characters after the operands");
+        }
+    }
+
+    /**
+     * Step to the next operand of the group, returns false if the optional operand is not there.
+     * Operands are separated by ", ", the first one of the group by " ". Empty sets are not printed
+     */
+    template <class MDesType>
+    bool
+    Reader< MDesType>::startOperand( const char *&p, const char *e, bool first, bool is_set)
+    {
+        const char *q = p;
+        bool found = ( first || skip( q, e, ",") ) && skip( q, e, " ");
+
+        if ( is_set)
+        {
+            found = found && q != e && *q == '(';
+        } else if ( !found)
+        {
+            error( "Operand expected");
+        }
+        if ( found)
+        {
+            p = q;
+        }
+        return found;
+    }
+
+    /** Read the operand and set it to the operation */
+    template <class MDesType>
+    void
+    Reader< MDesType>::readOperand( OperationType *oper, OpDir dir, UInt32 i, const char *&p, const char *e)
+    {
+        const typename MDesType::OperDes *des = oper->archDes();
+        const OpDes *op_des = ( dir == OPERAND_DIR_ARG) ? des->argDes( i) : des->resDes( i);
+        Value val;
+
+        readValue( val, p, e);
+        switch ( val.type)
+        {
+            case OP_TYPE_OBJ:
+                if ( !op_des->isProperName( val.obj->type()) )
+                {
+                    error( "Object of this type can't be the operand");
+                }
+                if ( dir == OPERAND_DIR_ARG)
+                {
+                    oper->setArgObj( i, val.obj);
+                } else
+                {
+                    oper->setResObj( i, val.obj);
+                }
+                break;
+            case OP_TYPE_IMM:
+                if ( dir != OPERAND_DIR_ARG || !op_des->canBeImm() )
+                {
+                    error( "Operand can't be immediate");
+                }
+                oper->setArgImm( i, val.imm);
+                break;
+            case OP_TYPE_TARGET:
+                if ( dir != OPERAND_DIR_ARG || !op_des->canBeTarget() )
+                {
+                    error( "Operand can't be target");
+                }
+                if ( isNullP( val.target) )
+                {
+                    TargetFixup fixup = { oper, i, val.target_id, line_num };
+
+                    fixups.push_back( fixup);
+                } else
+                {
+                    oper->setArgTarget( i, val.target);
+                }
+                break;
+            default:
+                /* Unset operand */
+                break;
+        }
+    }
+
+    /** Read the parenthesized set and add it to the operation */
+    template <class MDesType>
+    void
+    Reader< MDesType>::readSet( OperationType *oper, OpDir dir, const char *&p, const char *e)
+    {
+        set_vals.clear();
+        expect( p, e, "(");
+        do
+        {
+            set_vals.push_back( Value());
+            readValue( set_vals.back(), p, e);
+            if ( set_vals.back().type != OP_TYPE_OBJ
+                 && ( dir != OPERAND_DIR_ARG || set_vals.back().type != OP_TYPE_IMM) )
+            {
+                error( "Operand can't be in the set");
+            }
+        } while ( skip( p, e, ", ") );
+        expect( p, e, ")");
+
+        /* The set is printed from the last added operand to the first one */
+        for ( UInt32 i = (UInt32)set_vals.size(); i-- > 0;)
+        {
+            if ( dir == OPERAND_DIR_RES)
+            {
+                oper->addResToSet( set_vals[ i].obj);
+            } else if ( set_vals[ i].type == OP_TYPE_OBJ)
+            {
+                oper->addArgToSet( set_vals[ i].obj);
+            } else
+            {
+                oper->addArgToSet( set_vals[ i].imm);
+            }
+        }
+    }
+
+    /** Read object, constant, target or unset operand */
+    template <class MDesType>
+    void
+    Reader< MDesType>::readValue( Value &val, const char *&p, const char *e)
+    {
+        if ( skip( p, e, "<label_") )
+        {
+            UInt32 id = readUInt( p, e);
+
+            expect( p, e, ">");
+            if ( id >= opers_by_id.size() )
+            {
+                error( "Target operation is not in the function");
+            }
+            val.type = OP_TYPE_TARGET;
+            val.target = opers_by_id[ id];
+            val.target_id = id;
+            return;
+        }
+        if ( skip( p, e, "{unset}") )
+        {
+            val.type = OP_TYPES_NUM;
+            return;
+        }
+
+        const char *end = p;
+
+        while ( end != e && *end != ',' && *end != ')' && *end != ' ')
+        {
+            end++;
+        }
+        if ( end == p)
+        {
+            error( "Operand expected");
+        }
+
+        const char *q = p;
+
+        if ( readObject( val.obj, q, end, true) )
+        {
+            val.type = OP_TYPE_OBJ;
+        } else if ( !readNumber( val, p, end) )
+        {
+            /* Symbols are printed with the names from the module's symbol table */
+            val.type = OP_TYPE_IMM;
+            val.imm = Const( module->symbols().intern( p, (UInt32)( end - p)));
+        }
+        p = end;
+    }
+
+    /** Read constant, returns false if the characters are not a number */
+    template <class MDesType>
+    bool
+    Reader< MDesType>::readNumber( Value &val, const char *p, const char *e)
+    {
+        const char *q = p;
+        bool is_neg = skip( q, e, "-");
+        const char *digits = q;
+        const UInt64 limit = is_neg ? (UInt64)1 << 63 : ( (UInt64)1 << 63) - 1;
+        UInt64 abs_val = 0;
+
+        if ( q == e || ( ( *q < '0' || *q > '9') && *q != '.' && *q != 'i' && *q != 'n') )
+        {
+            return false;
+        }
+        for ( ; q != e && *q >= '0' && *q <= '9'; q++)
+        {
+            UInt64 digit = (UInt64)( *q - '0');
+
+            if ( abs_val > ( limit - digit) / 10)
+            {
+                error( "Integer constant is too large");
+            }
+            abs_val = abs_val * 10 + digit;
+        }
+        if ( q == e && q != digits)
+        {
+            val.type = OP_TYPE_IMM;
+            val.imm = Const( is_neg ? (Int64)( 0 - abs_val) : (Int64)abs_val);
+            return true;
+        }
+
+        /* Floating point constant including inf and nan, copied since the text has no terminating zero */
+        char buf[ 64];
+        char *end = NULL;
+
+        if ( e - p >= (ptrdiff_t)sizeof( buf) )
+        {
+            return false;
+        }
+        memcpy( buf, p, e - p);
+        buf[ e - p] = 0;
+
+        Double d_val = strtod( buf, &end);
+
+        if ( end != buf + ( e - p) )
+        {
+            return false;
+        }
+        val.type = OP_TYPE_IMM;
+        val.imm = Const( d_val);
+        return true;
+    }
+
+    /**
+     * Read object, returns false if the characters at p are not an object or if the object doesn't
+     * end at e when it must. The object is created only when it is read
+     */
+    template <class MDesType>
+    bool
+    Reader< MDesType>::readObject( Object< MDesType> *&obj, const char *&p, const char *e, bool to_end)
+    {
+        for ( UInt32 t = 0; t < MDesType::num_objs; t++)
+        {
+            const char *prefix = MDesType::objectDescription( (ObjectName)t)->prefix;
+
+            /* Virtual objects are printed with 'v' before the prefix */
+            for ( UInt32 is_virtual = 0; is_virtual < 2; is_virtual++)
+            {
+                const char *q = p;
+
+                if ( is_virtual && !skip( q, e, "v") )
+                    continue;
+
+                if ( (size_t)( e - q) <= prefix_lens[ t]
+                     || memcmp( q, prefix, prefix_lens[ t]) != 0
+                     || q[ prefix_lens[ t]] < '0' || q[ prefix_lens[ t]] > '9' )
+                {
+                    continue;
+                }
+                q += prefix_lens[ t];
+
+                /* Symbols can start like objects, so the whole id is checked before creating anything */
+                const char *id = q;
+
+                while ( q != e && *q >= '0' && *q <= '9')
+                {
+                    q++;
+                }
+                if ( to_end && q != e)
+                    continue;
+
+                obj = object( (ObjectName)t, readId( id, q));
+                obj->setVirtual( is_virtual != 0);
+                p = q;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /** Get object by type and id creating the missing objects of the type */
+    template <class MDesType>
+    Object< MDesType> *
+    Reader< MDesType>::object( ObjectName type, UInt32 id)
+    {
+        while ( func->numObjects( type) <= id)
+        {
+            func->newObject( type);
+        }
+        return func->object( type, id);
+    }
+}
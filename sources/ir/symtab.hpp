@@ -0,0 +1,223 @@
+/**
+ * @file: ir/symtab.hpp
+ * Interned symbols and symbol table
+ * @ingroup IR
+ */
+ /*
+  * Copyright 2012 MIPT-COMPILER team
+  */
+
+#pragma once
+
+namespace IR
+{
+    /** Id of the symbol that is not in any table */
+    const UInt32 SYMBOL_NO_ID = (UInt32)-1;
+
+    /**
+     * Interned symbol. The symbol is just an id of the string in the symbol table,
+     * so symbols are copied and compared as integers
+     * @ingroup IR
+     */
+    class Symbol
+    {
+    public:
+        inline Symbol();                  /**< Create invalid symbol */
+        inline explicit Symbol( UInt32 id); /**< Create symbol with the given id */
+
+        inline UInt32 id() const;      /**< Get symbol id */
+        inline bool isValid() const;   /**< Check that the symbol refers to a string */
+
+        inline bool operator == ( const Symbol &sym) const; /**< Symbols are equal if their ids are equal */
+        inline bool operator != ( const Symbol &sym) const; /**< Symbols differ if their ids differ */
+    private:
+        UInt32 id_; /**< Index of the string in the symbol table */
+    };
+
+    /**
+     * Symbol table keeps one copy of every string and gives out symbols for them.
+     * The symbols are never removed from the table so they are stable during its lifetime.
+     * Lookup is done in the open addressing hash table of symbol ids with FNV-1a hash of the strings
+     * @ingroup IR
+     */
+    class SymbolTable
+    {
+    public:
+        inline SymbolTable(); /**< Create empty table */
+
+        inline Symbol intern( const string &str);                /**< Get symbol of the string, add the string if needed */
+        inline Symbol intern( const char *chars, UInt32 len);    /**< Get symbol of the characters, add them if needed */
+        inline Symbol find( const string &str) const;             /**< Get symbol of the string or invalid symbol if there is no one */
+        inline Symbol find( const char *chars, UInt32 len) const; /**< Get symbol of the characters or invalid symbol */
+        inline const string &str( Symbol sym) const;              /**< Get string of the symbol */
+        inline UInt32 numSymbols() const;                         /**< Get number of symbols in the table */
+
+        /** FNV-1a hash of the characters */
+        static inline UInt32 hash( const char *chars, UInt32 len);
+    private:
+        /** Get the slot of the characters, the slot is either empty or holds their symbol */
+        inline UInt32 slot( const char *chars, UInt32 len, UInt32 h) const;
+        /** Double the number of slots and put the symbols into them again */
+        inline void grow();
+
+        vector< string> strings; /**< Strings indexed by symbol ids      */
+        vector< UInt32> hashes;  /**< Hashes of strings indexed by symbol ids */
+        vector< UInt32> slots;   /**< Symbol ids placed by hash, SYMBOL_NO_ID in empty slot */
+    };
+
+    /** Initial number of slots in symbol table, must be a power of two */
+    const UInt32 SYMTAB_INITIAL_SLOTS = 64;
+
+    /** Create invalid symbol */
+    Symbol::Symbol(): id_( SYMBOL_NO_ID)
+    {
+    }
+
+    /** Create symbol with the given id */
+    Symbol::Symbol( UInt32 id): id_( id)
+    {
+    }
+
+    /** Get symbol id */
+    UInt32 Symbol::id() const
+    {
+        return id_;
+    }
+
+    /** Check that the symbol refers to a string */
+    bool Symbol::isValid() const
+    {
+        return id_ != SYMBOL_NO_ID;
+    }
+
+    /** Symbols are equal if their ids are equal */
+    bool Symbol::operator == ( const Symbol &sym) const
+    {
+        return id_ == sym.id_;
+    }
+
+    /** Symbols differ if their ids differ */
+    bool Symbol::operator != ( const Symbol &sym) const
+    {
+        return id_ != sym.id_;
+    }
+
+    /** Create empty table */
+    SymbolTable::SymbolTable(): slots( SYMTAB_INITIAL_SLOTS, SYMBOL_NO_ID)
+    {
+    }
+
+    /** FNV-1a hash of the characters */
+    UInt32 SymbolTable::hash( const char *chars, UInt32 len)
+    {
+        UInt32 h = 2166136261U;
+
+        for ( UInt32 i = 0; i < len; i++)
+        {
+            h ^= (UInt8)chars[ i];
+            h *= 16777619U;
+        }
+        return h;
+    }
+
+    /** Get the slot of the characters, the slot is either empty or holds their symbol */
+    UInt32 SymbolTable::slot( const char *chars, UInt32 len, UInt32 h) const
+    {
+        UInt32 mask = (UInt32)slots.size() - 1;
+        UInt32 i = h & mask;
+
+        /* Linear probing, the table is never more than half full so the loop terminates */
+        while ( slots[ i] != SYMBOL_NO_ID)
+        {
+            UInt32 id = slots[ i];
+
+            if ( hashes[ id] == h
+                 && strings[ id].size() == len
+                 && ( len == 0 || memcmp( strings[ id].data(), chars, len) == 0) )
+            {
+                break;
+            }
+            i = ( i + 1) & mask;
+        }
+        return i;
+    }
+
+    /** Double the number of slots and put the symbols into them again */
+    void SymbolTable::grow()
+    {
+        UInt32 mask = 2 * (UInt32)slots.size() - 1;
+
+        slots.assign( mask + 1, SYMBOL_NO_ID);
+        for ( UInt32 id = 0; id < (UInt32)strings.size(); id++)
+        {
+            UInt32 i = hashes[ id] & mask;
+
+            while ( slots[ i] != SYMBOL_NO_ID)
+            {
+                i = ( i + 1) & mask;
+            }
+            slots[ i] = id;
+        }
+    }
+
+    /** Get symbol of the characters, add them if needed */
+    Symbol SymbolTable::intern( const char *chars, UInt32 len)
+    {
+        UInt32 h = hash( chars, len);
+        UInt32 i = slot( chars, len, h);
+
+        if ( slots[ i] != SYMBOL_NO_ID)
+        {
+            return Symbol( slots[ i]);
+        }
+        UInt32 id = (UInt32)strings.size();
+
+        strings.push_back( string( chars, len));
+        hashes.push_back( h);
+        slots[ i] = id;
+
+        /* Keep the load factor under one half */
+        if ( 2 * strings.size() > slots.size() )
+        {
+            grow();
+        }
+        return Symbol( id);
+    }
+
+    /** Get symbol of the string, add the string if needed */
+    Symbol SymbolTable::intern( const string &str)
+    {
+        return intern( str.data(), (UInt32)str.size());
+    }
+
+    /** Get symbol of the characters or invalid symbol if there is no one */
+    Symbol SymbolTable::find( const char *chars, UInt32 len) const
+    {
+        UInt32 i = slot( chars, len, hash( chars, len));
+
+        if ( slots[ i] == SYMBOL_NO_ID)
+        {
+            return Symbol();
+        }
+        return Symbol( slots[ i]);
+    }
+
+    /** Get symbol of the string or invalid symbol if there is no one */
+    Symbol SymbolTable::find( const string &str) const
+    {
+        return find( str.data(), (UInt32)str.size());
+    }
+
+    /** Get string of the symbol */
+    const string &SymbolTable::str( Symbol sym) const
+    {
+        IR_ASSERTXD( sym.id() < strings.size(), "Symbol is not in the table");
+        return strings[ sym.id()];
+    }
+
+    /** Get number of symbols in the table */
+    UInt32 SymbolTable::numSymbols() const
+    {
+        return (UInt32)strings.size();
+    }
+};
@@ -0,0 +1,255 @@
+/**
+ * @file: ir/thread.cpp
+ * Implementation of mutexes and thread pool
+ * @ingroup IR
+ */
+ /*
+  * Copyright 2012 MIPT-COMPILER team
+  */
+#include "ir_iface.hpp"
+
+#if defined(_WIN32)
+#  include <windows.h>
+#  include <process.h>
+#else
+#  include <pthread.h>
+#  include <unistd.h>
+#endif
+
+namespace IR
+{
+#if defined(_WIN32)
+    Mutex::Mutex(): impl( new CRITICAL_SECTION)
+    {
+        InitializeCriticalSection( static_cast< CRITICAL_SECTION *>( impl));
+    }
+
+    Mutex::~Mutex()
+    {
+        DeleteCriticalSection( static_cast< CRITICAL_SECTION *>( impl));
+        delete static_cast< CRITICAL_SECTION *>( impl);
+    }
+
+    /** Wait for the mutex and take it */
+    void Mutex::lock()
+    {
+        EnterCriticalSection( static_cast< CRITICAL_SECTION *>( impl));
+    }
+
+    /** Release the mutex */
+    void Mutex::unlock()
+    {
+        LeaveCriticalSection( static_cast< CRITICAL_SECTION *>( impl));
+    }
+
+    CondVar::CondVar(): impl( new CONDITION_VARIABLE)
+    {
+        InitializeConditionVariable( static_cast< CONDITION_VARIABLE *>( impl));
+    }
+
+    CondVar::~CondVar()
+    {
+        delete static_cast< CONDITION_VARIABLE *>( impl);
+    }
+
+    /** Release the mutex, wait for a signal and take the mutex again */
+    void CondVar::wait( Mutex &m)
+    {
+        SleepConditionVariableCS( static_cast< CONDITION_VARIABLE *>( impl),
+                                  static_cast< CRITICAL_SECTION *>( m.impl), INFINITE);
+    }
+
+    /** Wake all the waiting threads */
+    void CondVar::signalAll()
+    {
+        WakeAllConditionVariable( static_cast< CONDITION_VARIABLE *>( impl));
+    }
+#else
+    Mutex::Mutex(): impl( new pthread_mutex_t)
+    {
+        pthread_mutex_init( static_cast< pthread_mutex_t *>( impl), NULL);
+    }
+
+    Mutex::~Mutex()
+    {
+        pthread_mutex_destroy( static_cast< pthread_mutex_t *>( impl));
+        delete static_cast< pthread_mutex_t *>( impl);
+    }
+
+    /** Wait for the mutex and take it */
+    void Mutex::lock()
+    {
+        pthread_mutex_lock( static_cast< pthread_mutex_t *>( impl));
+    }
+
+    /** Release the mutex */
+    void Mutex::unlock()
+    {
+        pthread_mutex_unlock( static_cast< pthread_mutex_t *>( impl));
+    }
+
+    CondVar::CondVar(): impl( new pthread_cond_t)
+    {
+        pthread_cond_init( static_cast< pthread_cond_t *>( impl), NULL);
+    }
+
+    CondVar::~CondVar()
+    {
+        pthread_cond_destroy( static_cast< pthread_cond_t *>( impl));
+        delete static_cast< pthread_cond_t *>( impl);
+    }
+
+    /** Release the mutex, wait for a signal and take the mutex again */
+    void CondVar::wait( Mutex &m)
+    {
+        pthread_cond_wait( static_cast< pthread_cond_t *>( impl), static_cast< pthread_mutex_t *>( m.impl));
+    }
+
+    /** Wake all the waiting threads */
+    void CondVar::signalAll()
+    {
+        pthread_cond_broadcast( static_cast< pthread_cond_t *>( impl));
+    }
+#endif
+
+    /** Entry of the pool's threads */
+    struct ThreadStart
+    {
+#if defined(_WIN32)
+        static unsigned __stdcall run( void *pool)
+#else
+        static void *run( void *pool)
+#endif
+        {
+            static_cast< ThreadPool *>( pool)->workerLoop();
+            return 0;
+        }
+    };
+
+    /** Get number of the processors of the system */
+    UInt32 ThreadPool::numProcessors()
+    {
+#if defined(_WIN32)
+        SYSTEM_INFO info;
+
+        GetSystemInfo( &info);
+        return max< UInt32>( 1, (UInt32)info.dwNumberOfProcessors);
+#else
+        long num = sysconf( _SC_NPROCESSORS_ONLN);
+
+        return num > 0 ? (UInt32)num : 1;
+#endif
+    }
+
+    /** Create pool of the given number of threads including the calling one, 0 for the number of processors */
+    ThreadPool::ThreadPool( UInt32 num):
+        num_threads( num > 0 ? num : numProcessors()), task( NULL), num_items( 0), next_item( 0), busy( 0),
+        generation( 0), stop( false)
+    {
+        /* If the system can't create more threads the pool works with the ones it has */
+        for ( UInt32 i = 1; i < num_threads; i++)
+        {
+#if defined(_WIN32)
+            uintptr_t thread = _beginthreadex( NULL, 0, &ThreadStart::run, this, 0, NULL);
+
+            if ( thread == 0 )
+                break;
+
+            threads.push_back( reinterpret_cast< void *>( thread));
+#else
+            pthread_t *thread = new pthread_t;
+
+            if ( pthread_create( thread, NULL, &ThreadStart::run, this) != 0 )
+            {
+                delete thread;
+                break;
+            }
+            threads.push_back( thread);
+#endif
+        }
+        num_threads = (UInt32)threads.size() + 1;
+    }
+
+    /** Stop and join the threads */
+    ThreadPool::~ThreadPool()
+    {
+        {
+            MutexLock lock( mutex);
+
+            stop = true;
+            work_cond.signalAll();
+        }
+        for ( UInt32 i = 0; i < threads.size(); i++)
+        {
+#if defined(_WIN32)
+            WaitForSingleObject( static_cast< HANDLE>( threads[ i]), INFINITE);
+            CloseHandle( static_cast< HANDLE>( threads[ i]));
+#else
+            pthread_join( *static_cast< pthread_t *>( threads[ i]), NULL);
+            delete static_cast< pthread_t *>( threads[ i]);
+#endif
+        }
+    }
+
+    /** Process the items of the current task until there are none left, the mutex is taken */
+    void ThreadPool::processItems()
+    {
+        busy++;
+        while ( next_item < num_items)
+        {
+            UInt32 item = next_item++;
+
+            mutex.unlock();
+            task->run( item);
+            mutex.lock();
+        }
+        busy--;
+        if ( busy == 0)
+        {
+            done_cond.signalAll();
+        }
+    }
+
+    /** Loop of the pool's thread: wait for a task and process its items */
+    void ThreadPool::workerLoop()
+    {
+        MutexLock lock( mutex);
+        UInt32 seen = generation;
+
+        while ( true)
+        {
+            while ( !stop && generation == seen)
+            {
+                work_cond.wait( mutex);
+            }
+            if ( stop)
+                break;
+
+            seen = generation;
+            if ( isNotNullP( task) )
+            {
+                processItems();
+            }
+        }
+    }
+
+    /** Process items from 0 to num - 1 by all the threads, returns when all of them are done */
+    void ThreadPool::run( ParallelTask &t, UInt32 num)
+    {
+        MutexLock lock( mutex);
+
+        task = &t;
+        num_items = num;
+        next_item = 0;
+        generation++;
+        work_cond.signalAll();
+
+        /* The calling thread takes the items too */
+        processItems();
+        while ( busy > 0)
+        {
+            done_cond.wait( mutex);
+        }
+        task = NULL;
+    }
+}
@@ -0,0 +1,151 @@
+/**
+ * @file: ir/thread.hpp
+ * Mutexes and thread pool for processing functions of a module in parallel
+ * @ingroup IR
+ */
+ /*
+  * Copyright 2012 MIPT-COMPILER team
+  */
+
+#pragma once
+
+namespace IR
+{
+    /**
+     * @class Mutex
+     * @brief Mutual exclusion lock over the system's one
+     * @ingroup IR
+     */
+    class Mutex
+    {
+    public:
+        Mutex();
+        ~Mutex();
+
+        void lock();   /**< Wait for the mutex and take it */
+        void unlock(); /**< Release the mutex */
+    private:
+        friend class CondVar;
+
+        Mutex( const Mutex &);
+        Mutex &operator = ( const Mutex &);
+
+        void *impl; /**< System mutex */
+    };
+
+    /**
+     * @class MutexLock
+     * @brief Holds the mutex while it is in scope
+     * @ingroup IR
+     */
+    class MutexLock
+    {
+    public:
+        MutexLock( Mutex &m): mutex( m)
+        {
+            mutex.lock();
+        }
+        ~MutexLock()
+        {
+            mutex.unlock();
+        }
+    private:
+        MutexLock( const MutexLock &);
+        MutexLock &operator = ( const MutexLock &);
+
+        Mutex &mutex;
+    };
+
+    /**
+     * @class CondVar
+     * @brief Condition variable that is waited for with the mutex taken
+     * @ingroup IR
+     */
+    class CondVar
+    {
+    public:
+        CondVar();
+        ~CondVar();
+
+        void wait( Mutex &m); /**< Release the mutex, wait for a signal and take the mutex again */
+        void signalAll();     /**< Wake all the waiting threads */
+    private:
+        CondVar( const CondVar &);
+        CondVar &operator = ( const CondVar &);
+
+        void *impl; /**< System condition variable */
+    };
+
+    /**
+     * @class ParallelTask
+     * @brief Work split into the items that are processed independently
+     * @ingroup IR
+     */
+    class ParallelTask
+    {
+    public:
+        virtual ~ParallelTask(){}
+
+        /** Process the item with the given number, may be called from any thread of the pool */
+        virtual void run( UInt32 item) = 0;
+    };
+
+    /**
+     * @class ThreadPool
+     * @brief Threads that process the items of the tasks
+     *
+     * The threads are created once and sleep between the tasks. The items of the task are taken
+     * by the threads one by one in the order of their numbers, the thread that runs the task processes
+     * the items too and returns when all of them are done. So a pool of one thread runs the items
+     * in order on the calling thread. Tasks are run one at a time
+     * @ingroup IR
+     */
+    class ThreadPool
+    {
+    public:
+        /**
+         * Create pool of the given number of threads including the calling one, 0 for the number
+         * of processors. The pool has fewer threads if the system can't create all of them
+         */
+        ThreadPool( UInt32 num_threads = 0);
+        /** Stop and join the threads */
+        ~ThreadPool();
+
+        /** Process items from 0 to num - 1 by all the threads, returns when all of them are done */
+        void run( ParallelTask &task, UInt32 num);
+
+        /** Get number of the threads that process the items including the calling one */
+        inline UInt32 numThreads() const;
+
+        /** Get number of the processors of the system */
+        static UInt32 numProcessors();
+    private:
+        ThreadPool( const ThreadPool &);
+        ThreadPool &operator = ( const ThreadPool &);
+
+        /** Loop of the pool's thread */
+        void workerLoop();
+        /** Process the items of the current task until there are none left, the mutex is taken */
+        void processItems();
+
+        friend struct ThreadStart;
+
+        UInt32 num_threads;
+        vector< void *> threads; /**< System threads, the calling thread is not among them */
+        Mutex mutex;
+        CondVar work_cond;       /**< Signalled when a task is started or the pool is stopped */
+        CondVar done_cond;       /**< Signalled when the last item of the task is done */
+        ParallelTask *task;
+        UInt32 num_items;
+        UInt32 next_item;
+        UInt32 busy;             /**< Number of threads processing the items */
+        UInt32 generation;       /**< Number of the started tasks */
+        bool stop;
+    };
+
+    /** Get number of the threads that process the items including the calling one */
+    UInt32 ThreadPool::numThreads() const
+    {
+        return num_threads;
+    }
+}
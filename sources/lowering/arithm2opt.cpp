@@ -26,6 +26,18 @@ namespace Lowering
         {
             func->setFirstOper( func->newOper( Opt::Ret));
         }
+
+        //The code is straight-line so it makes one CF node
+        Opt::CFG &cfg = func->cfg();
+        Opt::CFNode *node = cfg.newNode();
+
+        for ( Opt::Oper *oper = func->firstOper(); oper; oper = static_cast< Opt::Oper *>( oper->nextOper()))
+        {
+            node->extend( oper);
+        }
+        cfg.newEdge( cfg.startNode(), node);
+        cfg.newEdge( node, cfg.stopNode());
+        cfg.setValid( true);
     }
 
     void ArithmConverter::doPre( TreeNode *node)
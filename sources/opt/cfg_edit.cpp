@@ -0,0 +1,168 @@
+/**
+ * @file: opt/cfg_edit.cpp
+ * Implementation of deletion of operations, edges and nodes
+ * @ingroup OPT
+ */
+ /*
+  * Copyright 2012 MIPT-COMPILER team
+  */
+#include "opt_iface.hpp"
+
+namespace Opt
+{
+    typedef IR::Operation< MDes> Operation;
+
+    /** Retarget the jumps of the node's predecessors from one operation to another */
+    static void retargetJumps( CFNode *node, Operation *from, Operation *to)
+    {
+        for ( CFEdge *e = node->firstPred(); isNotNullP( e); e = e->nextPred())
+        {
+            Operation *jump = e->srcOper();
+
+            if ( isNullP( jump) )
+                continue;
+
+            for ( UInt32 i = 0; i < jump->numArgs(); i++)
+            {
+                if ( jump->arg( i).isTarget() && areEqP( jump->arg( i).target(), from) )
+                {
+                    jump->setArgTarget( i, to);
+                }
+            }
+        }
+    }
+
+    /** Check that a jump of a predecessor node targets the operation */
+    bool isJumpTarget( Operation *oper)
+    {
+        IR_ASSERTD( isNotNullP( oper->node()));
+
+        for ( CFEdge *e = oper->node()->firstPred(); isNotNullP( e); e = e->nextPred())
+        {
+            Operation *jump = e->srcOper();
+
+            if ( isNullP( jump) )
+                continue;
+
+            for ( UInt32 i = 0; i < jump->numArgs(); i++)
+            {
+                if ( jump->arg( i).isTarget() && areEqP( jump->arg( i).target(), oper) )
+                    return true;
+            }
+        }
+        return false;
+    }
+
+    /** Delete the operation of the CF node, jumps to it are retargeted to the next operation of the node */
+    void removeOper( Function *f, Operation *oper)
+    {
+        IR_ASSERTD( isNotNullP( oper->node()));
+
+        if ( isNotNullP( oper->nextInNode()) )
+        {
+            retargetJumps( oper->node(), oper, oper->nextInNode());
+        } else
+        {
+            IR_ASSERTXD( !isJumpTarget( oper), "The only operation of the jump target node is deleted");
+        }
+        f->deleteOper( oper);
+    }
+
+    /** Delete the argument of the phi that comes along the predecessor edge with the given index */
+    Operation *removePhiArg( Function *f, Operation *phi, UInt32 index)
+    {
+        Oper *new_phi = f->newOperBefore( Phi, phi);
+
+        for ( UInt32 i = 0; i < phi->numArgsInSet(); i++)
+        {
+            if ( i == index )
+                continue;
+
+            if ( phi->argInSet( i).type() == OP_TYPE_OBJ )
+            {
+                new_phi->addArgToSet( phi->argInSet( i).object());
+            } else
+            {
+                new_phi->addArgToSet( phi->argInSet( i).constValue());
+            }
+        }
+        new_phi->setResObj( 0, phi->res( 0).object());
+        retargetJumps( phi->node(), phi, new_phi);
+        f->deleteOper( phi);
+        return new_phi;
+    }
+
+    /** Delete the CF edge together with the arguments of the successor's phis that come along it */
+    void removeEdge( Function *f, CFEdge *edge)
+    {
+        CFNode *succ = edge->succ();
+        UInt32 index = 0;
+
+        for ( CFEdge *e = succ->firstPred(); !areEqP( e, edge); e = e->nextPred())
+        {
+            index++;
+        }
+        for ( Operation *phi = succ->firstOper(); isPhi( phi); phi = phi->nextInNode())
+        {
+            phi = removePhiArg( f, phi, index);
+        }
+        f->cfg().deleteEdge( edge);
+    }
+
+    /** Delete the nodes that are not reachable from the start node with their operations and edges */
+    UInt32 removeUnreachableNodes( Function *f)
+    {
+        CFG &cfg = f->cfg();
+        Marker m = cfg.newMarker();
+        vector< CFNode *> stack( 1, cfg.startNode());
+        vector< CFNode *> dead;
+
+        cfg.startNode()->mark( m);
+        while ( !stack.empty() )
+        {
+            CFNode *node = stack.back();
+
+            stack.pop_back();
+            for ( CFEdge *e = node->firstSucc(); isNotNullP( e); e = e->nextSucc())
+            {
+                if ( e->succ()->mark( m) )
+                {
+                    stack.push_back( e->succ());
+                }
+            }
+        }
+        for ( CFNode *node = cfg.firstNode(); isNotNullP( node); node = node->nextNode())
+        {
+            if ( !node->isMarked( m) && !node->isStart() && !node->isStop() )
+            {
+                dead.push_back( node);
+            }
+        }
+        for ( UInt32 i = 0; i < dead.size(); i++)
+        {
+            CFEdge *e = dead[ i]->firstSucc();
+
+            /* Reachable successors lose the phi arguments of the edges */
+            while ( isNotNullP( e) )
+            {
+                CFEdge *next = e->nextSucc();
+
+                if ( e->succ()->isMarked( m) )
+                {
+                    removeEdge( f, e);
+                }
+                e = next;
+            }
+        }
+        for ( UInt32 i = 0; i < dead.size(); i++)
+        {
+            while ( isNotNullP( dead[ i]->firstOper()) )
+            {
+                f->deleteOper( dead[ i]->firstOper());
+            }
+            cfg.deleteNode( dead[ i]);
+        }
+        cfg.freeMarker( m);
+        return (UInt32)dead.size();
+    }
+}
@@ -0,0 +1,39 @@
+/**
+ * @file: opt/cfg_edit.hpp
+ * Deletion of operations, edges and nodes that keeps the jumps and phis of the function consistent
+ * @ingroup OPT
+ */
+ /*
+  * Copyright 2012 MIPT-COMPILER team
+  */
+#pragma once
+
+namespace Opt
+{
+    /** Check that a jump of a predecessor node targets the operation */
+    bool isJumpTarget( IR::Operation< MDes> *oper);
+
+    /**
+     * Delete the operation of the CF node. Jumps to it are retargeted to the next operation
+     * of the node, so the operation must not be the last one of the node if it is a jump target
+     */
+    void removeOper( Function *f, IR::Operation< MDes> *oper);
+
+    /**
+     * Delete the argument of the phi that comes along the predecessor edge with the given index.
+     * The phi is rebuilt, the new one is returned
+     */
+    IR::Operation< MDes> *removePhiArg( Function *f, IR::Operation< MDes> *phi, UInt32 index);
+
+    /**
+     * Delete the CF edge together with the arguments of the successor's phis that come along it.
+     * The jump of the edge is not changed
+     */
+    void removeEdge( Function *f, CFEdge *edge);
+
+    /**
+     * Delete the nodes that are not reachable from the start node with their operations and edges,
+     * the start and the stop nodes are kept. Returns the number of the deleted nodes
+     */
+    UInt32 removeUnreachableNodes( Function *f);
+}
@@ -0,0 +1,177 @@
+/**
+ * @file: opt/dce.cpp
+ * Implementation of dead code and unreachable node elimination
+ * @ingroup OPT
+ */
+ /*
+  * Copyright 2012 MIPT-COMPILER team
+  */
+#include "opt_iface.hpp"
+
+namespace Opt
+{
+    typedef IR::Operation< MDes> Operation;
+
+    /** Check that the operation has effects beyond its results */
+    static bool isRoot( Operation *oper)
+    {
+        switch ( oper->name())
+        {
+            case Ret:
+            case St:
+            case Call:
+                return true;
+            default:
+                return static_cast< Oper *>( oper)->isCf();
+        }
+    }
+
+    /** Mark the operation live and queue it */
+    static void markLive( Operation *oper, Marker live, vector< Operation *> &worklist)
+    {
+        if ( oper->mark( live) )
+        {
+            worklist.push_back( oper);
+        }
+    }
+
+    /** Make live the definitions of the object used by the live operation */
+    static void markDefs( const IR::Operand< MDes> &op, vector< bool> &obj_live,
+                          Marker live, vector< Operation *> &worklist)
+    {
+        if ( op.type() != OP_TYPE_OBJ )
+            return;
+
+        Obj *obj = op.object();
+
+        if ( obj->type() != Reg || obj_live[ obj->id()] )
+            return;
+
+        obj_live[ obj->id()] = true;
+        for ( UInt32 i = 0; i < obj->defs().size(); i++)
+        {
+            markLive( obj->defs()[ i].oper, live, worklist);
+        }
+    }
+
+    /** Check that the node with no live operations can be replaced by the edges to its only successor */
+    static bool canBypass( CFNode *node)
+    {
+        CFEdge *e = node->firstSucc();
+
+        if ( node->isStart() || node->isStop() || isNullP( e) || isNotNullP( e->nextSucc()) )
+            return false;
+
+        CFNode *succ = e->succ();
+
+        /* The phis of the successor would need an argument for every new edge */
+        if ( areEqP( succ, node) || isPhi( succ->firstOper()) )
+            return false;
+
+        if ( isNotNullP( succ->firstOper()) )
+            return true;
+
+        /* Jumps need an operation of the successor to target */
+        for ( CFEdge *pred = node->firstPred(); isNotNullP( pred); pred = pred->nextPred())
+        {
+            if ( isNotNullP( pred->srcOper()) )
+                return false;
+        }
+        return true;
+    }
+
+    /** Replace the node with the edges from its predecessors to its only successor and delete it */
+    static void bypassNode( Function *f, CFNode *node)
+    {
+        CFG &cfg = f->cfg();
+        CFNode *succ = node->firstSucc()->succ();
+
+        for ( CFEdge *e = node->firstPred(); isNotNullP( e); e = e->nextPred())
+        {
+            CFEdge *edge = cfg.newEdge( e->pred(), succ);
+            Operation *jump = e->srcOper();
+
+            if ( isNullP( jump) )
+                continue;
+
+            for ( UInt32 i = 0; i < jump->numArgs(); i++)
+            {
+                if ( jump->arg( i).isTarget() && areEqP( jump->arg( i).target()->node(), node) )
+                {
+                    jump->setArgTarget( i, succ->firstOper());
+                }
+            }
+            edge->setSrcOper( jump);
+        }
+        while ( isNotNullP( node->firstOper()) )
+        {
+            f->deleteOper( node->firstOper());
+        }
+        cfg.deleteNode( node);
+    }
+
+    /** Delete the operations that do not contribute to the function's effects and the unreachable nodes */
+    bool eliminateDeadCode( Function *f)
+    {
+        IR_ASSERTXD( f->cfg().isValid(), "Dead code elimination requires valid CFG");
+
+        CFG &cfg = f->cfg();
+        bool changed = removeUnreachableNodes( f) > 0;
+        Marker live = f->newMarker();
+        vector< Operation *> worklist;
+        vector< bool> obj_live( f->numObjects( Reg), false);
+        vector< CFNode *> nodes;
+
+        for ( CFNode *node = cfg.firstNode(); isNotNullP( node); node = node->nextNode())
+        {
+            nodes.push_back( node);
+            for ( Operation *oper = node->firstOper(); isNotNullP( oper); oper = oper->nextInNode())
+            {
+                if ( isRoot( oper) )
+                {
+                    markLive( oper, live, worklist);
+                }
+            }
+        }
+        while ( !worklist.empty() )
+        {
+            Operation *oper = worklist.back();
+
+            worklist.pop_back();
+            for ( UInt32 i = 0; i < oper->numArgs(); i++)
+            {
+                markDefs( oper->arg( i), obj_live, live, worklist);
+            }
+            for ( UInt32 i = 0; i < oper->numArgsInSet(); i++)
+            {
+                markDefs( oper->argInSet( i), obj_live, live, worklist);
+            }
+        }
+
+        /* Sweep, every node is deleted only when it is visited */
+        for ( UInt32 k = 0; k < nodes.size(); k++)
+        {
+            CFNode *node = nodes[ k];
+            Operation *oper = node->firstOper();
+
+            while ( isNotNullP( oper) )
+            {
+                Operation *next = oper->nextInNode();
+
+                if ( !oper->isMarked( live) && ( isNotNullP( next) || !isJumpTarget( oper)) )
+                {
+                    removeOper( f, oper);
+                    changed = true;
+                }
+                oper = next;
+            }
+            if ( ( isNullP( node->firstOper()) || !node->firstOper()->isMarked( live)) && canBypass( node) )
+            {
+                bypassNode( f, node);
+                changed = true;
+            }
+        }
+        f->freeMarker( live);
+        return changed;
+    }
+}
@@ -0,0 +1,26 @@
+/**
+ * @file: opt/dce.hpp
+ * Dead code and unreachable node elimination
+ * @ingroup OPT
+ */
+ /*
+  * Copyright 2012 MIPT-COMPILER team
+  */
+#pragma once
+
+namespace Opt
+{
+    /**
+     * Delete the operations that do not contribute to the function's effects and the nodes
+     * that can not be reached.
+     *
+     * The nodes unreachable from the start node are deleted first. Then Ret, St, Call and the control
+     * flow operations are marked live, and every live operation makes live all the definitions
+     * of the objects it uses, so every object and every definition is visited once. The unmarked
+     * operations are deleted. A node left without operations is replaced by the edges from its
+     * predecessors to its only successor, the jumps into it go to the successor then. The node is kept
+     * if the successor has phis, and the last operation of a kept node stays if the node is a jump target.
+     * The CFG must be valid. Returns true if the function is changed
+     */
+    bool eliminateDeadCode( Function *f);
+}
@@ -0,0 +1,325 @@
+/**
+ * @file: opt/deps.cpp
+ * Implementation of dependence graph construction
+ * @ingroup OPT
+ */
+ /*
+  * Copyright 2012 MIPT-COMPILER team
+  */
+#include "opt_iface.hpp"
+
+namespace Opt
+{
+    typedef IR::Operation< MDes> Operation;
+    typedef IR::DepEdge< MDes> DepEdge;
+
+    /** Stamp of the object that is not accessed in any node */
+    const UInt32 DEPS_NO_STAMP = (UInt32)-1;
+
+    /** Check that the operation reads memory */
+    static bool readsMem( Oper *oper)
+    {
+        return oper->isMemRead() || oper->name() == Call || oper->name() == Ret;
+    }
+
+    /** Check that the operation writes memory */
+    static bool writesMem( Oper *oper)
+    {
+        return oper->isMemWrite() || oper->name() == Call;
+    }
+
+    /** Get latency of the dependence that starts at the given operation */
+    static UInt32 depLatency( Oper *pred, DepType type)
+    {
+        switch ( type)
+        {
+        case DEP_TRUE:
+            return pred->archDes()->latency;
+        case DEP_ANTI:
+            /* Anti dependent operation may issue in the same cycle since arguments are read on issue */
+            return 0;
+        default:
+            return 1;
+        }
+    }
+
+    /** Number of kinds of dependences: the types through objects and through memory */
+    const UInt32 DEP_KINDS_NUM = 2 * DEP_TYPES_NUM;
+
+    /**
+     * Last accesses of the objects and memory in the node being processed.
+     *
+     * The tables for the whole function have entries for all its objects. The entries of an object
+     * are valid only if its stamp is equal to the stamp of the node, so the tables are not cleared
+     * between the nodes. The tables for one node add the entries of the objects as they are met,
+     * so their size depends on the node rather than on the function.
+     *
+     * Every new edge goes to the operation being processed, so a duplicate is found by remembering
+     * for every earlier operation of the node the last operation that got an edge of each kind from it
+     */
+    class DepTables
+    {
+    public:
+        DepTables( Function *f, bool all_objects); /**< Create tables for all objects of the function or for one node */
+        ~DepTables();
+
+        void startNode( UInt32 stamp);         /**< Start the node with the new stamp */
+        void startOper( Oper *oper);           /**< Start the next operation of the node */
+        void read( Oper *oper, Obj *obj);      /**< Operation reads the object  */
+        void write( Oper *oper, Obj *obj);     /**< Operation writes the object */
+        void readMem( Oper *oper);             /**< Operation reads memory      */
+        void writeMem( Oper *oper);            /**< Operation writes memory     */
+    private:
+        DepTables( const DepTables &);
+        DepTables &operator = ( const DepTables &);
+
+        /** Add the dependence unless the same one exists */
+        void addDep( Oper *pred, Oper *succ, DepType type, bool is_mem);
+        /** Get index of the object's entries valid for the current node */
+        UInt32 entry( Obj *obj);
+
+        Function *func;
+        bool all_objects;
+        UInt32 cur_stamp;
+        UInt32 offsets[ OPT_OBJECTS_NUM]; /**< Index of the first entry of every object type */
+        map< Obj *, UInt32> node_entries; /**< Entries of the objects of the node in the tables for one node */
+        vector< UInt32> stamps;           /**< Stamps of the objects */
+        vector< Oper *> last_defs;        /**< Last writes of the objects */
+        vector< vector< Oper *> > last_uses; /**< Reads after the last writes of the objects */
+        Oper *last_mem_write;       /**< Last memory write in the node */
+        vector< Oper *> mem_reads;  /**< Memory reads after the last memory write */
+        Numeration pos;             /**< Positions of the operations in the node */
+        GraphNum num_opers;         /**< Number of the operations of the node started so far */
+        vector< GraphNum> last_succs; /**< Position + 1 of the last successor by the predecessor's position and edge kind */
+    };
+
+    /** Create tables for all objects of the function or for one node */
+    DepTables::DepTables( Function *f, bool all):
+        func( f), all_objects( all), cur_stamp( DEPS_NO_STAMP), last_mem_write( NULL),
+        pos( f->newNum()), num_opers( 0)
+    {
+        UInt32 num = 0;
+
+        for ( UInt32 i = 0; i < OPT_OBJECTS_NUM; i++)
+        {
+            offsets[ i] = num;
+            num += f->numObjects( (OptObjectName)i);
+        }
+        if ( all_objects )
+        {
+            stamps.resize( num, DEPS_NO_STAMP);
+            last_defs.resize( num, NULL);
+            last_uses.resize( num);
+        }
+    }
+
+    DepTables::~DepTables()
+    {
+        func->freeNum( pos);
+    }
+
+    /** Start the node with the new stamp */
+    void DepTables::startNode( UInt32 stamp)
+    {
+        cur_stamp = stamp;
+        last_mem_write = NULL;
+        mem_reads.clear();
+        num_opers = 0;
+        last_succs.clear();
+        if ( !all_objects )
+        {
+            node_entries.clear();
+            last_defs.clear();
+            last_uses.clear();
+        }
+    }
+
+    /** Start the next operation of the node */
+    void DepTables::startOper( Oper *oper)
+    {
+        oper->setNumber( pos, num_opers++);
+        last_succs.resize( num_opers * DEP_KINDS_NUM, 0);
+    }
+
+    /** Get index of the object's entries valid for the current node */
+    UInt32 DepTables::entry( Obj *obj)
+    {
+        if ( !all_objects )
+        {
+            pair< map< Obj *, UInt32>::iterator, bool> res =
+                node_entries.insert( make_pair( obj, (UInt32)last_defs.size()));
+
+            if ( res.second )
+            {
+                last_defs.push_back( NULL);
+                last_uses.push_back( vector< Oper *>());
+            }
+            return res.first->second;
+        }
+
+        UInt32 i = offsets[ obj->type()] + obj->id();
+
+        IR_ASSERTD( i < stamps.size());
+        if ( stamps[ i] != cur_stamp)
+        {
+            stamps[ i] = cur_stamp;
+            last_defs[ i] = NULL;
+            last_uses[ i].clear();
+        }
+        return i;
+    }
+
+    /** Add the dependence unless the same one exists */
+    void DepTables::addDep( Oper *pred, Oper *succ, DepType type, bool is_mem)
+    {
+        if ( areEqP( pred, succ) )
+            return;
+
+        GraphNum &last = last_succs[ pred->number( pos) * DEP_KINDS_NUM + type * 2 + ( is_mem ? 1 : 0)];
+
+        if ( last == succ->number( pos) + 1 )
+            return;
+
+        last = succ->number( pos) + 1;
+        func->newDep( pred, succ, type, is_mem, depLatency( pred, type));
+    }
+
+    /** Operation reads the object */
+    void DepTables::read( Oper *oper, Obj *obj)
+    {
+        UInt32 i = entry( obj);
+
+        if ( isNotNullP( last_defs[ i]) )
+        {
+            addDep( last_defs[ i], oper, DEP_TRUE, false);
+        }
+        if ( last_uses[ i].empty() || !areEqP( last_uses[ i].back(), oper) )
+        {
+            last_uses[ i].push_back( oper);
+        }
+    }
+
+    /** Operation writes the object */
+    void DepTables::write( Oper *oper, Obj *obj)
+    {
+        UInt32 i = entry( obj);
+        vector< Oper *> &uses = last_uses[ i];
+
+        for ( UInt32 k = 0; k < uses.size(); k++)
+        {
+            addDep( uses[ k], oper, DEP_ANTI, false);
+        }
+        if ( isNotNullP( last_defs[ i]) )
+        {
+            addDep( last_defs[ i], oper, DEP_OUTPUT, false);
+        }
+        uses.clear();
+        last_defs[ i] = oper;
+    }
+
+    /** Operation reads memory */
+    void DepTables::readMem( Oper *oper)
+    {
+        if ( isNotNullP( last_mem_write) )
+        {
+            addDep( last_mem_write, oper, DEP_TRUE, true);
+        }
+        mem_reads.push_back( oper);
+    }
+
+    /** Operation writes memory */
+    void DepTables::writeMem( Oper *oper)
+    {
+        for ( UInt32 i = 0; i < mem_reads.size(); i++)
+        {
+            addDep( mem_reads[ i], oper, DEP_ANTI, true);
+        }
+        if ( isNotNullP( last_mem_write) )
+        {
+            addDep( last_mem_write, oper, DEP_OUTPUT, true);
+        }
+        mem_reads.clear();
+        last_mem_write = oper;
+    }
+
+    /** Build dependence edges among the operations of the node using the given tables */
+    static void buildNodeDeps( DepTables &tables, CFNode *node, UInt32 stamp)
+    {
+        tables.startNode( stamp);
+        for ( Operation *operation = node->firstOper();
+              isNotNullP( operation);
+              operation = operation->nextInNode())
+        {
+            Oper *oper = static_cast< Oper *>( operation);
+
+            tables.startOper( oper);
+
+            /* Arguments are read before results are written */
+            for ( UInt32 i = 0; i < oper->numArgs(); i++)
+            {
+                if ( oper->arg( i).type() == OP_TYPE_OBJ )
+                {
+                    tables.read( oper, oper->arg( i).object());
+                }
+            }
+            for ( UInt32 i = 0; i < oper->numArgsInSet(); i++)
+            {
+                if ( oper->argInSet( i).type() == OP_TYPE_OBJ )
+                {
+                    tables.read( oper, oper->argInSet( i).object());
+                }
+            }
+            if ( readsMem( oper) )
+            {
+                tables.readMem( oper);
+            }
+            for ( UInt32 i = 0; i < oper->numRess(); i++)
+            {
+                if ( oper->res( i).type() == OP_TYPE_OBJ )
+                {
+                    tables.write( oper, oper->res( i).object());
+                }
+            }
+            for ( UInt32 i = 0; i < oper->numRessInSet(); i++)
+            {
+                tables.write( oper, oper->resInSet( i).object());
+            }
+            if ( writesMem( oper) )
+            {
+                tables.writeMem( oper);
+            }
+        }
+    }
+
+    /** Build dependence edges among the operations of the node, the work depends only on the node's size */
+    void buildNodeDeps( Function *f, CFNode *node)
+    {
+        DepTables tables( f, false);
+
+        for ( Operation *oper = node->firstOper(); isNotNullP( oper); oper = oper->nextInNode())
+        {
+            f->removeDeps( static_cast< Oper *>( oper));
+        }
+        buildNodeDeps( tables, node, 0);
+    }
+
+    /**
+     * Build dependence edges among the operations of every CF node of the function.
+     *
+     * Operations are visited in order and every access is checked only against the last write
+     * of the accessed object or memory and the reads after it, and duplicate edges are found
+     * without looking at the existing ones. So the work is linear in the number of operands and
+     * created edges rather than quadratic in the number of operations
+     */
+    void buildDeps( Function *f)
+    {
+        DepTables tables( f, true);
+        UInt32 stamp = 0;
+
+        f->clearDeps();
+        for ( CFNode *node = f->cfg().firstNode(); isNotNullP( node); node = node->nextNode())
+        {
+            buildNodeDeps( tables, node, stamp++);
+        }
+    }
+}
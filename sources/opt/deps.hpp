@@ -0,0 +1,25 @@
+/**
+ * @file: opt/deps.hpp
+ * Construction of the dependence graph of optimizer's IR
+ * @ingroup OPT
+ */
+ /*
+  * Copyright 2012 MIPT-COMPILER team
+  */
+#pragma once
+
+namespace Opt
+{
+    /**
+     * Build dependence edges among the operations of every CF node of the function.
+     * The old dependence edges are deleted. Edges go from the earlier operation to the later one:
+     * true, anti and output dependences through objects and the same ones through memory
+     * between memory reads and writes. Calls are treated as both memory reads and writes
+     * and returns as memory reads. True dependences take the latency of the predecessor from MDes,
+     * anti dependences take no cycles and output dependences take one cycle
+     */
+    void buildDeps( Function *f);
+
+    /** Build dependence edges among the operations of the node */
+    void buildNodeDeps( Function *f, CFNode *node);
+}
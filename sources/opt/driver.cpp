@@ -0,0 +1,84 @@
+/**
+ * @file: opt/driver.cpp
+ * Implementation of parallel optimization of the module's functions
+ * @ingroup OPT
+ */
+ /*
+  * Copyright 2012 MIPT-COMPILER team
+  */
+#include "opt_iface.hpp"
+
+namespace Opt
+{
+    /** Running of the pipeline over one function, the printed functions are kept in the module's order */
+    class PipelineTask: public IR::ParallelTask
+    {
+    public:
+        PipelineTask( const vector< FunctionPass> &p, const vector< Function *> &f, vector< string> *t):
+            passes( p), funcs( f), texts( t){}
+
+        void run( UInt32 item)
+        {
+            for ( UInt32 i = 0; i < passes.size(); i++)
+            {
+                passes[ i]( funcs[ item]);
+            }
+            if ( isNotNullP( texts) )
+            {
+                std::ostringstream os;
+
+                os << funcs[ item];
+                ( *texts)[ item] = os.str();
+            }
+        }
+    private:
+        const vector< FunctionPass> &passes;
+        const vector< Function *> &funcs;
+        vector< string> *texts;
+    };
+
+    /** Create driver running on the given number of threads, 0 for the number of processors */
+    ModuleDriver::ModuleDriver( UInt32 num_threads): pool( num_threads)
+    {
+    }
+
+    /** Add pass to the end of the pipeline */
+    void ModuleDriver::addPass( FunctionPass pass)
+    {
+        passes.push_back( pass);
+    }
+
+    /** Get number of the threads the functions are processed by */
+    UInt32 ModuleDriver::numThreads() const
+    {
+        return pool.numThreads();
+    }
+
+    /** Run the pipeline over the functions, print each function after it if the stream is given */
+    void ModuleDriver::run( Module *m, ostream *os)
+    {
+        vector< Function *> funcs;
+        vector< string> texts;
+
+        for ( Function *f = m->firstFunction(); isNotNullP( f); f = f->next())
+        {
+            funcs.push_back( f);
+        }
+        if ( isNotNullP( os) )
+        {
+            texts.resize( funcs.size());
+        }
+#ifdef _DEBUG
+        UInt32 num_symbols = m->symbols().numSymbols();
+#endif
+        PipelineTask task( passes, funcs, isNotNullP( os) ? &texts : NULL);
+
+        pool.run( task, (UInt32)funcs.size());
+        IR_ASSERTXD( m->symbols().numSymbols() == num_symbols, "Function passes must not add symbols to the module");
+
+        for ( UInt32 i = 0; i < texts.size(); i++)
+        {
+            *os << texts[ i];
+        }
+    }
+}
@@ -0,0 +1,46 @@
+/**
+ * @file: opt/driver.hpp
+ * Parallel optimization of the module's functions
+ * @ingroup OPT
+ */
+ /*
+  * Copyright 2012 MIPT-COMPILER team
+  */
+#pragma once
+
+namespace Opt
+{
+    /** Pass that transforms one function, returns true if the function is changed */
+    typedef bool (*FunctionPass)( Function *f);
+
+    /**
+     * @class ModuleDriver
+     * @brief Runs the pipeline of function passes over all functions of the module on a thread pool
+     *
+     * Every function goes through the whole pipeline on one thread, different functions go
+     * in parallel. The functions keep their IR in their own pools and arena and the MDes tables are
+     * constants, so the passes need no locks as long as they change only the given function.
+     * They must not create or remove functions and must not add symbols to the module's table.
+     * The result doesn't depend on the number of threads: the functions are printed
+     * in the order of the module's list whichever thread processed them
+     * @ingroup OPT
+     */
+    class ModuleDriver
+    {
+    public:
+        /** Create driver running on the given number of threads, 0 for the number of processors */
+        ModuleDriver( UInt32 num_threads = 0);
+
+        /** Add pass to the end of the pipeline */
+        void addPass( FunctionPass pass);
+
+        /** Run the pipeline over the functions, print each function after it if the stream is given */
+        void run( Module *m, ostream *os = NULL);
+
+        /** Get number of the threads the functions are processed by */
+        UInt32 numThreads() const;
+    private:
+        vector< FunctionPass> passes;
+        IR::ThreadPool pool;
+    };
+}
@@ -0,0 +1,397 @@
+/**
+ * @file: opt/gvn.cpp
+ * Implementation of dominator-based global value numbering
+ * @ingroup OPT
+ */
+ /*
+  * Copyright 2012 MIPT-COMPILER team
+  */
+#include "opt_iface.hpp"
+#include <string.h>
+
+namespace Opt
+{
+    typedef IR::Operation< MDes> Operation;
+    typedef IR::Operand< MDes> Operand;
+
+    /** Index of the entry that ends a chain of the expression table */
+    const UInt32 GVN_NO_ENTRY = (UInt32)-1;
+
+    /** Initial number of chains in the expression table, must be a power of two */
+    const UInt32 GVN_INITIAL_BUCKETS = 64;
+
+    /** Tags of the operands in the expression keys */
+    enum GVNKeyTag
+    {
+        GVN_KEY_OBJ,
+        GVN_KEY_INT,
+        GVN_KEY_FLOAT,
+        GVN_KEY_SYMBOL
+    };
+
+    /** Expression of the table and the object that holds its value */
+    struct ExprEntry
+    {
+        UInt32 hash;
+        UInt32 key_start; /**< Index of the first word of the key in the table's words */
+        UInt32 key_len;
+        UInt32 next;      /**< Entry inserted earlier into the same chain */
+        Obj *value;
+    };
+
+    /**
+     * @class ExprTable
+     * @brief Hash table of the available expressions with the scopes of the dominator tree
+     *
+     * Entries are kept in the order of insertion and every chain goes from the latest entry to the
+     * earliest one, so removing the latest entries restores the heads of their chains. Keys of
+     * the entries are stored one after another in one array of words
+     */
+    class ExprTable
+    {
+    public:
+        ExprTable(): buckets( GVN_INITIAL_BUCKETS, GVN_NO_ENTRY){}
+
+        /** Get the value of the expression, NULL if it is not available */
+        Obj *find( const vector< UInt64> &key, UInt32 h) const;
+
+        /** Make the expression available with the given value */
+        void insert( const vector< UInt64> &key, UInt32 h, Obj *value);
+
+        /** Get number of the entries, it marks the start of the scope */
+        UInt32 size() const { return (UInt32)entries.size(); }
+
+        /** Remove the entries inserted after the table had the given size */
+        void popTo( UInt32 num);
+    private:
+        /** Double the number of the chains and link the entries into them again */
+        void grow();
+
+        vector< ExprEntry> entries;
+        vector< UInt64> words;
+        vector< UInt32> buckets; /**< Latest entries of the chains */
+    };
+
+    /** Get the value of the expression, NULL if it is not available */
+    Obj *ExprTable::find( const vector< UInt64> &key, UInt32 h) const
+    {
+        for ( UInt32 i = buckets[ h & ( buckets.size() - 1)]; i != GVN_NO_ENTRY; i = entries[ i].next)
+        {
+            const ExprEntry &e = entries[ i];
+
+            if ( e.hash == h && e.key_len == key.size()
+                 && memcmp( &words[ e.key_start], &key[ 0], key.size() * sizeof( UInt64)) == 0 )
+            {
+                return e.value;
+            }
+        }
+        return NULL;
+    }
+
+    /** Make the expression available with the given value */
+    void ExprTable::insert( const vector< UInt64> &key, UInt32 h, Obj *value)
+    {
+        if ( entries.size() >= buckets.size() )
+        {
+            grow();
+        }
+
+        ExprEntry e;
+        UInt32 b = h & ( (UInt32)buckets.size() - 1);
+
+        e.hash = h;
+        e.key_start = (UInt32)words.size();
+        e.key_len = (UInt32)key.size();
+        e.next = buckets[ b];
+        e.value = value;
+        words.insert( words.end(), key.begin(), key.end());
+        buckets[ b] = (UInt32)entries.size();
+        entries.push_back( e);
+    }
+
+    /** Remove the entries inserted after the table had the given size */
+    void ExprTable::popTo( UInt32 num)
+    {
+        while ( entries.size() > num )
+        {
+            const ExprEntry &e = entries.back();
+
+            buckets[ e.hash & ( buckets.size() - 1)] = e.next;
+            words.resize( e.key_start);
+            entries.pop_back();
+        }
+    }
+
+    /** Double the number of the chains and link the entries into them again */
+    void ExprTable::grow()
+    {
+        buckets.assign( buckets.size() * 2, GVN_NO_ENTRY);
+        for ( UInt32 i = 0; i < entries.size(); i++)
+        {
+            UInt32 b = entries[ i].hash & ( (UInt32)buckets.size() - 1);
+
+            entries[ i].next = buckets[ b];
+            buckets[ b] = i;
+        }
+    }
+
+    /** Check that the operation computes its only result from the arguments with no side effects */
+    static bool isPure( Operation *oper)
+    {
+        switch ( oper->name())
+        {
+            case Mov:
+            case Add:
+            case Sub:
+            case Mul:
+            case Div:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    /** Check that the operand is an immediate or an object that has the same value wherever it is used */
+    static bool isStable( const Operand &op, const vector< bool> &stable)
+    {
+        return op.type() != OP_TYPE_OBJ || ( op.object()->type() == Reg && stable[ op.object()->id()]);
+    }
+
+    /** Check that the definition comes before the use in the node on every path to it, NULL use is the end of the node */
+    static bool dominates( const DomTree &dom, Numeration pos, Operation *def, CFNode *node, Operation *use)
+    {
+        if ( isNullP( def->node()) || !dom.isReachable( def->node()) || !dom.isReachable( node) )
+            return false;
+
+        if ( areEqP( def->node(), node) )
+            return isNullP( use) || def->number( pos) < use->number( pos);
+
+        return dom.dominates( def->node(), node);
+    }
+
+    /** Keep the object stable only if its definition dominates the use */
+    static void checkUse( const DomTree &dom, Numeration pos, const Operand &op, CFNode *node, Operation *use,
+                          vector< bool> &stable)
+    {
+        if ( op.type() != OP_TYPE_OBJ || !isStable( op, stable) || op.object()->numDefs() == 0 )
+            return;
+
+        stable[ op.object()->id()] = dominates( dom, pos, op.object()->defs()[ 0].oper, node, use);
+    }
+
+    /**
+     * Find the objects that have the same value wherever they are used. These are the objects
+     * with no definitions and the objects with one definition that dominates all their uses, except
+     * the function's arguments since their uses may read the incoming value. A phi argument is used
+     * at the end of the predecessor node of its edge
+     */
+    static void findStableObjects( Function *f, const DomTree &dom, vector< bool> &stable)
+    {
+        CFG &cfg = f->cfg();
+        Numeration pos = f->newNum();
+
+        stable.assign( f->numObjects( Reg), true);
+        for ( UInt16 i = 0; i < f->numArgs(); i++)
+        {
+            if ( f->arg( i)->type() == Reg && f->arg( i)->numDefs() > 0 )
+            {
+                stable[ f->arg( i)->id()] = false;
+            }
+        }
+        for ( UInt32 i = 0; i < stable.size(); i++)
+        {
+            if ( f->object( Reg, i)->numDefs() > 1 )
+            {
+                stable[ i] = false;
+            }
+        }
+        for ( CFNode *node = cfg.firstNode(); isNotNullP( node); node = node->nextNode())
+        {
+            GraphNum p = 0;
+
+            for ( Operation *oper = node->firstOper(); isNotNullP( oper); oper = oper->nextInNode())
+            {
+                oper->setNumber( pos, p++);
+            }
+        }
+        for ( CFNode *node = cfg.firstNode(); isNotNullP( node); node = node->nextNode())
+        {
+            for ( Operation *oper = node->firstOper(); isNotNullP( oper); oper = oper->nextInNode())
+            {
+                for ( UInt32 i = 0; i < oper->numArgs(); i++)
+                {
+                    checkUse( dom, pos, oper->arg( i), node, oper, stable);
+                }
+                if ( isPhi( oper) )
+                {
+                    CFEdge *e = node->firstPred();
+
+                    for ( UInt32 i = 0; i < oper->numArgsInSet() && isNotNullP( e); i++, e = e->nextPred())
+                    {
+                        checkUse( dom, pos, oper->argInSet( i), e->pred(), NULL, stable);
+                    }
+                } else
+                {
+                    for ( UInt32 i = 0; i < oper->numArgsInSet(); i++)
+                    {
+                        checkUse( dom, pos, oper->argInSet( i), node, oper, stable);
+                    }
+                }
+            }
+        }
+        f->freeNum( pos);
+    }
+
+    /** Get the two words of the operand in the expression key */
+    static pair< UInt64, UInt64> operandKey( const Operand &op)
+    {
+        if ( op.type() == OP_TYPE_OBJ )
+        {
+            return make_pair( (UInt64)GVN_KEY_OBJ | ( (UInt64)op.object()->type() << 8), (UInt64)op.object()->id());
+        }
+        IR_ASSERTXD( op.type() == OP_TYPE_IMM, "Operand of the expression is neither object nor immediate");
+
+        Const c = op.constValue();
+
+        switch ( c.type())
+        {
+            case CONST_TYPE_INTEGER:
+                return make_pair( (UInt64)GVN_KEY_INT, (UInt64)c.intVal());
+            case CONST_TYPE_FLOAT:
+            {
+                Double d = c.floatVal();
+                UInt64 bits = 0;
+
+                memcpy( &bits, &d, sizeof( d));
+                return make_pair( (UInt64)GVN_KEY_FLOAT, bits);
+            }
+            default:
+                return make_pair( (UInt64)GVN_KEY_SYMBOL, (UInt64)c.symVal().id());
+        }
+    }
+
+    /** Make the key of the operation's expression, the arguments of the commutative operations are ordered */
+    static void makeKey( Operation *oper, vector< UInt64> &key)
+    {
+        key.clear();
+        key.push_back( (UInt64)oper->name());
+        if ( oper->numArgs() == 2 )
+        {
+            pair< UInt64, UInt64> a = operandKey( oper->arg( 0));
+            pair< UInt64, UInt64> b = operandKey( oper->arg( 1));
+
+            if ( ( oper->name() == Add || oper->name() == Mul) && b < a )
+            {
+                std::swap( a, b);
+            }
+            key.push_back( a.first);
+            key.push_back( a.second);
+            key.push_back( b.first);
+            key.push_back( b.second);
+        } else
+        {
+            for ( UInt32 i = 0; i < oper->numArgs(); i++)
+            {
+                pair< UInt64, UInt64> a = operandKey( oper->arg( i));
+
+                key.push_back( a.first);
+                key.push_back( a.second);
+            }
+        }
+    }
+
+    /** Replace the redundant computations of the node and make its expressions available */
+    static bool numberNode( Function *f, CFNode *node, const vector< bool> &stable,
+                            ExprTable &table, vector< UInt64> &key)
+    {
+        bool changed = false;
+        Operation *oper = node->firstOper();
+
+        while ( isNotNullP( oper) )
+        {
+            Operation *next = oper->nextInNode();
+
+            if ( isPure( oper) && oper->res( 0).type() == OP_TYPE_OBJ && isStable( oper->res( 0), stable)
+                 && isStable( oper->arg( 0), stable) && ( oper->numArgs() < 2 || isStable( oper->arg( 1), stable)) )
+            {
+                Obj *res = oper->res( 0).object();
+                Obj *value = NULL;
+
+                if ( oper->name() == Mov && oper->arg( 0).type() == OP_TYPE_OBJ )
+                {
+                    /* The copy has the value number of its source */
+                    value = oper->arg( 0).object();
+                } else
+                {
+                    makeKey( oper, key);
+
+                    UInt32 h = SymbolTable::hash( (const char *)&key[ 0], (UInt32)( key.size() * sizeof( UInt64)));
+
+                    value = table.find( key, h);
+                    if ( isNullP( value) )
+                    {
+                        table.insert( key, h, res);
+                    }
+                }
+                if ( isNotNullP( value) && !areEqP( value, res) )
+                {
+                    changed |= res->numUses() > 0;
+                    res->replaceAllUsesWith( value);
+                    if ( isNotNullP( next) || !isJumpTarget( oper) )
+                    {
+                        removeOper( f, oper);
+                        changed = true;
+                    }
+                }
+            }
+            oper = next;
+        }
+        return changed;
+    }
+
+    /** Number the values using the given dominator tree of the function's CFG */
+    bool numberValues( Function *f, const DomTree &dom)
+    {
+        ExprTable table;
+        vector< UInt64> key;
+        vector< pair< CFNode *, UInt32> > stack; /* Nodes of the tree path and their next children */
+        vector< UInt32> scopes;
+        vector< bool> stable;
+        bool changed = false;
+
+        findStableObjects( f, dom, stable);
+        stack.push_back( make_pair( f->cfg().startNode(), 0U));
+        scopes.push_back( table.size());
+        changed |= numberNode( f, f->cfg().startNode(), stable, table, key);
+        while ( !stack.empty() )
+        {
+            CFNode *node = stack.back().first;
+            UInt32 i = stack.back().second;
+            const vector< CFNode *> &kids = dom.children( node);
+
+            if ( i < kids.size() )
+            {
+                stack.back().second++;
+                scopes.push_back( table.size());
+                changed |= numberNode( f, kids[ i], stable, table, key);
+                stack.push_back( make_pair( kids[ i], 0U));
+            } else
+            {
+                table.popTo( scopes.back());
+                scopes.pop_back();
+                stack.pop_back();
+            }
+        }
+        return changed;
+    }
+
+    /** Replace the computations that repeat a dominating one with its result */
+    bool numberValues( Function *f)
+    {
+        IR_ASSERTXD( f->cfg().isValid(), "Value numbering requires valid CFG");
+
+        DomTree dom( &f->cfg());
+
+        return numberValues( f, dom);
+    }
+}
@@ -0,0 +1,32 @@
+/**
+ * @file: opt/gvn.hpp
+ * Dominator-based global value numbering
+ * @ingroup OPT
+ */
+ /*
+  * Copyright 2012 MIPT-COMPILER team
+  */
+#pragma once
+
+namespace Opt
+{
+    /**
+     * Replace the computations that repeat a dominating one with its result.
+     *
+     * The dominator tree is walked in preorder with a scoped hash table of the expressions
+     * available in the current node. The expression of Add, Sub, Mul, Div or Mov of an immediate
+     * is its opcode with the objects and the immediates of its arguments, the arguments of Add and
+     * Mul are ordered so that the commuted operations get the same expression. An operation whose
+     * expression is in the table gets its uses replaced by the available result and is deleted,
+     * a move of an object gets its uses replaced by the source. Only the objects that have one value
+     * wherever they are used take part: the ones with no definitions and the ones with one definition
+     * that dominates all their uses, except the function's arguments. So in SSA form every computation
+     * takes part, otherwise the computations of the other objects are left as is.
+     * The expressions are removed from the table when the walk leaves the subtree of their node.
+     * Returns true if the function is changed
+     */
+    bool numberValues( Function *f);
+
+    /** Number the values using the given dominator tree of the function's CFG */
+    bool numberValues( Function *f, const DomTree &dom);
+}
@@ -0,0 +1,205 @@
+/**
+ * @file: opt/liveness.cpp
+ * Implementation of the liveness analysis
+ * @ingroup OPT
+ */
+ /*
+  * Copyright 2012 MIPT-COMPILER team
+  */
+#include "opt_iface.hpp"
+
+namespace Opt
+{
+    typedef IR::Operation< MDes> Operation;
+
+    /** Check that the operand holds an object the liveness is computed for */
+    static inline bool isLiveObj( const IR::Operand< MDes> &op)
+    {
+        return op.type() == OP_TYPE_OBJ && op.object()->type() == Reg;
+    }
+
+    /** Remove the results of the operation from the set */
+    static void killResults( Operation *oper, BitSet &live)
+    {
+        for ( UInt32 i = 0; i < oper->numRess(); i++)
+        {
+            if ( isLiveObj( oper->res( i)) )
+            {
+                live.reset( oper->res( i).object()->id());
+            }
+        }
+        for ( UInt32 i = 0; i < oper->numRessInSet(); i++)
+        {
+            if ( isLiveObj( oper->resInSet( i)) )
+            {
+                live.reset( oper->resInSet( i).object()->id());
+            }
+        }
+    }
+
+    /** Add the arguments of the operation to the set, phi arguments are not live at the phi */
+    static void genArguments( Operation *oper, BitSet &live)
+    {
+        if ( isPhi( oper) )
+            return;
+
+        for ( UInt32 i = 0; i < oper->numArgs(); i++)
+        {
+            if ( isLiveObj( oper->arg( i)) )
+            {
+                live.set( oper->arg( i).object()->id());
+            }
+        }
+        for ( UInt32 i = 0; i < oper->numArgsInSet(); i++)
+        {
+            if ( isLiveObj( oper->argInSet( i)) )
+            {
+                live.set( oper->argInSet( i).object()->id());
+            }
+        }
+    }
+
+    /** Compute the liveness of the function's objects */
+    Liveness::Liveness( Function *f):
+        cfg( &f->cfg()), topo_num( f->cfg().makeTopologicalNumeration()),
+        num_objs( f->numObjects( Reg)), num_visits( 0)
+    {
+        UInt32 n = cfg->numNodes();
+        vector< CFNode *> nodes( n, NULL);
+
+        uses.resize( n, BitSet( num_objs));
+        defs.resize( n, BitSet( num_objs));
+        phi_uses.resize( n, BitSet( num_objs));
+        ins.resize( n, BitSet( num_objs));
+        outs.resize( n, BitSet( num_objs));
+
+        /* Local sets of the nodes, operations go forward so a use after a definition is not exposed */
+        for ( CFNode *node = cfg->firstNode(); isNotNullP( node); node = node->nextNode())
+        {
+            UInt32 b = index( node);
+            BitSet &use = uses[ b];
+            BitSet &def = defs[ b];
+
+            nodes[ b] = node;
+            for ( Operation *oper = node->firstOper(); isNotNullP( oper); oper = oper->nextInNode())
+            {
+                if ( isPhi( oper) )
+                {
+                    /* The i-th argument comes along the i-th predecessor edge */
+                    CFEdge *e = node->firstPred();
+
+                    for ( UInt32 i = 0; i < oper->numArgsInSet() && isNotNullP( e); i++, e = e->nextPred())
+                    {
+                        if ( isLiveObj( oper->argInSet( i)) )
+                        {
+                            phi_uses[ index( e->pred())].set( oper->argInSet( i).object()->id());
+                        }
+                    }
+                } else
+                {
+                    for ( UInt32 i = 0; i < oper->numArgs(); i++)
+                    {
+                        if ( isLiveObj( oper->arg( i)) && !def.test( oper->arg( i).object()->id()) )
+                        {
+                            use.set( oper->arg( i).object()->id());
+                        }
+                    }
+                    for ( UInt32 i = 0; i < oper->numArgsInSet(); i++)
+                    {
+                        if ( isLiveObj( oper->argInSet( i)) && !def.test( oper->argInSet( i).object()->id()) )
+                        {
+                            use.set( oper->argInSet( i).object()->id());
+                        }
+                    }
+                }
+                for ( UInt32 i = 0; i < oper->numRess(); i++)
+                {
+                    if ( isLiveObj( oper->res( i)) )
+                    {
+                        def.set( oper->res( i).object()->id());
+                    }
+                }
+                for ( UInt32 i = 0; i < oper->numRessInSet(); i++)
+                {
+                    if ( isLiveObj( oper->resInSet( i)) )
+                    {
+                        def.set( oper->resInSet( i).object()->id());
+                    }
+                }
+            }
+        }
+
+        /*
+         * Worklist in postorder: the reachable nodes have the greatest topological numbers
+         * and are visited from the last one, the unreachable ones follow them. Every node is queued
+         * at most once, so a ring of n entries holds the worklist
+         */
+        vector< UInt32> worklist( n);
+        vector< bool> queued( n, true);
+        UInt32 head = 0;
+        UInt32 num_queued = n;
+
+        for ( UInt32 i = 0; i < n; i++)
+        {
+            worklist[ i] = n - 1 - i;
+        }
+        while ( num_queued > 0)
+        {
+            UInt32 b = worklist[ head];
+            BitSet &out = outs[ b];
+
+            head = ( head + 1) % n;
+            num_queued--;
+            queued[ b] = false;
+            num_visits++;
+
+            out = phi_uses[ b];
+            for ( CFEdge *e = nodes[ b]->firstSucc(); isNotNullP( e); e = e->nextSucc())
+            {
+                out.unite( ins[ index( e->succ())]);
+            }
+            if ( ins[ b].assignTransfer( uses[ b], out, defs[ b]) )
+            {
+                for ( CFEdge *e = nodes[ b]->firstPred(); isNotNullP( e); e = e->nextPred())
+                {
+                    UInt32 p = index( e->pred());
+
+                    if ( !queued[ p] )
+                    {
+                        queued[ p] = true;
+                        worklist[ ( head + num_queued) % n] = p;
+                        num_queued++;
+                    }
+                }
+            }
+        }
+    }
+
+    /** Release the numeration of the CFG */
+    Liveness::~Liveness()
+    {
+        cfg->freeNum( topo_num);
+    }
+
+    /** Get the objects live right after the operation, the set is resized to the number of objects */
+    void Liveness::liveAfter( Operation *oper, BitSet &live) const
+    {
+        CFNode *node = oper->node();
+
+        IR_ASSERTD( isNotNullP( node));
+        live = outs[ index( node)];
+        for ( Operation *cur = node->lastOper(); !areEqP( cur, oper); cur = cur->prevOper())
+        {
+            killResults( cur, live);
+            genArguments( cur, live);
+        }
+    }
+
+    /** Get the objects live right before the operation, the set is resized to the number of objects */
+    void Liveness::liveBefore( Operation *oper, BitSet &live) const
+    {
+        liveAfter( oper, live);
+        killResults( oper, live);
+        genArguments( oper, live);
+    }
+}
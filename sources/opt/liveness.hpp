@@ -0,0 +1,116 @@
+/**
+ * @file: opt/liveness.hpp
+ * Liveness of the objects at the CF nodes and operations
+ * @ingroup OPT
+ */
+ /*
+  * Copyright 2012 MIPT-COMPILER team
+  */
+#pragma once
+
+namespace Opt
+{
+    /**
+     * @class Liveness
+     * @brief Sets of Reg objects live on entry and on exit of every CF node
+     *
+     * The sets are bit sets indexed by the objects' ids. Upward exposed uses and definitions of every
+     * node are collected in one walk over its operations, then the live sets are iterated to the fixed
+     * point by a worklist that starts with all the nodes in postorder, so that an acyclic graph takes
+     * one visit per node. A node is revisited only when the live-in set of its successor grows.
+     * Arguments of a phi are live on exit of the predecessor of the corresponding edge and not
+     * on entry of the phi's node, results of phis are defined on entry of the node.
+     * Liveness at the operations is computed on request by walking the node back from its end.
+     * The analysis keeps the topological numeration of the CFG while it exists, the function must not
+     * be changed while the analysis is in use
+     * @ingroup OPT
+     */
+    class Liveness
+    {
+    public:
+        Liveness( Function *f); /**< Compute the liveness of the function's objects */
+        ~Liveness();            /**< Release the numeration of the CFG */
+
+        /** Get size of the sets, it is the number of the function's Reg objects */
+        inline UInt32 numObjects() const;
+
+        /** Get the objects live on entry of the node */
+        inline const BitSet &liveIn( CFNode *node) const;
+
+        /** Get the objects live on exit of the node */
+        inline const BitSet &liveOut( CFNode *node) const;
+
+        /** Check that the object is live on entry of the node */
+        inline bool isLiveIn( CFNode *node, Obj *obj) const;
+
+        /** Check that the object is live on exit of the node */
+        inline bool isLiveOut( CFNode *node, Obj *obj) const;
+
+        /** Get the objects live right before the operation, the set is resized to the number of objects */
+        void liveBefore( IR::Operation< MDes> *oper, BitSet &live) const;
+
+        /** Get the objects live right after the operation, the set is resized to the number of objects */
+        void liveAfter( IR::Operation< MDes> *oper, BitSet &live) const;
+
+        /** Get number of the nodes' visits the worklist took to reach the fixed point */
+        inline UInt32 numVisits() const;
+    private:
+        Liveness( const Liveness &);
+        Liveness &operator = ( const Liveness &);
+
+        /** Get index of the node in the sets */
+        inline UInt32 index( CFNode *node) const;
+
+        CFG *cfg;
+        Numeration topo_num;   /**< Topological numeration of the CFG, numbers are the indices of the sets */
+        UInt32 num_objs;
+        vector< BitSet> uses;  /**< Upward exposed uses of the nodes except the phi arguments */
+        vector< BitSet> defs;  /**< Definitions of the nodes including the phi results */
+        vector< BitSet> phi_uses; /**< Arguments of the successors' phis that come from the nodes */
+        vector< BitSet> ins;
+        vector< BitSet> outs;
+        UInt32 num_visits;
+    };
+
+    /** Get size of the sets, it is the number of the function's Reg objects */
+    UInt32 Liveness::numObjects() const
+    {
+        return num_objs;
+    }
+
+    /** Get index of the node in the sets */
+    UInt32 Liveness::index( CFNode *node) const
+    {
+        return node->number( topo_num);
+    }
+
+    /** Get the objects live on entry of the node */
+    const BitSet &Liveness::liveIn( CFNode *node) const
+    {
+        return ins[ index( node)];
+    }
+
+    /** Get the objects live on exit of the node */
+    const BitSet &Liveness::liveOut( CFNode *node) const
+    {
+        return outs[ index( node)];
+    }
+
+    /** Check that the object is live on entry of the node */
+    bool Liveness::isLiveIn( CFNode *node, Obj *obj) const
+    {
+        return ins[ index( node)].test( obj->id());
+    }
+
+    /** Check that the object is live on exit of the node */
+    bool Liveness::isLiveOut( CFNode *node, Obj *obj) const
+    {
+        return outs[ index( node)].test( obj->id());
+    }
+
+    /** Get number of the nodes' visits the worklist took to reach the fixed point */
+    UInt32 Liveness::numVisits() const
+    {
+        return num_visits;
+    }
+}
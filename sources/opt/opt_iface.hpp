@@ -34,6 +34,15 @@ namespace Opt
         OPT_OPERS_NUM
     };
 
+#define UNIT( name, ...) name,
+
+    /** Functional units */
+    enum OptUnitName
+    {
+#include "opt_mdes_inc.hpp"
+        OPT_UNITS_NUM
+    };
+
 #define OPER_CLASS( name, func_prefix, ...) name,
 
     /** Operation classes */
@@ -59,12 +68,65 @@ namespace Opt
     typedef IR::CFNode< MDes> CFNode;
     typedef IR::CFEdge< MDes> CFEdge;
     typedef IR::Object< MDes> Obj;
+    typedef IR::DomTree< MDes> DomTree;
     
     /** Unit test for optimizer */
     bool uTest( UnitTest *utest);
+
+    /** Unit test for SSA construction and destruction */
+    bool uTestSSA( UnitTest *utest);
+
+    /** Unit test for dependence graph construction */
+    bool uTestDeps( UnitTest *utest);
+
+    /** Unit test for list scheduling */
+    bool uTestSched( UnitTest *utest);
+
+    /** Unit test for operand sets */
+    bool uTestOperandSets( UnitTest *utest);
+
+    /** Unit test for function's arena */
+    bool uTestArena( UnitTest *utest);
+
+    /** Unit test for reader of the printed IR */
+    bool uTestReader( UnitTest *utest);
+
+    /** Unit test for the binary IR and lazy loading of functions */
+    bool uTestBitcode( UnitTest *utest);
+
+    /** Unit test for thread pool and parallel optimization of the module */
+    bool uTestDriver( UnitTest *utest);
+
+    /** Unit test for pass manager and cached analyses */
+    bool uTestPassManager( UnitTest *utest);
+
+    /** Unit test for bit sets and liveness analysis */
+    bool uTestLiveness( UnitTest *utest);
+
+    /** Unit test for dataflow solver and its sets */
+    bool uTestDataflow( UnitTest *utest);
+
+    /** Unit test for sparse conditional constant propagation */
+    bool uTestSCCP( UnitTest *utest);
+
+    /** Unit test for dead code elimination */
+    bool uTestDCE( UnitTest *utest);
+
+    /** Unit test for global value numbering */
+    bool uTestGVN( UnitTest *utest);
 };
 
 #include "opt_oper.hpp"
+#include "ssa.hpp"
+#include "deps.hpp"
+#include "sched.hpp"
+#include "driver.hpp"
+#include "liveness.hpp"
+#include "cfg_edit.hpp"
+#include "sccp.hpp"
+#include "dce.hpp"
+#include "gvn.hpp"
+#include "pass_manager.hpp"
 
 
 
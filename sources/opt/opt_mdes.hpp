@@ -9,7 +9,8 @@
 namespace Opt
 {
     /** Machine description for optimizer */
-    typedef MDesImpl< Oper, OptOperName, OptObjectName, OptOperClass, OPT_OBJECTS_NUM, OPT_OPERS_NUM, 3, 1, OPT_OPER_CLASSES_NUM> MDes;
+    typedef MDesImpl< Oper, OptOperName, OptObjectName, OptOperClass, OPT_OBJECTS_NUM, OPT_OPERS_NUM, 3, 1, OPT_OPER_CLASSES_NUM,
+                      OptUnitName, OPT_UNITS_NUM> MDes;
 
     /* Feasible operands descriptions */
     typedef MDes::OpType<OPT_OBJECTS_NUM, 32, CANNOT_BE_IMM, CAN_BE_TARGET> target;
@@ -16,10 +16,22 @@
 #ifndef OPER_CLASSES
 #  define OPER_CLASSES( name, ...)
 #endif
+#ifndef UNIT
+#  define UNIT( name, str, num)
+#endif
+#ifndef OPER_SCHED
+#  define OPER_SCHED( name, unit, latency, busy)
+#endif
 
 /* Objects */
 OBJ( Reg, "t", 32, 0, REGISTER, true)
 
+/* Functional units */
+UNIT( AluUnit, "alu", 2)
+UNIT( MulUnit, "mul", 1)
+UNIT( MemUnit, "mem", 1)
+UNIT( BrUnit,  "br",  1)
+
 /* Movs */
 OPER( Mov,  "mov",  Args<reg_imm_32>, Ress<reg_32> )
 
@@ -46,7 +58,30 @@ OPER( Brne, "brne", Args<reg_32, reg_imm_32, target>, Ress<> ) OPER_CLASSES( Brn
 OPER( Call, "call", Args<reg_imm_32, arg_set>, Ress<res_set> )
 OPER( Ret,  "ret" , Args<arg_set>           , Ress<>         )
 
+/* SSA form */
+OPER( Phi,  "phi" , Args<arg_set>, Ress<reg_32> )
+
+/* Scheduling: unit, latency, cycles the unit is busy. Division is not pipelined */
+OPER_SCHED( Mov,  AluUnit, 1, 1)
+OPER_SCHED( Add,  AluUnit, 1, 1)
+OPER_SCHED( Sub,  AluUnit, 1, 1)
+OPER_SCHED( Mul,  MulUnit, 3, 1)
+OPER_SCHED( Div,  MulUnit, 12, 12)
+OPER_SCHED( Ld,   MemUnit, 3, 1)
+OPER_SCHED( St,   MemUnit, 1, 1)
+OPER_SCHED( Br,   BrUnit,  1, 1)
+OPER_SCHED( Brl,  BrUnit,  1, 1)
+OPER_SCHED( Brg,  BrUnit,  1, 1)
+OPER_SCHED( Brle, BrUnit,  1, 1)
+OPER_SCHED( Brge, BrUnit,  1, 1)
+OPER_SCHED( Bre,  BrUnit,  1, 1)
+OPER_SCHED( Brne, BrUnit,  1, 1)
+OPER_SCHED( Call, BrUnit,  1, 1)
+OPER_SCHED( Ret,  BrUnit,  1, 1)
+
 #undef OPER
 #undef OBJ
 #undef OPER_CLASSES
+#undef UNIT
+#undef OPER_SCHED
 
@@ -7,27 +7,90 @@
 
 using namespace Opt;
 
-template <> MDes::OperDes MDes::opers[ MDes::num_opers] = {};
-template <> MDes::ObjDes MDes::objects[ MDes::num_objs] = {};
-
-#define OPER( name, str, ...) initOperDes< __VA_ARGS__>( name, str);
-#define OBJ( ...) initObjDes( __VA_ARGS__);
-#define OPER_CLASSES( name, ...) { MDes::OperClass classes[] = {__VA_ARGS__}; initOperClasses( name, sizeof(classes)/sizeof(MDes::OperClass), classes);}
-
 /*
- * Enclosed the MDes constructor specialization in IR namespace to resolve
- * 'specialization in different namespace compiler error'
+ * The description tables are built from opt_mdes_inc.hpp in several passes. First the classes and
+ * the scheduling data of the operations become constants of the OperClassesOf and OperSchedOf
+ * specializations and the signatures become typedefs. Then the rows of the tables are made of these
+ * constants only, so the tables are filled by the compiler and need no initialization at startup
  */
-namespace IR
+namespace
 {
-    /** Operations descriptions */
-    template <> MDes::MDesImpl()
+    /** Classes of the operation, no classes by default */
+    template < OptOperName name> struct OperClassesOf
+    {
+        static const UInt32 mask = 0;
+    };
+
+    /** Scheduling data of the operation, no unit and 1 cycle latency by default */
+    template < OptOperName name> struct OperSchedOf
     {
-        #include "opt_mdes_inc.hpp"
-    }
+        static const OptUnitName unit = OPT_UNITS_NUM;
+        static const UInt32 latency = 1;
+        static const UInt32 busy = 1;
+    };
+}
+
+#define OPER_CLASSES( name, ...)                           \
+    namespace { template <> struct OperClassesOf< name>    \
+    {                                                      \
+        static const UInt32 mask = OperClassMask< __VA_ARGS__>::mask; \
+    }; }
+#define OPER_SCHED( name, unit_, latency_, busy_)          \
+    namespace { template <> struct OperSchedOf< name>      \
+    {                                                      \
+        static const OptUnitName unit = unit_;             \
+        static const UInt32 latency = latency_;            \
+        static const UInt32 busy = busy_;                  \
+    }; }
+#include "opt_mdes_inc.hpp"
+
+namespace
+{
+    /** Signatures of the operations, the operand types are found in the MDes scope */
+    struct OperSigs: public MDes
+    {
+#define OPER( name, str, ...)                                                           \
+        typedef OperSig< __VA_ARGS__> name ## Sig;                                      \
+        typedef char name ## SigFits[ ( name ## Sig::num_args <= max_args               \
+                                        && name ## Sig::num_ress <= max_ress) ? 1 : -1];
+#include "opt_mdes_inc.hpp"
+    };
+}
+
+/* Rows of the tables, the operations' rows fill max_args( 3) arguments and max_ress( 1) results */
+#define OP_DES( T) { T::obj_name, T::size, T::can_be_imm, T::can_be_target, T::can_be_set }
+#define OPER_DES( name, str, S)                                                      \
+    { name, str, S::num_args, S::num_ress,                                           \
+      { OP_DES( S::Arg0), OP_DES( S::Arg1), OP_DES( S::Arg2) },                      \
+      { OP_DES( S::Res0) },                                                          \
+      S::has_arg_set, S::has_res_set, OperClassesOf< name>::mask,                    \
+      OperSchedOf< name>::unit, OperSchedOf< name>::latency, OperSchedOf< name>::busy },
 
+/** Operations descriptions */
+template <> const MDes::OperDes MDes::opers[ MDes::num_opers] =
+{
+#define OPER( name, str, ...) OPER_DES( name, str, OperSigs::name ## Sig)
+#include "opt_mdes_inc.hpp"
+};
+
+/** Objects descriptions */
+template <> const MDes::ObjDes MDes::objects[ MDes::num_objs] =
+{
+#define OBJ( name, prefix, max_size, num, storage_class, can_be_virtual) \
+    { name, prefix, max_size, num, storage_class, can_be_virtual },
+#include "opt_mdes_inc.hpp"
+};
+
+/** Functional units descriptions */
+template <> const MDes::UnitDes MDes::units[ MDes::num_units] =
+{
+#define UNIT( name, str, num) { name, str, num },
+#include "opt_mdes_inc.hpp"
 };
 
+#undef OPER_DES
+#undef OP_DES
+
 namespace Opt
 {
         /** Class check routines */
@@ -35,6 +98,3 @@ namespace Opt
 #include "opt_oper_classes_inc.hpp"
 
 }
-
-MDes opt_mdes;
-
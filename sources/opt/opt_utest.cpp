@@ -52,7 +52,7 @@ namespace Opt
 
         /* {3} call unknown_routine, vt3 */
         Oper *call = f->newOper(Call);
-        call->setArgImm(0, string("unknown_routine"));
+        call->setArgImm(0, m.symbols().intern("unknown_routine"));
         call->addArgToSet(v4);
         call->addArgToSet(v3);
         call->addResToSet(v4);
@@ -71,7 +71,7 @@ namespace Opt
         node3->append(ret);
 
         /* Unit test of store operation representation */
-        MDes::OperDes *st_des = MDes::operDescription(st->name());
+        const MDes::OperDes *st_des = MDes::operDescription(st->name());
 
         UTEST_CHECK(utest, st_des->num_args == 2);
         UTEST_CHECK(utest, st_des->num_ress == 0);
@@ -95,10 +95,1753 @@ namespace Opt
         utest->out() << f; // After CFG is valid the 'operator <<' should print the whole CFG
 
         /* Unit test of operation representation */
-        MDes::OperDes *des = MDes::operDescription(Add);
+        const MDes::OperDes *des = MDes::operDescription(Add);
 
         UTEST_CHECK(utest, des->num_args == 2);
         UTEST_CHECK(utest, des->num_ress == 1);
+
+        /* Descriptions are constant tables built from opt_mdes_inc.hpp */
+        UTEST_CHECK(utest, MDes::checkName(Phi) && MDes::operDescription(Phi)->canHaveArgSet());
+        UTEST_CHECK(utest, MDes::operDescription(Call)->canHaveResSet() && !des->canHaveArgSet());
+        UTEST_CHECK(utest, MDes::operDescription(Ld)->belongsToClass(MEM_READ));
+        UTEST_CHECK(utest, !MDes::operDescription(Ld)->belongsToClass(MEM_WRITE));
+        UTEST_CHECK(utest, MDes::operDescription(Brg)->belongsToClass(CF) && !des->belongsToClass(CF));
+        UTEST_CHECK(utest, des->argDes(1)->canBeImm() && !des->resDes(0)->canBeImm());
+        UTEST_CHECK(utest, MDes::operDescription(Div)->unit == MulUnit && MDes::operDescription(Div)->busy == 12);
+        UTEST_CHECK(utest, !MDes::operDescription(Phi)->usesUnit());
+        UTEST_CHECK(utest, MDes::unitDescription(AluUnit)->num == 2);
+        UTEST_CHECK(utest, string(MDes::objectDescription(Reg)->prefix) == "t");
+
+        /* Operands are compact and symbols are interned once per module */
+        UTEST_CHECK(utest, sizeof(Operand<MDes>) <= 16);
+        UTEST_CHECK(utest, call->arg(0).constValue().symVal() == m.symbols().intern("unknown_routine"));
+        UTEST_CHECK(utest, m.symbols().find("unknown_routine") == m.symbols().intern(string("unknown_routine")));
+        UTEST_CHECK(utest, !m.symbols().find("unknown").isValid());
+        UTEST_CHECK(utest, f->nameSym() == m.symbols().find(f->name()));
+        UTEST_CHECK(utest, m.symbols().numSymbols() == 2);
+
+        /* Symbols stay stable while the symbol table grows */
+        Module sym_m;
+        for (UInt32 i = 0; i < 1000; i++)
+        {
+            UTEST_CHECK(utest, sym_m.symbols().intern(toString(i)).id() == i);
+        }
+        for (UInt32 i = 0; i < 1000; i++)
+        {
+            UTEST_CHECK(utest, sym_m.symbols().find(toString(i)).id() == i);
+            UTEST_CHECK(utest, sym_m.symbols().str(Symbol(i)) == toString(i));
+        }
+
+        /* Function lookup, renaming and removal */
+        Function *foo = sym_m.newFunction("foo");
+        Function *bar = sym_m.newFunction("bar");
+        UTEST_CHECK(utest, sym_m.findFunctionByName("foo") == foo);
+        UTEST_CHECK(utest, sym_m.findFunctionByName("barrier", 3) == bar);
+        UTEST_CHECK(utest, isNullP(sym_m.findFunctionByName("baz")));
+        sym_m.renameFunction("foo", "baz");
+        UTEST_CHECK(utest, isNullP(sym_m.findFunctionByName("foo")));
+        UTEST_CHECK(utest, sym_m.findFunctionByName("baz") == foo);
+        UTEST_CHECK(utest, foo->name() == "baz");
+        sym_m.renameFunction(bar, "foo");
+        UTEST_CHECK(utest, sym_m.findFunctionByName("foo") == bar);
+        sym_m.removeFunction(foo);
+        UTEST_CHECK(utest, isNullP(sym_m.findFunctionByName("baz")));
+        UTEST_CHECK(utest, sym_m.findFunction(bar->nameSym()) == bar);
+        UTEST_CHECK(utest, st->arg(0).constValue().intVal() == 0x12345);
+
+        /* Def-use chains */
+        UTEST_CHECK(utest, v3->numDefs() == 1 && v3->numUses() == 3);
+        UTEST_CHECK(utest, v4->numDefs() == 2 && v4->numUses() == 2);
+        UTEST_CHECK(utest, v3->defs()[0].oper == add && v3->defs()[0].op == &add->res(0));
+        Obj* v5 = f->newObject(Reg);
+        v3->replaceAllUsesWith(v5);
+        UTEST_CHECK(utest, v3->numUses() == 0 && v5->numUses() == 3);
+        UTEST_CHECK(utest, sub->arg(0).object() == v5 && brg->arg(0).object() == v5);
+        brg->setArgObj(0, v3);
+        UTEST_CHECK(utest, v3->numUses() == 1 && v5->numUses() == 2);
+        for (UInt32 i = 0; i < v5->numUses(); i++)
+        {
+            UTEST_CHECK(utest, v5->uses()[i].op->object() == v5 && v5->uses()[i].op->refIndex() == i);
+        }
+
+                /* Memory statistics of the function's graphs */
+        UTEST_CHECK(utest, f->memStats().nodes.live_entries == f->numNodes());
+        UTEST_CHECK(utest, cfg.memStats().nodes.live_entries == cfg.numNodes());
+        UTEST_CHECK(utest, cfg.memStats().edges.live_entries == cfg.numEdges());
+        return utest->result();
+    }
+    /** Create operation at the end of the node and of the function's operation sequence */
+    static Oper *newOperAtEnd(Function *f, CFNode *node, OptOperName name, Oper *&last)
+    {
+        Oper *oper = isNullP(last) ? f->newOper(name) : f->newOperAfter(name, last);
+        if (isNullP(last))
+        {
+            f->setFirstOper(oper);
+        }
+        node->extend(oper);
+        last = oper;
+        return oper;
+    }
+
+    /** Value of the operand in the interpreter */
+    static Int64 operandValue(const IR::Operand<MDes> &op, map<Obj *, Int64> &vals)
+    {
+        if (op.type() == OP_TYPE_IMM)
+            return op.constValue().intVal();
+        return vals[op.object()];
+    }
+
+    /**
+     * Interpret the function along its CFG, phis take the values on the incoming edge.
+     * Returns the value of the first argument of ret
+     */
+    static Int64 interpret(Function *f)
+    {
+        map<Obj *, Int64> vals;
+        CFEdge *edge = f->cfg().startNode()->firstSucc();
+
+        for (UInt32 steps = 0; isNotNullP(edge) && steps < 100000; steps++)
+        {
+            CFNode *node = edge->succ();
+            CFEdge *next = NULL;
+            UInt32 j = 0;
+
+            for (CFEdge *e = node->firstPred(); e != edge; e = e->nextPred())
+                j++;
+
+            vector< pair<Obj *, Int64> > phi_vals;
+            IR::Operation<MDes> *oper = node->firstOper();
+            for (; isPhi(oper); oper = oper->nextInNode())
+            {
+                phi_vals.push_back(make_pair(oper->res(0).object(), vals[oper->argInSet(j).object()]));
+            }
+            for (UInt32 k = 0; k < phi_vals.size(); k++)
+                vals[phi_vals[k].first] = phi_vals[k].second;
+
+            for (; isNotNullP(oper) && isNullP(next); oper = oper->nextInNode())
+            {
+                bool taken = false;
+                switch (oper->name())
+                {
+                case Mov: vals[oper->res(0).object()] = operandValue(oper->arg(0), vals); break;
+                case Add: vals[oper->res(0).object()] = operandValue(oper->arg(0), vals) + operandValue(oper->arg(1), vals); break;
+                case Sub: vals[oper->res(0).object()] = operandValue(oper->arg(0), vals) - operandValue(oper->arg(1), vals); break;
+                case Mul: vals[oper->res(0).object()] = operandValue(oper->arg(0), vals) * operandValue(oper->arg(1), vals); break;
+                case Br:   taken = true; break;
+                case Brl:  taken = operandValue(oper->arg(0), vals) <  operandValue(oper->arg(1), vals); break;
+                case Brg:  taken = operandValue(oper->arg(0), vals) >  operandValue(oper->arg(1), vals); break;
+                case Brle: taken = operandValue(oper->arg(0), vals) <= operandValue(oper->arg(1), vals); break;
+                case Brge: taken = operandValue(oper->arg(0), vals) >= operandValue(oper->arg(1), vals); break;
+                case Bre:  taken = operandValue(oper->arg(0), vals) == operandValue(oper->arg(1), vals); break;
+                case Brne: taken = operandValue(oper->arg(0), vals) != operandValue(oper->arg(1), vals); break;
+                case Ret:
+                    return oper->numArgsInSet() > 0 ? vals[oper->argInSet(0).object()] : 0;
+                default:
+                    break;
+                }
+                if (taken)
+                {
+                    for (CFEdge *e = node->firstSucc(); isNotNullP(e); e = e->nextSucc())
+                    {
+                        if (e->srcOper() == oper)
+                            next = e;
+                    }
+                }
+            }
+            if (isNullP(next))
+            {
+                /* Fall through */
+                for (CFEdge *e = node->firstSucc(); isNotNullP(e); e = e->nextSucc())
+                {
+                    if (isNullP(e->srcOper()))
+                        next = e;
+                }
+            }
+            edge = next;
+        }
+        return -1;
+    }
+
+    /**
+     * Create the function computing a = 0; for (i = 0; i < 10; i++) if (i >= 5) a += 2; return a
+     */
+    static Function *newLoopFunction(Module &m, string name)
+    {
+        Function *f = m.newFunction(name);
+        CFG &cfg = f->cfg();
+        Oper *last = NULL;
+        CFNode *init = cfg.newNode();
+        CFNode *head = cfg.newNode();
+        CFNode *check = cfg.newNode();
+        CFNode *incr_a = cfg.newNode();
+        CFNode *incr_i = cfg.newNode();
+        CFNode *exit = cfg.newNode();
+        Obj *i = f->newObject(Reg);
+        Obj *a = f->newObject(Reg);
+
+        Oper *mov_i = newOperAtEnd(f, init, Mov, last);
+        mov_i->setArgImm(0, (Int64)0);
+        mov_i->setResObj(0, i);
+        Oper *mov_a = newOperAtEnd(f, init, Mov, last);
+        mov_a->setArgImm(0, (Int64)0);
+        mov_a->setResObj(0, a);
+
+        Oper *brge = newOperAtEnd(f, head, Brge, last);
+        brge->setArgObj(0, i);
+        brge->setArgImm(1, (Int64)10);
+
+        Oper *brl = newOperAtEnd(f, check, Brl, last);
+        brl->setArgObj(0, i);
+        brl->setArgImm(1, (Int64)5);
+
+        Oper *add_a = newOperAtEnd(f, incr_a, Add, last);
+        add_a->setArgObj(0, a);
+        add_a->setArgImm(1, (Int64)2);
+        add_a->setResObj(0, a);
+
+        Oper *add_i = newOperAtEnd(f, incr_i, Add, last);
+        add_i->setArgObj(0, i);
+        add_i->setArgImm(1, (Int64)1);
+        add_i->setResObj(0, i);
+        Oper *br = newOperAtEnd(f, incr_i, Br, last);
+
+        Oper *ret = newOperAtEnd(f, exit, Ret, last);
+        ret->addArgToSet(a);
+
+        brge->setArgTarget(2, ret);
+        brl->setArgTarget(2, add_i);
+        br->setArgTarget(0, brge);
+
+        cfg.newEdge(cfg.startNode(), init);
+        cfg.newEdge(init, head);
+        cfg.newEdge(head, check);
+        cfg.newEdge(head, exit)->setSrcOper(brge);
+        cfg.newEdge(check, incr_a);
+        cfg.newEdge(check, incr_i)->setSrcOper(brl);
+        cfg.newEdge(incr_a, incr_i);
+        cfg.newEdge(incr_i, head)->setSrcOper(br);
+        cfg.newEdge(exit, cfg.stopNode());
+        cfg.setValid(true);
+        return f;
+    }
+
+    /** Count operations with the given name in the function's CFG */
+    static UInt32 countOpers(Function *f, OptOperName name)
+    {
+        UInt32 num = 0;
+        for (CFNode *node = f->cfg().firstNode(); isNotNullP(node); node = node->nextNode())
+        {
+            for (IR::Operation<MDes> *oper = node->firstOper(); isNotNullP(oper); oper = oper->nextInNode())
+            {
+                if (oper->name() == name)
+                    num++;
+            }
+        }
+        return num;
+    }
+
+    bool uTestSSA(UnitTest *utest)
+    {
+        Module m;
+        Function *f = newLoopFunction(m, "loop");
+        CFG &cfg = f->cfg();
+
+        UTEST_CHECK(utest, interpret(f) == 10);
+
+        /* Dominators */
+        {
+            DomTree dom(&cfg);
+            CFNode *init = cfg.startNode()->firstSucc()->succ();
+            CFNode *head = init->firstSucc()->succ();
+            CFNode *incr_i = head->firstPred()->pred();
+
+            if (incr_i == init)
+                incr_i = head->firstPred()->nextPred()->pred();
+
+            UTEST_CHECK(utest, dom.numNodes() == cfg.numNodes());
+            UTEST_CHECK(utest, dom.idom(head) == init);
+            UTEST_CHECK(utest, dom.dominates(head, incr_i) && !dom.dominates(incr_i, head));
+            UTEST_CHECK(utest, dom.frontier(incr_i).size() == 1 && dom.frontier(incr_i)[0] == head);
+        }
+
+        /* Pruned SSA: i and a at the loop head, a at the join after the condition */
+        UTEST_CHECK(utest, buildSSA(f));
+        UTEST_CHECK(utest, countOpers(f, Phi) == 3);
+        UTEST_CHECK(utest, interpret(f) == 10);
+        for (CFNode *node = cfg.firstNode(); isNotNullP(node); node = node->nextNode())
+        {
+            for (IR::Operation<MDes> *oper = node->firstOper(); isNotNullP(oper); oper = oper->nextInNode())
+            {
+                for (UInt32 i = 0; i < oper->numRess(); i++)
+                {
+                    if (oper->res(i).type() == OP_TYPE_OBJ)
+                    {
+                        UTEST_CHECK(utest, oper->res(i).object()->numDefs() == 1);
+                    }
+                }
+            }
+        }
+
+        /* Out of SSA, the critical edge from the condition to the join gets a new node */
+        GraphNum num_nodes = cfg.numNodes();
+        UTEST_CHECK(utest, translateOutOfSSA(f));
+        UTEST_CHECK(utest, countOpers(f, Phi) == 0);
+        UTEST_CHECK(utest, cfg.numNodes() == num_nodes + 1);
+        UTEST_CHECK(utest, !translateOutOfSSA(f));
+        UTEST_CHECK(utest, interpret(f) == 10);
+
+        /* Swap of two objects in the loop needs a temporary */
+        Function *g = m.newFunction("swap");
+        CFG &g_cfg = g->cfg();
+        Oper *last = NULL;
+        CFNode *init = g_cfg.newNode();
+        CFNode *body = g_cfg.newNode();
+        CFNode *exit = g_cfg.newNode();
+        Obj *x = g->newObject(Reg);
+        Obj *y = g->newObject(Reg);
+        Obj *t = g->newObject(Reg);
+        Obj *c = g->newObject(Reg);
+
+        Oper *op = newOperAtEnd(g, init, Mov, last);
+        op->setArgImm(0, (Int64)1);
+        op->setResObj(0, x);
+        op = newOperAtEnd(g, init, Mov, last);
+        op->setArgImm(0, (Int64)2);
+        op->setResObj(0, y);
+        op = newOperAtEnd(g, init, Mov, last);
+        op->setArgImm(0, (Int64)0);
+        op->setResObj(0, c);
+        Oper *loop_start = newOperAtEnd(g, body, Mov, last);
+        loop_start->setArgObj(0, x);
+        loop_start->setResObj(0, t);
+        op = newOperAtEnd(g, body, Mov, last);
+        op->setArgObj(0, y);
+        op->setResObj(0, x);
+        op = newOperAtEnd(g, body, Mov, last);
+        op->setArgObj(0, t);
+        op->setResObj(0, y);
+        op = newOperAtEnd(g, body, Add, last);
+        op->setArgObj(0, c);
+        op->setArgImm(1, (Int64)1);
+        op->setResObj(0, c);
+        Oper *brl = newOperAtEnd(g, body, Brl, last);
+        brl->setArgObj(0, c);
+        brl->setArgImm(1, (Int64)3);
+        brl->setArgTarget(2, loop_start);
+        op = newOperAtEnd(g, exit, Mul, last);
+        op->setArgObj(0, x);
+        op->setArgImm(1, (Int64)10);
+        op->setResObj(0, t);
+        op = newOperAtEnd(g, exit, Add, last);
+        op->setArgObj(0, t);
+        op->setArgObj(1, y);
+        op->setResObj(0, t);
+        newOperAtEnd(g, exit, Ret, last)->addArgToSet(t);
+
+        g_cfg.newEdge(g_cfg.startNode(), init);
+        g_cfg.newEdge(init, body);
+        g_cfg.newEdge(body, body)->setSrcOper(brl);
+        g_cfg.newEdge(body, exit);
+        g_cfg.newEdge(exit, g_cfg.stopNode());
+        g_cfg.setValid(true);
+
+        /* Three swaps: x = 2, y = 1 */
+        UTEST_CHECK(utest, interpret(g) == 21);
+        buildSSA(g);
+        UTEST_CHECK(utest, interpret(g) == 21);
+        translateOutOfSSA(g);
+        UTEST_CHECK(utest, countOpers(g, Phi) == 0);
+        UTEST_CHECK(utest, interpret(g) == 21);
+        return utest->result();
+    }
+
+    /** Find the dependence edge between the operations */
+    static IR::DepEdge<MDes> *findDep(Oper *pred, Oper *succ, DepType type)
+    {
+        for (IR::DepEdge<MDes> *e = succ->firstPred(); isNotNullP(e); e = e->nextPred())
+        {
+            if (e->pred() == pred && e->type() == type)
+                return e;
+        }
+        return NULL;
+    }
+
+    bool uTestDeps(UnitTest *utest)
+    {
+        Module m;
+        Function *f = m.newFunction("deps");
+        CFG &cfg = f->cfg();
+        CFNode *node = cfg.newNode();
+        Oper *last = NULL;
+        Obj *t0 = f->newObject(Reg);
+        Obj *t1 = f->newObject(Reg);
+        Obj *t2 = f->newObject(Reg);
+
+        /* {0} ld t0 = 100 */
+        Oper *ld = newOperAtEnd(f, node, Ld, last);
+        ld->setArgImm(0, (Int64)100);
+        ld->setResObj(0, t0);
+
+        /* {1} add t1 = t0, t0 */
+        Oper *add = newOperAtEnd(f, node, Add, last);
+        add->setArgObj(0, t0);
+        add->setArgObj(1, t0);
+        add->setResObj(0, t1);
+
+        /* {2} st 100, t1 */
+        Oper *st = newOperAtEnd(f, node, St, last);
+        st->setArgImm(0, (Int64)100);
+        st->setArgObj(1, t1);
+
+        /* {3} mov t0 = 5 */
+        Oper *mov = newOperAtEnd(f, node, Mov, last);
+        mov->setArgImm(0, (Int64)5);
+        mov->setResObj(0, t0);
+
+        /* {4} ld t2 = 100 */
+        Oper *ld2 = newOperAtEnd(f, node, Ld, last);
+        ld2->setArgImm(0, (Int64)100);
+        ld2->setResObj(0, t2);
+
+        /* {5} ret t2 */
+        Oper *ret = newOperAtEnd(f, node, Ret, last);
+        ret->addArgToSet(t2);
+
+        cfg.newEdge(cfg.startNode(), node);
+        cfg.newEdge(node, cfg.stopNode());
+        cfg.setValid(true);
+
+        buildDeps(f);
+
+        /* Two reads of t0 in one operation give one edge */
+        UTEST_CHECK(utest, findDep(ld, add, DEP_TRUE) != NULL && findDep(ld, add, DEP_TRUE)->latency() == MDes::operDescription(Ld)->latency);
+        UTEST_CHECK(utest, findDep(add, st, DEP_TRUE) != NULL);
+        UTEST_CHECK(utest, findDep(add, mov, DEP_ANTI) != NULL && findDep(add, mov, DEP_ANTI)->latency() == 0);
+        UTEST_CHECK(utest, findDep(ld, mov, DEP_OUTPUT) != NULL);
+        UTEST_CHECK(utest, findDep(ld, st, DEP_ANTI) != NULL && findDep(ld, st, DEP_ANTI)->isMem());
+        UTEST_CHECK(utest, findDep(st, ld2, DEP_TRUE) != NULL && findDep(st, ld2, DEP_TRUE)->isMem());
+        UTEST_CHECK(utest, findDep(ld2, ret, DEP_TRUE) != NULL);
+        UTEST_CHECK(utest, findDep(st, ret, DEP_TRUE) != NULL);
+        UTEST_CHECK(utest, f->numEdges() == 8);
+
+        /* Rebuilding replaces the edges */
+        buildDeps(f);
+        UTEST_CHECK(utest, f->numEdges() == 8);
+        buildNodeDeps(f, node);
+        UTEST_CHECK(utest, f->numEdges() == 8);
+
+        /* Deleted operation takes its edges with it */
+        f->deleteOper(mov);
+        UTEST_CHECK(utest, f->numEdges() == 6);
+
+        /* A store after many loads gets one anti edge from every load */
+        const UInt32 num_loads = 1000;
+        Function *g = m.newFunction("loads");
+        CFNode *loads = g->cfg().newNode();
+        last = NULL;
+        for (UInt32 i = 0; i < num_loads; i++)
+        {
+            Oper *load = newOperAtEnd(g, loads, Ld, last);
+            load->setArgImm(0, (Int64)100);
+            load->setResObj(0, g->newObject(Reg));
+        }
+        Oper *store = newOperAtEnd(g, loads, St, last);
+        store->setArgImm(0, (Int64)100);
+        store->setArgImm(1, (Int64)0);
+        buildNodeDeps(g, loads);
+        UTEST_CHECK(utest, g->numEdges() == num_loads && store->firstPred()->isMem());
+        return utest->result();
+    }
+
+    /** Function of 10-(5+5)*2 as the lowering of the arithmetics makes it, in the order of the tree walk */
+    static const char *LOWERED_ARITHM_TEXT =
+        "Function compute( )\n"
+        "CF Node 0 Start\n"
+        "CF Edge 0: 0->2, fallthrough\n"
+        "\n"
+        "CF Node 2\n"
+        "CF Edge 0: 0->2, fallthrough\n"
+        "{0} mov vt0 = 10\n"
+        "{1} mov vt1 = 5\n"
+        "{2} mov vt2 = 5\n"
+        "{3} add vt3 = vt1, vt2\n"
+        "{4} mov vt4 = 2\n"
+        "{5} mul vt5 = vt3, vt4\n"
+        "{6} sub vt6 = vt0, vt5\n"
+        "{7} ret\n"
+        "CF Edge 1: 2->1, fallthrough\n"
+        "\n"
+        "CF Node 1 Stop\n"
+        "CF Edge 1: 2->1, fallthrough\n";
+
+    bool uTestSched(UnitTest *utest)
+    {
+        Module m;
+        Function *f = m.newFunction("sched");
+        CFG &cfg = f->cfg();
+        CFNode *node = cfg.newNode();
+        Oper *last = NULL;
+        Obj *t0 = f->newObject(Reg);
+        Obj *t1 = f->newObject(Reg);
+        Obj *t2 = f->newObject(Reg);
+        Obj *t3 = f->newObject(Reg);
+        Obj *t4 = f->newObject(Reg);
+
+        /* {0} mov t0 = 1 */
+        Oper *mov = newOperAtEnd(f, node, Mov, last);
+        mov->setArgImm(0, (Int64)1);
+        mov->setResObj(0, t0);
+
+        /* {1} add t1 = t0, 1 */
+        Oper *add = newOperAtEnd(f, node, Add, last);
+        add->setArgObj(0, t0);
+        add->setArgImm(1, (Int64)1);
+        add->setResObj(0, t1);
+
+        /* {2} mov t2 = 7 */
+        Oper *mov2 = newOperAtEnd(f, node, Mov, last);
+        mov2->setArgImm(0, (Int64)7);
+        mov2->setResObj(0, t2);
+
+        /* {3} mul t3 = t2, 3 is on the critical path */
+        Oper *mul = newOperAtEnd(f, node, Mul, last);
+        mul->setArgObj(0, t2);
+        mul->setArgImm(1, (Int64)3);
+        mul->setResObj(0, t3);
+
+        /* {4} add t4 = t3, t1 */
+        Oper *add2 = newOperAtEnd(f, node, Add, last);
+        add2->setArgObj(0, t3);
+        add2->setArgObj(1, t1);
+        add2->setResObj(0, t4);
+
+        /* {5} ret t4 */
+        Oper *ret = newOperAtEnd(f, node, Ret, last);
+        ret->addArgToSet(t4);
+
+        cfg.newEdge(cfg.startNode(), node);
+        cfg.newEdge(node, cfg.stopNode());
+        cfg.setValid(true);
+
+        UTEST_CHECK(utest, interpret(f) == 23);
+        UTEST_CHECK(utest, schedule(f));
+        UTEST_CHECK(utest, interpret(f) == 23);
+
+        /* The multiplication starts as early as possible, the return stays last */
+        UTEST_CHECK(utest, f->firstOper() == mov2 && node->firstOper() == mov2);
+        UTEST_CHECK(utest, mov2->nextOper() == mov && mov->nextOper() == mul);
+        UTEST_CHECK(utest, mul->nextOper() == add && add->nextOper() == add2);
+        UTEST_CHECK(utest, node->lastOper() == ret && add2->nextOper() == ret);
+
+        /* Every dependence goes forward in the new order */
+        UInt32 pos = 0;
+        Numeration num = f->newNum();
+        for (IR::Operation<MDes> *oper = node->firstOper(); isNotNullP(oper); oper = oper->nextInNode())
+        {
+            oper->setNumber(num, pos++);
+        }
+        UTEST_CHECK(utest, pos == 6);
+        for (IR::Operation<MDes> *oper = node->firstOper(); isNotNullP(oper); oper = oper->nextInNode())
+        {
+            for (IR::DepEdge<MDes> *e = oper->firstSucc(); isNotNullP(e); e = e->nextSucc())
+            {
+                UTEST_CHECK(utest, e->pred()->number(num) < e->succ()->number(num));
+            }
+        }
+        f->freeNum(num);
+
+        /* Scheduling the scheduled node again keeps the order */
+        UTEST_CHECK(utest, !schedule(f));
+
+        /* In the lowered arithmetics the sched pass starts the longest chain first */
+        Module low_m;
+        IR::Reader<MDes> reader(&low_m);
+        UTEST_CHECK(utest, reader.read(string(LOWERED_ARITHM_TEXT)) == 1);
+        Function *low = low_m.firstFunction();
+        PassManager pm;
+        pm.addPass(new SchedPass());
+        pm.run(low);
+        std::ostringstream order;
+        for (IR::Operation<MDes> *oper = low->firstOper(); isNotNullP(oper); oper = oper->nextOper())
+        {
+            order << oper->id() << ' ';
+        }
+        UTEST_CHECK(utest, order.str() == "1 2 3 4 5 0 6 7 ");
+        return utest->result();
+    }
+
+    bool uTestOperandSets(UnitTest *utest)
+    {
+        Module m;
+        Function *f = m.newFunction("sets");
+        CFG &cfg = f->cfg();
+        CFNode *node = cfg.newNode();
+        Oper *last = NULL;
+        const UInt32 num = 37;
+        vector<Obj *> objs;
+
+        for (UInt32 i = 0; i < num; i++)
+        {
+            objs.push_back(f->newObject(Reg));
+        }
+
+        /* Small sets stay in the operands' block of the operation */
+        Oper *ret = newOperAtEnd(f, node, Ret, last);
+        ret->addArgToSet(objs[0]);
+        UTEST_CHECK(utest, ret->numArgsInSet() == 1 && ret->argInSet(0).object() == objs[0]);
+
+        /* Large sets grow into the function's arena, the last added operand goes first */
+        Oper *call = newOperAtEnd(f, node, Call, last);
+        for (UInt32 i = 0; i < num; i++)
+        {
+            call->addArgToSet(objs[i]);
+            call->addResToSet(objs[num - 1 - i]);
+        }
+        call->addArgToSet((Int64)5);
+        UTEST_CHECK(utest, (char *)&call->argInSet(0) >= (char *)(call + 1) || (char *)&call->argInSet(0) < (char *)call);
+        UTEST_CHECK(utest, call->numArgsInSet() == num + 1 && call->numRessInSet() == num);
+        UTEST_CHECK(utest, call->argInSet(0).type() == OP_TYPE_IMM);
+        for (UInt32 i = 0; i < num; i++)
+        {
+            UTEST_CHECK(utest, call->argInSet(i + 1).object() == objs[num - 1 - i]);
+            UTEST_CHECK(utest, call->resInSet(i).object() == objs[i]);
+        }
+
+        /* Uses and definitions point to the operands at their new places */
+        for (UInt32 i = 0; i < num; i++)
+        {
+            UTEST_CHECK(utest, objs[i]->numUses() == (i == 0 ? 2 : 1) && objs[i]->numDefs() == 1);
+            UTEST_CHECK(utest, objs[i]->uses().back().oper == call);
+            UTEST_CHECK(utest, objs[i]->uses().back().op == &call->argInSet(num - i));
+            UTEST_CHECK(utest, objs[i]->defs()[0].op == &call->resInSet(i));
+        }
+
+        /* Replacing an object in the set keeps the lists in sync */
+        call->setArgObjInSet(num, objs[1]);
+        call->setResObjInSet(0, objs[1]);
+        UTEST_CHECK(utest, objs[0]->numUses() == 1 && objs[0]->numDefs() == 0);
+        UTEST_CHECK(utest, objs[1]->numUses() == 2 && objs[1]->numDefs() == 2);
+
+        /* Deleting the operation removes its operands from the lists */
+        f->deleteOper(call);
+        last = ret;
+        for (UInt32 i = 0; i < num; i++)
+        {
+            UTEST_CHECK(utest, objs[i]->numUses() == (i == 0 ? 1 : 0) && objs[i]->numDefs() == 0);
+        }
+
+        /* The freed arrays are reused by the next large set */
+        UInt64 bytes = f->arena().bytes();
+        Oper *call2 = newOperAtEnd(f, node, Call, last);
+        for (UInt32 i = 0; i < num; i++)
+        {
+            call2->addArgToSet(objs[i]);
+        }
+        UTEST_CHECK(utest, f->arena().bytes() == bytes);
+        UTEST_CHECK(utest, objs[num - 1]->uses()[0].op == &call2->argInSet(0));
+        return utest->result();
+    }
+
+    bool uTestArena(UnitTest *utest)
+    {
+        /* Arrays of the same size class are reused, other memory is only cut from the chunks */
+        IR::Arena arena;
+        void *a = arena.allocateArray(24);
+        void *b = arena.allocateArray(32);
+        UTEST_CHECK(utest, a != b && arena.numChunks() == 1);
+        arena.deallocateArray(a, 24);
+        UTEST_CHECK(utest, arena.allocateArray(17) == a);
+        UTEST_CHECK(utest, arena.allocateArray(32) != b);
+        arena.allocate(IR::ARENA_CHUNK_SIZE);
+        UTEST_CHECK(utest, arena.numChunks() == 2);
+        UTEST_CHECK(utest, arena.bytes() >= 2 * (UInt64)IR::ARENA_CHUNK_SIZE);
+
+        /* Objects are numbered densely and found by their ids */
+        Module m;
+        Function *f = m.newFunction("arena");
+        CFG &cfg = f->cfg();
+        CFNode *node = cfg.newNode();
+        Oper *last = NULL;
+        const UInt32 num = 1000;
+
+        for (UInt32 i = 0; i < num; i++)
+        {
+            Obj *obj = f->newObject(Reg);
+            UTEST_CHECK(utest, obj->id() == i && f->object(Reg, i) == obj);
+        }
+        UTEST_CHECK(utest, f->numObjects(Reg) == num);
+        UTEST_CHECK(utest, f->arena().numChunks() < num * sizeof(Obj) / IR::ARENA_CHUNK_SIZE + 2);
+
+        /* Operations share the objects, the function releases everything at once */
+        for (UInt32 i = 1; i < num; i++)
+        {
+            Oper *add = newOperAtEnd(f, node, Add, last);
+            add->setArgObj(0, f->object(Reg, i - 1));
+            add->setArgObj(1, f->object(Reg, 0));
+            add->setResObj(0, f->object(Reg, i));
+        }
+        UTEST_CHECK(utest, f->object(Reg, 0)->numUses() == num);
+        UTEST_CHECK(utest, f->object(Reg, num - 1)->numDefs() == 1 && f->object(Reg, num - 1)->numUses() == 0);
+
+        /* Operands of an operation are one array sized for its name */
+        Oper *add = last;
+        UTEST_CHECK(utest, &add->res(0) == &add->arg(1) + 1);
+        Oper *mov = newOperAtEnd(f, node, Mov, last);
+        mov->setArgImm(0, (Int64)1);
+        mov->setResObj(0, f->object(Reg, 1));
+        UTEST_CHECK(utest, f->object(Reg, 1)->numDefs() == 2);
+        mov->setName(Sub);
+        UTEST_CHECK(utest, mov->numArgs() == 2 && mov->arg(0).type() == OP_TYPES_NUM);
+        UTEST_CHECK(utest, f->object(Reg, 1)->numDefs() == 1);
+        return utest->result();
+    }
+
+    /** Print the function to string */
+    static string functionText(Function *f)
+    {
+        std::ostringstream os;
+        os << f;
+        return os.str();
+    }
+
+    /** Function without CFG with labels, symbols, sets, a float and the id of the deleted operation */
+    static Function *newLinearFunction(Module &m, const char *name)
+    {
+        Function *lin = m.newFunction(name);
+        Obj *x = lin->newArg(0, Reg);
+        Obj *y = lin->newArg(1, Reg);
+        x->setVirtual(false);
+        Oper *mov = lin->newOper(Mov);
+        mov->setArgImm(0, (Int64)-7);
+        mov->setResObj(0, x);
+        lin->setFirstOper(mov);
+        Oper *dead = lin->newOperAfter(Add, mov);
+        Oper *call = lin->newOperAfter(Call, dead);
+        call->setArgImm(0, m.symbols().intern("callee"));
+        call->addArgToSet(y);
+        call->addArgToSet((Int64)3);
+        call->addResToSet(x);
+        Oper *add = lin->newOperAfter(Add, call);
+        add->setArgObj(0, x);
+        add->setArgImm(1, 2.5);
+        add->setResObj(0, y);
+        Oper *brl = lin->newOperAfter(Brl, add);
+        brl->setArgObj(0, y);
+        brl->setArgImm(1, (Int64)100);
+        brl->setArgTarget(2, mov);
+        lin->newOperAfter(Ret, brl)->addArgToSet(y);
+        lin->deleteOper(dead);
+        return lin;
+    }
+
+    bool uTestReader(UnitTest *utest)
+    {
+        Module m;
+
+        /* Function with CFG in SSA form has phis with argument sets */
+        Function *loop = newLoopFunction(m, "loop");
+        buildSSA(loop);
+        Function *lin = newLinearFunction(m, "linear");
+
+        /* The read functions print the same text */
+        std::ostringstream os;
+        m.toStream(os);
+        Module read_m;
+        IR::Reader<MDes> reader(&read_m);
+        UTEST_CHECK(utest, reader.read(os.str()) == 2);
+
+        Function *read_loop = read_m.findFunctionByName("loop");
+        Function *read_lin = read_m.findFunctionByName("linear");
+        UTEST_CHECK(utest, isNotNullP(read_loop) && isNotNullP(read_lin));
+        UTEST_CHECK(utest, functionText(read_loop) == functionText(loop));
+        UTEST_CHECK(utest, functionText(read_lin) == functionText(lin));
+        UTEST_CHECK(utest, read_loop->cfg().isValid() && !read_lin->cfg().isValid());
+        UTEST_CHECK(utest, interpret(read_loop) == 10);
+        UTEST_CHECK(utest, read_lin->object(Reg, 0)->numDefs() == 2 && read_lin->object(Reg, 1)->numUses() == 3);
+        UTEST_CHECK(utest, read_lin->firstOper()->nextOper()->argInSet(0).constValue().intVal() == 3);
+
+        /* Malformed function is not added to the module, the functions before it are */
+        const char *bad_texts[] = {"Function bad( )\n{0} mov vt0 = 1\n{1} foo vt1 = vt0\n",
+                                   "Function ok( )\n{0} ret\n\nFunction bad( )\n{0} add <label_0> = vt0, 1\n"};
+        for (UInt32 i = 0; i < 2; i++)
+        {
+            bool caught = false;
+            try
+            {
+                reader.read(string(bad_texts[i]));
+            } catch (IR::ReadError &err)
+            {
+                caught = (err.line() == 3 + 2 * i);
+            }
+            UTEST_CHECK(utest, caught);
+            UTEST_CHECK(utest, isNullP(read_m.findFunctionByName("bad")));
+        }
+        UTEST_CHECK(utest, isNotNullP(read_m.findFunctionByName("ok")));
+
+        /* Symbol that starts like an object doesn't create objects */
+        UTEST_CHECK(utest, reader.read(string("Function sym( )\n{0} call t7foo\n{1} ret\n")) == 1);
+        Function *sym = read_m.findFunctionByName("sym");
+        UTEST_CHECK(utest, sym->numObjects(Reg) == 0);
+        UTEST_CHECK(utest, sym->firstOper()->arg(0).constValue().symVal() == read_m.symbols().intern("t7foo"));
+
+        /* Ids are bounded by the size of the text, the missing ones below them are created */
+        const char *huge_texts[] = {"Function huge( )\n{4000000000} ret\n",
+                                    "Function huge( )\n{0} ret (vt4000000)\n"};
+        for (UInt32 i = 0; i < 2; i++)
+        {
+            bool caught = false;
+            try
+            {
+                reader.read(string(huge_texts[i]));
+            } catch (IR::ReadError &err)
+            {
+                caught = (err.line() == 2);
+            }
+            UTEST_CHECK(utest, caught);
+            UTEST_CHECK(utest, isNullP(read_m.findFunctionByName("huge")));
+        }
+
+        /* Reading from the mapped file */
+        {
+            std::ofstream file("reader_utest.ir", std::ios::binary);
+            file << os.str();
+        }
+        Module file_m;
+        IR::Reader<MDes> file_reader(&file_m);
+        UTEST_CHECK(utest, file_reader.readFile("reader_utest.ir") == 2);
+        UTEST_CHECK(utest, functionText(file_m.findFunctionByName("loop")) == functionText(loop));
+        remove("reader_utest.ir");
+        return utest->result();
+    }
+
+    bool uTestBitcode(UnitTest *utest)
+    {
+        Module m;
+        Function *loop = newLoopFunction(m, "loop");
+        buildSSA(loop);
+        Function *lin = newLinearFunction(m, "linear");
+        Function *sched = newLoopFunction(m, "sched");
+        schedule(sched);
+
+        std::ostringstream os;
+        IR::BitcodeWriter<MDes> writer(&m);
+        writer.write(os);
+        string bytes = os.str();
+        UTEST_CHECK(utest, bytes == writer.bytes());
+
+        /* Only the index is read on open, functions are loaded on the first access */
+        Module read_m;
+        IR::BitcodeReader<MDes> reader(&read_m);
+        reader.open(bytes.data(), bytes.size());
+        UTEST_CHECK(utest, reader.numFunctions() == 3);
+        UTEST_CHECK(utest, isNullP(read_m.firstFunction()));
+
+        Function *read_lin = reader.function("linear");
+        UTEST_CHECK(utest, isNotNullP(read_lin) && areEqP(read_m.firstFunction(), read_lin));
+        UTEST_CHECK(utest, isNullP(read_m.findFunctionByName("loop")) && !reader.isLoaded(0));
+        UTEST_CHECK(utest, areEqP(reader.function("linear"), read_lin));
+        UTEST_CHECK(utest, isNullP(reader.function("missing")));
+        UTEST_CHECK(utest, functionText(read_lin) == functionText(lin));
+        UTEST_CHECK(utest, !read_lin->cfg().isValid());
+        UTEST_CHECK(utest, read_lin->object(Reg, 0)->numDefs() == 2 && read_lin->object(Reg, 1)->numUses() == 3);
+        UTEST_CHECK(utest, !read_lin->object(Reg, 0)->isVirtual() && read_lin->object(Reg, 1)->isVirtual());
+
+        UTEST_CHECK(utest, reader.loadAll() == 2);
+        Function *read_loop = read_m.findFunctionByName("loop");
+        Function *read_sched = read_m.findFunctionByName("sched");
+        UTEST_CHECK(utest, isNotNullP(read_loop) && isNotNullP(read_sched));
+        UTEST_CHECK(utest, functionText(read_loop) == functionText(loop));
+        UTEST_CHECK(utest, functionText(read_sched) == functionText(sched));
+        UTEST_CHECK(utest, read_loop->cfg().isValid() && interpret(read_loop) == 10);
+        UTEST_CHECK(utest, interpret(read_sched) == interpret(sched));
+        for (UInt32 i = 0; i < reader.numFunctions(); i++)
+        {
+            UTEST_CHECK(utest, reader.isLoaded(i));
+        }
+
+        /* Broken bitcode is rejected, the broken function is not added to the module */
+        string bad_magic = bytes;
+        bad_magic[0] = 'X';
+        Module bad_m;
+        IR::BitcodeReader<MDes> bad_reader(&bad_m);
+        bool caught = false;
+        try
+        {
+            bad_reader.open(bad_magic.data(), bad_magic.size());
+        } catch (IR::ReadError &err)
+        {
+            caught = (err.line() == 0);
+        }
+        UTEST_CHECK(utest, caught);
+
+        /* The first function in the file is the last created one, break its flags */
+        string broken = bytes;
+        broken[IR::BITCODE_HEADER_SIZE] = 7;
+        bad_reader.open(broken.data(), broken.size());
+        caught = false;
+        try
+        {
+            bad_reader.function("sched");
+        } catch (IR::ReadError &)
+        {
+            caught = true;
+        }
+        UTEST_CHECK(utest, caught && !bad_reader.isLoaded(0));
+        UTEST_CHECK(utest, isNullP(bad_m.findFunctionByName("sched")));
+        UTEST_CHECK(utest, functionText(bad_reader.function("loop")) == functionText(loop));
+
+        /* Loading from the mapped file */
+        {
+            std::ofstream file("bitcode_utest.irbc", std::ios::binary);
+            file << bytes;
+        }
+        {
+            Module file_m;
+            IR::BitcodeReader<MDes> file_reader(&file_m);
+            file_reader.openFile("bitcode_utest.irbc");
+            UTEST_CHECK(utest, functionText(file_reader.function("loop")) == functionText(loop));
+            UTEST_CHECK(utest, !file_reader.isLoaded(0));
+        }
+        remove("bitcode_utest.irbc");
+        return utest->result();
+    }
+
+    /** Task that counts the items it processed */
+    class CountTask: public IR::ParallelTask
+    {
+    public:
+        CountTask(UInt32 num): counts(num, 0), sum(0){}
+
+        void run(UInt32 item)
+        {
+            IR::MutexLock lock(mutex);
+            counts[item]++;
+            sum += item;
+        }
+
+        vector<UInt32> counts;
+        UInt64 sum;
+        IR::Mutex mutex;
+    };
+
+    bool uTestDriver(UnitTest *utest)
+    {
+        /* Every item is processed once, the pool is reused by the tasks */
+        IR::ThreadPool pool(4);
+        UTEST_CHECK(utest, pool.numThreads() == 4);
+        for (UInt32 k = 0; k < 3; k++)
+        {
+            CountTask task(1000);
+            pool.run(task, 1000);
+            UTEST_CHECK(utest, task.sum == 999 * 1000 / 2);
+            for (UInt32 i = 0; i < 1000; i++)
+            {
+                UTEST_CHECK(utest, task.counts[i] == 1);
+            }
+        }
+        CountTask empty(0);
+        pool.run(empty, 0);
+        UTEST_CHECK(utest, empty.sum == 0);
+
+        /* The output doesn't depend on the number of threads */
+        const UInt32 num_funcs = 16;
+        string texts[2];
+        for (UInt32 k = 0; k < 2; k++)
+        {
+            Module m;
+            for (UInt32 i = 0; i < num_funcs; i++)
+            {
+                newLoopFunction(m, "loop_" + toString(i));
+            }
+            ModuleDriver driver(k == 0 ? 1 : 4);
+            driver.addPass(buildSSA);
+            driver.addPass(schedule);
+
+            std::ostringstream os;
+            driver.run(&m, &os);
+            texts[k] = os.str();
+            for (Function *f = m.firstFunction(); isNotNullP(f); f = f->next())
+            {
+                UTEST_CHECK(utest, interpret(f) == 10);
+            }
+        }
+        UTEST_CHECK(utest, !texts[0].empty() && texts[0] == texts[1]);
+
+        /* The same as running the passes one function after another */
+        Module seq_m;
+        for (UInt32 i = 0; i < num_funcs; i++)
+        {
+            newLoopFunction(seq_m, "loop_" + toString(i));
+        }
+        std::ostringstream seq_os;
+        for (Function *f = seq_m.firstFunction(); isNotNullP(f); f = f->next())
+        {
+            buildSSA(f);
+            schedule(f);
+            seq_os << f;
+        }
+        UTEST_CHECK(utest, seq_os.str() == texts[1]);
+        return utest->result();
+    }
+
+    /** Pass that only asks for the CFG analyses and changes nothing */
+    class ProbePass: public Pass
+    {
+    public:
+        ProbePass(): Pass("probe", ANALYSES_NONE){}
+
+        bool run(Function *f, AnalysisCache &analyses)
+        {
+            const vector<CFNode *> &order = analyses.cfgOrder();
+            const DomTree &dom = analyses.domTree();
+
+            ok = order.size() == dom.numNodes() && order[0] == f->cfg().startNode();
+            for (UInt32 i = 1; i < order.size(); i++)
+            {
+                ok = ok && dom.num(order[i]) == i && dom.dominates(dom.idom(order[i]), order[i]);
+            }
+            return false;
+        }
+
+        bool ok;
+    };
+
+    bool uTestPassManager(UnitTest *utest)
+    {
+        const UInt32 num_funcs = 3;
+        Module m;
+        Module seq_m;
+        for (UInt32 i = 0; i < num_funcs; i++)
+        {
+            newLoopFunction(m, "loop_" + toString(i));
+            newLoopFunction(seq_m, "loop_" + toString(i));
+        }
+
+        /* Dominators and CFG order are shared by ssa and the probe, out of SSA drops them */
+        PassManager pm;
+        ProbePass *probe = new ProbePass();
+        pm.addPass(new SSAPass());
+        pm.addPass(probe);
+        pm.addPass(new OutOfSSAPass());
+        pm.addPass(new SchedPass());
+        pm.addPass(new SchedPass());
+        pm.addPass(new ProbePass());
+        pm.run(&m);
+        UTEST_CHECK(utest, probe->ok);
+        UTEST_CHECK(utest, pm.analysisTiming(ANALYSIS_DOM).runs == 2 * num_funcs);
+        UTEST_CHECK(utest, pm.analysisTiming(ANALYSIS_CFG_ORDER).runs == 2 * num_funcs);
+        UTEST_CHECK(utest, pm.analysisTiming(ANALYSIS_DEPS).runs == num_funcs);
+        for (UInt32 i = 0; i < 6; i++)
+        {
+            UTEST_CHECK(utest, pm.passTiming(i).runs == num_funcs);
+        }
+
+        /* The same result as the plain passes */
+        for (Function *f = m.firstFunction(), *g = seq_m.firstFunction(); isNotNullP(f); f = f->next(), g = g->next())
+        {
+            buildSSA(g);
+            translateOutOfSSA(g);
+            schedule(g);
+            schedule(g);
+            UTEST_CHECK(utest, functionText(f) == functionText(g));
+            UTEST_CHECK(utest, interpret(f) == 10);
+        }
+
+        std::ostringstream os;
+        pm.reportToStream(os);
+        UTEST_CHECK(utest, os.str().find("out-of-ssa") != string::npos);
+        UTEST_CHECK(utest, os.str().find("analysis dominators") != string::npos);
+
+        /* Only the analyses that are not preserved are dropped */
+        Function *f = m.firstFunction();
+        AnalysisCache analyses(f);
+        analyses.domTree();
+        analyses.requireDeps();
+        analyses.invalidate(analysisBit(ANALYSIS_DOM));
+        UTEST_CHECK(utest, analyses.isValid(ANALYSIS_DOM));
+        UTEST_CHECK(utest, !analyses.isValid(ANALYSIS_DEPS));
+        UTEST_CHECK(utest, !analyses.isValid(ANALYSIS_CFG_ORDER));
+        analyses.requireDeps();
+        analyses.requireDeps();
+        UTEST_CHECK(utest, analyses.timing(ANALYSIS_DEPS).runs == 2);
+        UTEST_CHECK(utest, analyses.timing(ANALYSIS_DOM).runs == 1);
+        return utest->result();
+    }
+
+    /** Check that the set holds exactly the given objects */
+    static bool hasObjects(const BitSet &live, Obj *a, Obj *b = NULL)
+    {
+        UInt32 num = (isNotNullP(a) ? 1 : 0) + (isNotNullP(b) ? 1 : 0);
+        return live.count() == num
+               && (isNullP(a) || live.test(a->id()))
+               && (isNullP(b) || live.test(b->id()));
+    }
+
+    bool uTestLiveness(UnitTest *utest)
+    {
+        /* Word kernels of the bit sets */
+        BitSet s(130);
+        BitSet t(130);
+        UTEST_CHECK(utest, s.isEmpty() && s.next(0) == BITSET_NO_BIT);
+        s.set(0);
+        s.set(64);
+        s.set(129);
+        UTEST_CHECK(utest, s.count() == 3 && s.test(64) && !s.test(63));
+        UTEST_CHECK(utest, s.next(1) == 64 && s.next(65) == 129 && s.next(130) == BITSET_NO_BIT);
+        t.set(64);
+        UTEST_CHECK(utest, !s.unite(t));
+        t.set(100);
+        UTEST_CHECK(utest, s.unite(t) && s.count() == 4);
+        s.subtract(t);
+        UTEST_CHECK(utest, s.count() == 2 && !s.test(64) && !s.test(100));
+        BitSet gen(130);
+        gen.set(5);
+        UTEST_CHECK(utest, t.assignTransfer(gen, s, s) && t.count() == 1 && t.test(5));
+        UTEST_CHECK(utest, !t.assignTransfer(gen, s, s));
+        s.intersect(gen);
+        UTEST_CHECK(utest, s.isEmpty());
+        s.set(129);
+        s.resize(100);
+        s.resize(130);
+        UTEST_CHECK(utest, !s.test(129) && s.isEmpty());
+
+        /* Live sets of the loop: i and a are live around it, only a after it */
+        Module m;
+        Function *f = newLoopFunction(m, "loop");
+        Obj *i = f->object(Reg, 0);
+        Obj *a = f->object(Reg, 1);
+        IR::Operation<MDes> *mov_i = f->firstOper();
+        IR::Operation<MDes> *brge = mov_i->nextOper()->nextOper();
+        IR::Operation<MDes> *add_i = brge->nextOper()->nextOper()->nextOper();
+        IR::Operation<MDes> *ret = add_i->nextOper()->nextOper();
+        {
+            Liveness live(f);
+            BitSet point;
+            CFG &cfg = f->cfg();
+            UTEST_CHECK(utest, live.numObjects() == 2);
+            UTEST_CHECK(utest, hasObjects(live.liveIn(mov_i->node()), NULL));
+            UTEST_CHECK(utest, hasObjects(live.liveOut(mov_i->node()), i, a));
+            UTEST_CHECK(utest, hasObjects(live.liveIn(brge->node()), i, a));
+            UTEST_CHECK(utest, hasObjects(live.liveIn(add_i->node()), i, a));
+            UTEST_CHECK(utest, hasObjects(live.liveIn(ret->node()), a));
+            UTEST_CHECK(utest, hasObjects(live.liveOut(ret->node()), NULL));
+            UTEST_CHECK(utest, hasObjects(live.liveIn(cfg.startNode()), NULL));
+            UTEST_CHECK(utest, live.isLiveOut(add_i->node(), i) && !live.isLiveIn(ret->node(), i));
+
+            /* Program points */
+            live.liveAfter(mov_i, point);
+            UTEST_CHECK(utest, hasObjects(point, i));
+            live.liveBefore(mov_i, point);
+            UTEST_CHECK(utest, hasObjects(point, NULL));
+            live.liveBefore(ret, point);
+            UTEST_CHECK(utest, hasObjects(point, a));
+            live.liveAfter(ret, point);
+            UTEST_CHECK(utest, hasObjects(point, NULL));
+
+            /* The loop makes the worklist visit some nodes again */
+            UTEST_CHECK(utest, live.numVisits() > cfg.numNodes());
+        }
+
+        /* In SSA phi arguments are live on exit of the predecessors, phi results are not live on entry */
+        buildSSA(f);
+        {
+            Liveness live(f);
+            UInt32 num_phis = 0;
+            for (CFNode *node = f->cfg().firstNode(); isNotNullP(node); node = node->nextNode())
+            {
+                for (IR::Operation<MDes> *oper = node->firstOper(); isPhi(oper); oper = oper->nextInNode())
+                {
+                    CFEdge *e = node->firstPred();
+                    for (UInt32 k = 0; k < oper->numArgsInSet(); k++, e = e->nextPred())
+                    {
+                        UTEST_CHECK(utest, live.isLiveOut(e->pred(), oper->argInSet(k).object()));
+                    }
+                    UTEST_CHECK(utest, !live.isLiveIn(node, oper->res(0).object()));
+
+                    BitSet point;
+                    live.liveAfter(oper, point);
+                    UTEST_CHECK(utest, point.test(oper->res(0).object()->id()));
+                    num_phis++;
+                }
+            }
+            UTEST_CHECK(utest, num_phis > 0);
+            UTEST_CHECK(utest, live.liveIn(mov_i->node()).isEmpty());
+        }
+
+        /* The pass manager keeps liveness until a pass changes the objects */
+        AnalysisCache analyses(f);
+        analyses.liveness();
+        analyses.invalidate(SchedPass().preserved());
+        UTEST_CHECK(utest, analyses.isValid(ANALYSIS_LIVENESS));
+        analyses.invalidate(OutOfSSAPass().preserved());
+        UTEST_CHECK(utest, !analyses.isValid(ANALYSIS_LIVENESS));
+        analyses.liveness();
+        UTEST_CHECK(utest, analyses.timing(ANALYSIS_LIVENESS).runs == 2);
+        return utest->result();
+    }
+
+    /** Forward problem of the least number of nodes on a path from the start node */
+    class DistanceProblem
+    {
+    public:
+        typedef UInt32 Value;
+
+        IR::DataflowDir direction() const { return IR::DATAFLOW_FORWARD; }
+        void init(UInt32 &v) const { v = (UInt32)-1; }
+        void boundary(UInt32 &v) const { v = 0; }
+        void meet(UInt32 &dst, const UInt32 &src) const { dst = min(dst, src); }
+
+        bool transfer(CFNode *, UInt32, const UInt32 &in, UInt32 &out) const
+        {
+            UInt32 res = in == (UInt32)-1 ? in : in + 1;
+            bool changed = res != out;
+            out = res;
+            return changed;
+        }
+    };
+
+    bool uTestDataflow(UnitTest *utest)
+    {
+        /* The set changes its form with density and keeps its members */
+        IR::DataflowSet s(1000);
+        for (UInt32 i = 0; i < 31; i++)
+        {
+            s.set(i * 3);
+        }
+        UTEST_CHECK(utest, !s.isDense() && s.count() == 31 && s.test(30) && !s.test(31));
+        s.set(999);
+        UTEST_CHECK(utest, s.isDense() && s.count() == 32 && s.next(91) == 999);
+        for (UInt32 i = 0; i < 20; i++)
+        {
+            s.reset(i * 3);
+        }
+        UTEST_CHECK(utest, !s.isDense() && s.count() == 12 && s.next(0) == 60);
+
+        /* Operations on the sets of both forms agree with std::set */
+        UInt32 seed = 12345;
+        for (UInt32 k = 0; k < 200; k++)
+        {
+            IR::DataflowSet sets[3] = {IR::DataflowSet(500), IR::DataflowSet(500), IR::DataflowSet(500)};
+            std::set<UInt32> refs[3];
+            for (UInt32 j = 0; j < 3; j++)
+            {
+                seed = seed * 1103515245 + 12345;
+                UInt32 num = (seed >> 8) % 100;
+                for (UInt32 i = 0; i < num; i++)
+                {
+                    seed = seed * 1103515245 + 12345;
+                    sets[j].set((seed >> 8) % 500);
+                    refs[j].insert((seed >> 8) % 500);
+                }
+            }
+            IR::DataflowSet res(500);
+            std::set<UInt32> ref;
+            for (UInt32 i = 0; i < 500; i++)
+            {
+                if (refs[0].count(i) || (refs[1].count(i) && !refs[2].count(i)))
+                {
+                    ref.insert(i);
+                }
+            }
+            UTEST_CHECK(utest, res.assignTransfer(sets[0], sets[1], sets[2]) == !ref.empty());
+            UTEST_CHECK(utest, !res.assignTransfer(sets[0], sets[1], sets[2]));
+            UTEST_CHECK(utest, res.count() == ref.size());
+            UInt32 found = 0;
+            for (UInt32 i = res.next(0); i != BITSET_NO_BIT; i = res.next(i + 1))
+            {
+                UTEST_CHECK(utest, ref.count(i) == 1);
+                found++;
+            }
+            UTEST_CHECK(utest, found == ref.size());
+            sets[1].unite(sets[0]);
+            sets[1].subtract(sets[0]);
+            res = sets[1];
+            res.unite(sets[0]);
+            res.subtract(sets[2]);
+            for (UInt32 i = 0; i < 500; i++)
+            {
+                bool in = (refs[0].count(i) || refs[1].count(i)) && !refs[2].count(i);
+                UTEST_CHECK(utest, res.test(i) == in);
+            }
+        }
+
+        /* Backward gen-kill problem gives the same liveness as the analysis */
+        Module m;
+        Function *f = newLoopFunction(m, "loop");
+        UInt32 num_objs = f->numObjects(Reg);
+        Liveness live(f);
+        IR::GenKillProblem problem(IR::DATAFLOW_BACKWARD, f->cfg().numNodes(), num_objs);
+        IR::DataflowSolver<MDes, IR::GenKillProblem> solver(&f->cfg(), problem);
+        for (CFNode *node = f->cfg().firstNode(); isNotNullP(node); node = node->nextNode())
+        {
+            IR::DataflowSet &gen = problem.gen(solver.index(node));
+            IR::DataflowSet &kill = problem.kill(solver.index(node));
+            for (IR::Operation<MDes> *oper = node->firstOper(); isNotNullP(oper); oper = oper->nextInNode())
+            {
+                for (UInt32 i = 0; i < oper->numArgs(); i++)
+                {
+                    if (oper->arg(i).type() == OP_TYPE_OBJ && !kill.test(oper->arg(i).object()->id()))
+                    {
+                        gen.set(oper->arg(i).object()->id());
+                    }
+                }
+                for (UInt32 i = 0; i < oper->numArgsInSet(); i++)
+                {
+                    if (oper->argInSet(i).type() == OP_TYPE_OBJ && !kill.test(oper->argInSet(i).object()->id()))
+                    {
+                        gen.set(oper->argInSet(i).object()->id());
+                    }
+                }
+                for (UInt32 i = 0; i < oper->numRess(); i++)
+                {
+                    if (oper->res(i).type() == OP_TYPE_OBJ)
+                    {
+                        kill.set(oper->res(i).object()->id());
+                    }
+                }
+            }
+        }
+        solver.solve();
+        for (CFNode *node = f->cfg().firstNode(); isNotNullP(node); node = node->nextNode())
+        {
+            for (UInt32 i = 0; i < num_objs; i++)
+            {
+                UTEST_CHECK(utest, solver.entry(node).test(i) == live.liveIn(node).test(i));
+                UTEST_CHECK(utest, solver.exit(node).test(i) == live.liveOut(node).test(i));
+            }
+        }
+        UTEST_CHECK(utest, solver.numVisits() < 2 * solver.numNodes());
+
+        /* Forward problem with its own lattice */
+        DistanceProblem dist;
+        IR::DataflowSolver<MDes, DistanceProblem> dist_solver(&f->cfg(), dist);
+        dist_solver.solve();
+        IR::Operation<MDes> *brge = f->firstOper()->nextOper()->nextOper();
+        IR::Operation<MDes> *add_i = brge->nextOper()->nextOper()->nextOper();
+        UTEST_CHECK(utest, dist_solver.exit(f->cfg().startNode()) == 1);
+        UTEST_CHECK(utest, dist_solver.exit(brge->node()) == 3);
+        UTEST_CHECK(utest, dist_solver.entry(add_i->node()) == 4);
+        UTEST_CHECK(utest, dist_solver.exit(f->cfg().stopNode()) == 5);
+        UTEST_CHECK(utest, dist_solver.numVisits() < 2 * dist_solver.numNodes());
+        return utest->result();
+    }
+
+    /**
+     * Create the function computing x = 3; y = x * 4; if (y cmp 10) r = 2; else r = 1; return r
+     * where the comparison is made by the given branch
+     */
+    static Function *newConstBranchFunction(Module &m, string name, OptOperName br_name)
+    {
+        Function *f = m.newFunction(name);
+        CFG &cfg = f->cfg();
+        Oper *last = NULL;
+        CFNode *cond = cfg.newNode();
+        CFNode *other = cfg.newNode();
+        CFNode *then = cfg.newNode();
+        CFNode *join = cfg.newNode();
+        Obj *x = f->newObject(Reg);
+        Obj *y = f->newObject(Reg);
+        Obj *r = f->newObject(Reg);
+
+        Oper *mov_x = newOperAtEnd(f, cond, Mov, last);
+        mov_x->setArgImm(0, (Int64)3);
+        mov_x->setResObj(0, x);
+        Oper *mul = newOperAtEnd(f, cond, Mul, last);
+        mul->setArgObj(0, x);
+        mul->setArgImm(1, (Int64)4);
+        mul->setResObj(0, y);
+        Oper *branch = newOperAtEnd(f, cond, br_name, last);
+        branch->setArgObj(0, y);
+        branch->setArgImm(1, (Int64)10);
+
+        Oper *mov_1 = newOperAtEnd(f, other, Mov, last);
+        mov_1->setArgImm(0, (Int64)1);
+        mov_1->setResObj(0, r);
+        Oper *br = newOperAtEnd(f, other, Br, last);
+
+        Oper *mov_2 = newOperAtEnd(f, then, Mov, last);
+        mov_2->setArgImm(0, (Int64)2);
+        mov_2->setResObj(0, r);
+
+        Oper *ret = newOperAtEnd(f, join, Ret, last);
+        ret->addArgToSet(r);
+
+        branch->setArgTarget(2, mov_2);
+        br->setArgTarget(0, ret);
+
+        cfg.newEdge(cfg.startNode(), cond);
+        cfg.newEdge(cond, other);
+        cfg.newEdge(cond, then)->setSrcOper(branch);
+        cfg.newEdge(other, join)->setSrcOper(br);
+        cfg.newEdge(then, join);
+        cfg.newEdge(join, cfg.stopNode());
+        cfg.setValid(true);
+        return f;
+    }
+
+    bool uTestSCCP(UnitTest *utest)
+    {
+        /* Nothing is constant in the loop */
+        Module m;
+        Function *loop = newLoopFunction(m, "loop");
+        UTEST_CHECK(utest, !propagateConstants(loop));
+        UTEST_CHECK(utest, interpret(loop) == 10 && loop->cfg().numNodes() == 8);
+        buildSSA(loop);
+        UTEST_CHECK(utest, !propagateConstants(loop));
+        UTEST_CHECK(utest, interpret(loop) == 10);
+
+        /* Taken branch becomes the jump, the fall through node is deleted with its operations */
+        Function *taken = newConstBranchFunction(m, "taken", Brg);
+        UTEST_CHECK(utest, propagateConstants(taken));
+        UTEST_CHECK(utest, interpret(taken) == 2 && taken->cfg().numNodes() == 5);
+        UTEST_CHECK(utest, countOpers(taken, Mul) == 0 && countOpers(taken, Brg) == 0);
+        UTEST_CHECK(utest, countOpers(taken, Br) == 1 && countOpers(taken, Mov) == 1);
+        IR::Operation<MDes> *jump = taken->firstOper();
+        UTEST_CHECK(utest, jump->name() == Br && jump->arg(0).target() == jump->nextOper());
+        UTEST_CHECK(utest, jump->node()->firstSucc()->srcOper() == jump);
+        UTEST_CHECK(utest, isNullP(jump->node()->firstSucc()->nextSucc()));
+
+        /* Branch that is never taken is deleted with its target node */
+        Function *not_taken = newConstBranchFunction(m, "not_taken", Brl);
+        UTEST_CHECK(utest, propagateConstants(not_taken));
+        UTEST_CHECK(utest, interpret(not_taken) == 1 && not_taken->cfg().numNodes() == 5);
+        UTEST_CHECK(utest, countOpers(not_taken, Brl) == 0 && countOpers(not_taken, Mov) == 1);
+        UTEST_CHECK(utest, not_taken->firstOper()->name() == Mov);
+        UTEST_CHECK(utest, not_taken->firstOper()->arg(0).constValue().intVal() == 1);
+        UTEST_CHECK(utest, !propagateConstants(not_taken));
+
+        /* Phi loses the argument of the deleted edge */
+        Function *ssa = newConstBranchFunction(m, "ssa", Brg);
+        buildSSA(ssa);
+        UTEST_CHECK(utest, countOpers(ssa, Phi) == 1);
+        PassManager pm;
+        pm.addPass(new SCCPPass);
+        pm.run(ssa);
+        UTEST_CHECK(utest, interpret(ssa) == 2 && ssa->cfg().numNodes() == 5);
+        UTEST_CHECK(utest, countOpers(ssa, Phi) == 1 && countOpers(ssa, Mov) == 1);
+        for (CFNode *node = ssa->cfg().firstNode(); isNotNullP(node); node = node->nextNode())
+        {
+            if (isPhi(node->firstOper()))
+            {
+                UTEST_CHECK(utest, node->firstOper()->numArgsInSet() == 1);
+                UTEST_CHECK(utest, isNullP(node->firstPred()->nextPred()));
+            }
+        }
+        UTEST_CHECK(utest, pm.passTiming(0).runs == 1);
+
+        /* Arithmetics on constants collapses into one move, only the computed value is kept */
+        Function *arithm = m.newFunction("arithm");
+        CFNode *node = arithm->cfg().newNode();
+        Oper *last = NULL;
+        Obj *t[6];
+        for (UInt32 i = 0; i < 6; i++)
+        {
+            t[i] = arithm->newObject(Reg);
+        }
+        Oper *mov = newOperAtEnd(arithm, node, Mov, last);
+        mov->setArgImm(0, (Int64)10);
+        mov->setResObj(0, t[0]);
+        Oper *add = newOperAtEnd(arithm, node, Add, last);
+        add->setArgImm(0, (Int64)5);
+        add->setArgImm(1, (Int64)5);
+        add->setResObj(0, t[1]);
+        Oper *mul = newOperAtEnd(arithm, node, Mul, last);
+        mul->setArgObj(0, t[1]);
+        mul->setArgImm(1, (Int64)2);
+        mul->setResObj(0, t[2]);
+        Oper *sub = newOperAtEnd(arithm, node, Sub, last);
+        sub->setArgObj(0, t[0]);
+        sub->setArgObj(1, t[2]);
+        sub->setResObj(0, t[3]);
+        Oper *div = newOperAtEnd(arithm, node, Div, last);
+        div->setArgObj(0, t[3]);
+        div->setArgImm(1, (Int64)0);
+        div->setResObj(0, t[4]);
+        newOperAtEnd(arithm, node, Ret, last)->addArgToSet(t[4]);
+        arithm->cfg().newEdge(arithm->cfg().startNode(), node);
+        arithm->cfg().newEdge(node, arithm->cfg().stopNode());
+        arithm->cfg().setValid(true);
+        UTEST_CHECK(utest, propagateConstants(arithm));
+        UTEST_CHECK(utest, countOpers(arithm, Mov) == 0 && countOpers(arithm, Div) == 1);
+        UTEST_CHECK(utest, arithm->firstOper() == div && div->arg(0).constValue().intVal() == -10);
+
+        /* The lowered 10-(5+5)*2 collapses into the move of its value */
+        Module low_m;
+        IR::Reader<MDes> reader(&low_m);
+        UTEST_CHECK(utest, reader.read(string(LOWERED_ARITHM_TEXT)) == 1);
+        Function *low = low_m.firstFunction();
+        UTEST_CHECK(utest, propagateConstants(low));
+        UTEST_CHECK(utest, countOpers(low, Mov) == 1 && low->firstOper()->name() == Mov);
+        UTEST_CHECK(utest, low->firstOper()->arg(0).constValue().intVal() == -10);
+        UTEST_CHECK(utest, low->firstOper()->nextOper()->name() == Ret);
+        UTEST_CHECK(utest, isNullP(low->firstOper()->nextOper()->nextOper()));
+        return utest->result();
+    }
+
+    bool uTestDCE(UnitTest *utest)
+    {
+        Module m;
+        Function *f = m.newFunction("dead");
+        CFG &cfg = f->cfg();
+        Oper *last = NULL;
+        CFNode *cond = cfg.newNode();
+        CFNode *other = cfg.newNode();
+        CFNode *then = cfg.newNode();
+        CFNode *join = cfg.newNode();
+        CFNode *unreachable = cfg.newNode();
+        Obj *r = f->newObject(Reg);
+        Obj *x = f->newObject(Reg);
+        Obj *w = f->newObject(Reg);
+        Obj *d = f->newObject(Reg);
+
+        Oper *mov_r = newOperAtEnd(f, cond, Mov, last);
+        mov_r->setArgImm(0, (Int64)2);
+        mov_r->setResObj(0, r);
+        Oper *mov_x = newOperAtEnd(f, cond, Mov, last);
+        mov_x->setArgImm(0, (Int64)3);
+        mov_x->setResObj(0, x);
+        Oper *add = newOperAtEnd(f, cond, Add, last);
+        add->setArgObj(0, x);
+        add->setArgImm(1, (Int64)1);
+        add->setResObj(0, w);
+        Oper *brg = newOperAtEnd(f, cond, Brg, last);
+        brg->setArgObj(0, x);
+        brg->setArgImm(1, (Int64)1);
+
+        Oper *mov_1 = newOperAtEnd(f, other, Mov, last);
+        mov_1->setArgImm(0, (Int64)1);
+        mov_1->setResObj(0, r);
+        Oper *br = newOperAtEnd(f, other, Br, last);
+
+        /* The only operation of the jump target is dead */
+        Oper *mul = newOperAtEnd(f, then, Mul, last);
+        mul->setArgObj(0, x);
+        mul->setArgObj(1, w);
+        mul->setResObj(0, d);
+
+        Oper *ret = newOperAtEnd(f, join, Ret, last);
+        ret->addArgToSet(r);
+
+        Oper *mov_w = newOperAtEnd(f, unreachable, Mov, last);
+        mov_w->setArgImm(0, (Int64)5);
+        mov_w->setResObj(0, w);
+
+        brg->setArgTarget(2, mul);
+        br->setArgTarget(0, ret);
+        cfg.newEdge(cfg.startNode(), cond);
+        cfg.newEdge(cond, other);
+        cfg.newEdge(cond, then)->setSrcOper(brg);
+        cfg.newEdge(other, join)->setSrcOper(br);
+        cfg.newEdge(then, join);
+        cfg.newEdge(unreachable, join);
+        cfg.newEdge(join, cfg.stopNode());
+        cfg.setValid(true);
+        UTEST_CHECK(utest, interpret(f) == 2 && cfg.numNodes() == 7);
+
+        /* Dead operations, the unreachable node and the emptied jump target are deleted */
+        UTEST_CHECK(utest, eliminateDeadCode(f));
+        UTEST_CHECK(utest, interpret(f) == 2 && cfg.numNodes() == 5);
+        UTEST_CHECK(utest, countOpers(f, Mul) == 0 && countOpers(f, Add) == 0 && countOpers(f, Mov) == 3);
+        UTEST_CHECK(utest, brg->arg(2).target() == ret && w->numDefs() == 0 && d->numDefs() == 0);
+        UInt32 num_opers = 0;
+        for (IR::Operation<MDes> *oper = f->firstOper(); isNotNullP(oper); oper = oper->nextOper())
+        {
+            num_opers++;
+        }
+        UTEST_CHECK(utest, num_opers == 6);
+        UInt32 num_jumps = 0;
+        for (CFEdge *e = ret->node()->firstPred(); isNotNullP(e); e = e->nextPred())
+        {
+            if (e->srcOper() == brg)
+                num_jumps++;
+        }
+        UTEST_CHECK(utest, num_jumps == 1);
+        UTEST_CHECK(utest, !eliminateDeadCode(f));
+
+        /* Everything is live in the loop */
+        Function *loop = newLoopFunction(m, "loop");
+        buildSSA(loop);
+        UTEST_CHECK(utest, !eliminateDeadCode(loop));
+        UTEST_CHECK(utest, interpret(loop) == 10);
+
+        /* Constant propagation leaves the empty node that is bypassed then */
+        Function *branch = newConstBranchFunction(m, "branch", Brl);
+        buildSSA(branch);
+        PassManager pm;
+        pm.addPass(new SCCPPass);
+        pm.addPass(new DCEPass);
+        pm.run(branch);
+        UTEST_CHECK(utest, interpret(branch) == 1 && branch->cfg().numNodes() == 4);
+        UTEST_CHECK(utest, branch->cfg().startNode()->firstSucc()->succ() == branch->firstOper()->node());
+        return utest->result();
+    }
+
+    /** Create operation at the end of the node computing the result from two arguments, NULL stands for the immediate */
+    static Oper *newBinaryAtEnd(Function *f, CFNode *node, OptOperName name, Oper *&last,
+                                Obj *res, Obj *arg0, Obj *arg1, Int64 imm)
+    {
+        Oper *oper = newOperAtEnd(f, node, name, last);
+        if (isNotNullP(arg0))
+            oper->setArgObj(0, arg0);
+        else
+            oper->setArgImm(0, imm);
+        if (isNotNullP(arg1))
+            oper->setArgObj(1, arg1);
+        else
+            oper->setArgImm(1, imm);
+        if (isNotNullP(res))
+            oper->setResObj(0, res);
+        return oper;
+    }
+
+    /**
+     * Create the function computing the same expressions in the dominating node, in both branches
+     * and in the join node. Returns 22
+     */
+    static Function *newRedundantFunction(Module &m, string name)
+    {
+        Function *f = m.newFunction(name);
+        CFG &cfg = f->cfg();
+        Oper *last = NULL;
+        CFNode *cond = cfg.newNode();
+        CFNode *other = cfg.newNode();
+        CFNode *then = cfg.newNode();
+        CFNode *join = cfg.newNode();
+        Obj *t[13];
+        for (UInt32 i = 0; i < 13; i++)
+        {
+            t[i] = f->newObject(Reg);
+        }
+        Obj *a = t[0], *b = t[1], *c = t[10], *k1 = t[11], *k2 = t[12];
+
+        Oper *mov_a = newOperAtEnd(f, cond, Mov, last);
+        mov_a->setArgImm(0, (Int64)4);
+        mov_a->setResObj(0, a);
+        Oper *mov_b = newOperAtEnd(f, cond, Mov, last);
+        mov_b->setArgImm(0, (Int64)3);
+        mov_b->setResObj(0, b);
+        newBinaryAtEnd(f, cond, Add, last, t[2], a, b, 0);
+        newBinaryAtEnd(f, cond, Add, last, t[3], b, a, 0);
+        newBinaryAtEnd(f, cond, Mul, last, t[4], t[2], NULL, 3);
+        Oper *mov_c = newOperAtEnd(f, cond, Mov, last);
+        mov_c->setArgObj(0, t[2]);
+        mov_c->setResObj(0, c);
+        newBinaryAtEnd(f, cond, St, last, NULL, c, NULL, 1);
+        Oper *mov_k1 = newOperAtEnd(f, cond, Mov, last);
+        mov_k1->setArgImm(0, (Int64)7);
+        mov_k1->setResObj(0, k1);
+        newBinaryAtEnd(f, cond, St, last, NULL, k1, NULL, 2);
+        Oper *brg = newBinaryAtEnd(f, cond, Brg, last, NULL, a, NULL, 0);
+
+        newBinaryAtEnd(f, other, Mul, last, t[5], t[3], NULL, 3);
+        newBinaryAtEnd(f, other, Sub, last, t[6], a, b, 0);
+        newBinaryAtEnd(f, other, St, last, NULL, t[5], t[6], 0);
+        Oper *br = newOperAtEnd(f, other, Br, last);
+
+        Oper *sub = newBinaryAtEnd(f, then, Sub, last, t[7], a, b, 0);
+        Oper *mov_k2 = newOperAtEnd(f, then, Mov, last);
+        mov_k2->setArgImm(0, (Int64)7);
+        mov_k2->setResObj(0, k2);
+        newBinaryAtEnd(f, then, St, last, NULL, t[7], k2, 0);
+
+        Oper *sub_join = newBinaryAtEnd(f, join, Sub, last, t[8], a, b, 0);
+        newBinaryAtEnd(f, join, Add, last, t[9], t[4], t[8], 0);
+        newOperAtEnd(f, join, Ret, last)->addArgToSet(t[9]);
+
+        brg->setArgTarget(2, sub);
+        br->setArgTarget(0, sub_join);
+        cfg.newEdge(cfg.startNode(), cond);
+        cfg.newEdge(cond, other);
+        cfg.newEdge(cond, then)->setSrcOper(brg);
+        cfg.newEdge(other, join)->setSrcOper(br);
+        cfg.newEdge(then, join);
+        cfg.newEdge(join, cfg.stopNode());
+        cfg.setValid(true);
+        return f;
+    }
+
+    bool uTestGVN(UnitTest *utest)
+    {
+        Module m;
+        Function *f = newRedundantFunction(m, "redundant");
+        UTEST_CHECK(utest, interpret(f) == 22);
+        UTEST_CHECK(utest, numberValues(f));
+        UTEST_CHECK(utest, interpret(f) == 22);
+
+        /* Commuted add, the multiplication of its copy and the repeated immediate are replaced */
+        UTEST_CHECK(utest, countOpers(f, Add) == 2 && countOpers(f, Mul) == 1 && countOpers(f, Mov) == 3);
+
+        /* Subtractions of the branches and of the join are not dominated by each other */
+        UTEST_CHECK(utest, countOpers(f, Sub) == 3);
+
+        /* Stores use the available values */
+        for (IR::Operation<MDes> *oper = f->firstOper(); isNotNullP(oper); oper = oper->nextOper())
+        {
+            if (oper->name() != St)
+                continue;
+            IR::Operation<MDes> *def0 = oper->arg(0).object()->defs()[0].oper;
+            if (oper->arg(1).type() == OP_TYPE_IMM)
+            {
+                UTEST_CHECK(utest, def0->name() == (oper->arg(1).constValue().intVal() == 1 ? Add : Mov));
+            } else if (def0->name() == Mul)
+            {
+                UTEST_CHECK(utest, def0->node() != oper->node());
+            } else
+            {
+                IR::Operation<MDes> *def1 = oper->arg(1).object()->defs()[0].oper;
+                UTEST_CHECK(utest, def0->name() == Sub && def1->name() == Mov && def1->node() != oper->node());
+            }
+        }
+        UTEST_CHECK(utest, !numberValues(f));
+
+        /* Objects defined twice take no part, in SSA form the initial zeros of the loop are one value */
+        Function *loop = newLoopFunction(m, "loop");
+        UTEST_CHECK(utest, !numberValues(loop));
+        buildSSA(loop);
+        UTEST_CHECK(utest, numberValues(loop));
+        UTEST_CHECK(utest, countOpers(loop, Mov) == 1 && interpret(loop) == 10);
+
+        /*
+         * Redefined argument and a copy of an object defined after it keep their values:
+         * mov c = 5; add t = a, 1; mov a = 5; mov d = b; mov b = 2; add u = t, d; add r = u, b; ret r
+         */
+        Function *h = m.newFunction("redefined");
+        CFNode *node = h->cfg().newNode();
+        Oper *last = NULL;
+        Obj *a = h->newArg(0, Reg);
+        Obj *b = h->newObject(Reg), *c = h->newObject(Reg), *d = h->newObject(Reg);
+        Obj *t = h->newObject(Reg), *u = h->newObject(Reg), *r = h->newObject(Reg);
+        Oper *mov_c = newOperAtEnd(h, node, Mov, last);
+        mov_c->setArgImm(0, (Int64)5);
+        mov_c->setResObj(0, c);
+        newBinaryAtEnd(h, node, Add, last, t, a, NULL, 1);
+        Oper *mov_a = newOperAtEnd(h, node, Mov, last);
+        mov_a->setArgImm(0, (Int64)5);
+        mov_a->setResObj(0, a);
+        Oper *mov_d = newOperAtEnd(h, node, Mov, last);
+        mov_d->setArgObj(0, b);
+        mov_d->setResObj(0, d);
+        Oper *mov_b = newOperAtEnd(h, node, Mov, last);
+        mov_b->setArgImm(0, (Int64)2);
+        mov_b->setResObj(0, b);
+        newBinaryAtEnd(h, node, Add, last, u, t, d, 0);
+        newBinaryAtEnd(h, node, Add, last, r, u, b, 0);
+        newOperAtEnd(h, node, Ret, last)->addArgToSet(r);
+        h->cfg().newEdge(h->cfg().startNode(), node);
+        h->cfg().newEdge(node, h->cfg().stopNode());
+        h->cfg().setValid(true);
+        UTEST_CHECK(utest, interpret(h) == 3);
+        UTEST_CHECK(utest, !numberValues(h));
+        UTEST_CHECK(utest, interpret(h) == 3 && t->defs()[0].oper->arg(0).object() == a);
+
+        /* Passes share the dominator tree */
+        Function *g = newRedundantFunction(m, "pipeline");
+        PassManager pm;
+        pm.addPass(new GVNPass);
+        pm.addPass(new GVNPass);
+        pm.run(g);
+        UTEST_CHECK(utest, interpret(g) == 22 && countOpers(g, Add) == 2);
+        UTEST_CHECK(utest, pm.analysisTiming(ANALYSIS_DOM).runs == 1);
         return utest->result();
     }
 }
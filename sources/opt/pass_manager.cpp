@@ -0,0 +1,358 @@
+/**
+ * @file: opt/pass_manager.cpp
+ * Implementation of the pass manager and the analysis cache
+ * @ingroup OPT
+ */
+ /*
+  * Copyright 2012 MIPT-COMPILER team
+  */
+#include "opt_iface.hpp"
+#include <iomanip>
+
+#if defined(_WIN32)
+#  include <windows.h>
+#else
+#  include <time.h>
+#endif
+
+namespace Opt
+{
+    /** Get wall clock time in nanoseconds */
+    static UInt64 timeNs()
+    {
+#if defined(_WIN32)
+        LARGE_INTEGER freq;
+        LARGE_INTEGER cnt;
+
+        QueryPerformanceFrequency( &freq);
+        QueryPerformanceCounter( &cnt);
+        return (UInt64)( (double)cnt.QuadPart * 1e9 / (double)freq.QuadPart);
+#else
+        struct timespec ts;
+
+        clock_gettime( CLOCK_MONOTONIC, &ts);
+        return (UInt64)ts.tv_sec * 1000000000 + (UInt64)ts.tv_nsec;
+#endif
+    }
+
+    /** Get name of the analysis */
+    const char *analysisName( AnalysisKind kind)
+    {
+        switch ( kind)
+        {
+            case ANALYSIS_CFG_ORDER:
+                return "cfg-order";
+            case ANALYSIS_DOM:
+                return "dominators";
+            case ANALYSIS_LIVENESS:
+                return "liveness";
+            case ANALYSIS_DEPS:
+                return "deps";
+            default:
+                IR_ASSERTXD( 0, "Unknown analysis");
+                return "";
+        }
+    }
+
+    AnalysisCache::AnalysisCache( Function *f): func( f), valid( ANALYSES_NONE), dom( NULL), live( NULL)
+    {
+        for ( UInt32 i = 0; i < ANALYSES_NUM; i++)
+        {
+            timings[ i].name = analysisName( (AnalysisKind)i);
+        }
+    }
+
+    AnalysisCache::~AnalysisCache()
+    {
+        delete dom;
+        delete live;
+    }
+
+    /** Account the computation of the analysis started at the given time and memory */
+    void AnalysisCache::computed( AnalysisKind kind, UInt64 start_ns, UInt64 start_mem)
+    {
+        valid |= analysisBit( kind);
+        timings[ kind].runs++;
+        timings[ kind].time_ns += timeNs() - start_ns;
+        timings[ kind].mem_delta += (Int64)func->memBytes() - (Int64)start_mem;
+    }
+
+    /** Get the nodes reachable from the start node in reverse postorder */
+    const vector< CFNode *> &AnalysisCache::cfgOrder()
+    {
+        if ( isValid( ANALYSIS_CFG_ORDER) )
+            return order;
+
+        UInt64 start_ns = timeNs();
+        UInt64 start_mem = func->memBytes();
+        CFG &cfg = func->cfg();
+
+        if ( isValid( ANALYSIS_DOM) )
+        {
+            /* The dominator tree has the same order */
+            order.resize( dom->numNodes());
+            for ( UInt32 i = 0; i < dom->numNodes(); i++)
+            {
+                order[ i] = dom->node( i);
+            }
+        } else
+        {
+            Numeration topo_num = cfg.makeTopologicalNumeration();
+            GraphNum start_num = cfg.startNode()->number( topo_num);
+
+            order.assign( cfg.numNodes() - start_num, NULL);
+            for ( CFNode *node = cfg.firstNode(); isNotNullP( node); node = node->nextNode())
+            {
+                if ( node->number( topo_num) >= start_num )
+                {
+                    order[ node->number( topo_num) - start_num] = node;
+                }
+            }
+            cfg.freeNum( topo_num);
+        }
+        computed( ANALYSIS_CFG_ORDER, start_ns, start_mem);
+        return order;
+    }
+
+    /** Get the dominator tree of the CFG */
+    const DomTree &AnalysisCache::domTree()
+    {
+        if ( !isValid( ANALYSIS_DOM) )
+        {
+            UInt64 start_ns = timeNs();
+            UInt64 start_mem = func->memBytes();
+
+            dom = new DomTree( &func->cfg());
+            computed( ANALYSIS_DOM, start_ns, start_mem);
+        }
+        return *dom;
+    }
+
+    /** Get the liveness of the function's objects */
+    const Liveness &AnalysisCache::liveness()
+    {
+        if ( !isValid( ANALYSIS_LIVENESS) )
+        {
+            UInt64 start_ns = timeNs();
+            UInt64 start_mem = func->memBytes();
+
+            live = new Liveness( func);
+            computed( ANALYSIS_LIVENESS, start_ns, start_mem);
+        }
+        return *live;
+    }
+
+    /** Make sure the dependence edges of the function are built */
+    void AnalysisCache::requireDeps()
+    {
+        if ( !isValid( ANALYSIS_DEPS) )
+        {
+            UInt64 start_ns = timeNs();
+            UInt64 start_mem = func->memBytes();
+
+            buildDeps( func);
+            computed( ANALYSIS_DEPS, start_ns, start_mem);
+        }
+    }
+
+    /** Drop all the analyses except the preserved ones */
+    void AnalysisCache::invalidate( AnalysisSet preserved)
+    {
+        AnalysisSet dropped = valid & ~preserved;
+
+        if ( dropped & analysisBit( ANALYSIS_CFG_ORDER) )
+        {
+            order.clear();
+        }
+        if ( dropped & analysisBit( ANALYSIS_DOM) )
+        {
+            /* Releases the numeration of the CFG */
+            delete dom;
+            dom = NULL;
+        }
+        if ( dropped & analysisBit( ANALYSIS_LIVENESS) )
+        {
+            delete live;
+            live = NULL;
+        }
+        if ( dropped & analysisBit( ANALYSIS_DEPS) )
+        {
+            func->clearDeps();
+        }
+        valid &= preserved;
+    }
+
+    /** Run the plain function pass */
+    bool SimplePass::run( Function *f, AnalysisCache &)
+    {
+        return pass( f);
+    }
+
+    /** Build SSA over the cached dominator tree */
+    bool SSAPass::run( Function *f, AnalysisCache &analyses)
+    {
+        return buildSSA( f, analyses.domTree());
+    }
+
+    /** Translate the function out of SSA */
+    bool OutOfSSAPass::run( Function *f, AnalysisCache &)
+    {
+        return translateOutOfSSA( f);
+    }
+
+    /** Schedule every node over the cached dependence edges */
+    bool SchedPass::run( Function *f, AnalysisCache &analyses)
+    {
+        bool changed = false;
+
+        analyses.requireDeps();
+        for ( CFNode *node = f->cfg().firstNode(); isNotNullP( node); node = node->nextNode())
+        {
+            changed |= scheduleNode( f, node);
+        }
+        return changed;
+    }
+
+    /** Propagate the constants, the pass builds no analyses */
+    bool SCCPPass::run( Function *f, AnalysisCache &)
+    {
+        return propagateConstants( f);
+    }
+
+    /** Delete the dead code, the pass builds no analyses */
+    bool DCEPass::run( Function *f, AnalysisCache &)
+    {
+        return eliminateDeadCode( f);
+    }
+
+    /** Number the values over the cached dominator tree */
+    bool GVNPass::run( Function *f, AnalysisCache &analyses)
+    {
+        return numberValues( f, analyses.domTree());
+    }
+
+    PassManager::PassManager()
+    {
+        for ( UInt32 i = 0; i < ANALYSES_NUM; i++)
+        {
+            analysis_timings[ i].name = analysisName( (AnalysisKind)i);
+        }
+    }
+
+    /** Delete the passes */
+    PassManager::~PassManager()
+    {
+        for ( UInt32 i = 0; i < passes.size(); i++)
+        {
+            delete passes[ i];
+        }
+    }
+
+    /** Add pass to the end of the sequence, the manager owns it */
+    void PassManager::addPass( Pass *pass)
+    {
+        passes.push_back( pass);
+        pass_timings.push_back( PassTiming( pass->name()));
+    }
+
+    /** Run the passes over the function */
+    void PassManager::run( Function *f)
+    {
+        AnalysisCache analyses( f);
+
+        for ( UInt32 i = 0; i < passes.size(); i++)
+        {
+            UInt64 start_ns = timeNs();
+            UInt64 start_mem = f->memBytes();
+            UInt64 analyses_ns = 0;
+            Int64 analyses_mem = 0;
+
+            for ( UInt32 k = 0; k < ANALYSES_NUM; k++)
+            {
+                analyses_ns += analyses.timing( (AnalysisKind)k).time_ns;
+                analyses_mem += analyses.timing( (AnalysisKind)k).mem_delta;
+            }
+            if ( passes[ i]->run( f, analyses) )
+            {
+                analyses.invalidate( passes[ i]->preserved());
+            }
+
+            /* Analyses computed on the pass' request are accounted separately */
+            for ( UInt32 k = 0; k < ANALYSES_NUM; k++)
+            {
+                analyses_ns -= analyses.timing( (AnalysisKind)k).time_ns;
+                analyses_mem -= analyses.timing( (AnalysisKind)k).mem_delta;
+            }
+            pass_timings[ i].runs++;
+            pass_timings[ i].time_ns += timeNs() - start_ns + analyses_ns;
+            pass_timings[ i].mem_delta += (Int64)f->memBytes() - (Int64)start_mem + analyses_mem;
+        }
+        for ( UInt32 k = 0; k < ANALYSES_NUM; k++)
+        {
+            analysis_timings[ k].runs += analyses.timing( (AnalysisKind)k).runs;
+            analysis_timings[ k].time_ns += analyses.timing( (AnalysisKind)k).time_ns;
+            analysis_timings[ k].mem_delta += analyses.timing( (AnalysisKind)k).mem_delta;
+        }
+    }
+
+    /** Run the passes over every function of the module in the module's order */
+    void PassManager::run( Module *m)
+    {
+        for ( Function *f = m->firstFunction(); isNotNullP( f); f = f->next())
+        {
+            run( f);
+        }
+    }
+
+    /** Print one line of the report */
+    static void timingToStream( ostream &os, const PassTiming &t, UInt64 total_ns)
+    {
+        double percent = total_ns > 0 ? 100.0 * (double)t.time_ns / (double)total_ns : 0.0;
+
+        os << "  " << std::left << std::setw( 24) << t.name << std::right
+           << std::setw( 8) << t.runs
+           << std::setw( 12) << std::fixed << std::setprecision( 3) << (double)t.time_ns / 1e6
+           << std::setw( 7) << std::setprecision( 1) << percent << "%"
+           << std::setw( 12) << std::showpos << (double)t.mem_delta / 1024.0 << std::noshowpos << endl;
+    }
+
+    /** Print time and memory report of the passes and analyses */
+    void PassManager::reportToStream( ostream &os) const
+    {
+        PassTiming total( "total");
+
+        for ( UInt32 i = 0; i < pass_timings.size(); i++)
+        {
+            total.time_ns += pass_timings[ i].time_ns;
+            total.mem_delta += pass_timings[ i].mem_delta;
+        }
+        for ( UInt32 k = 0; k < ANALYSES_NUM; k++)
+        {
+            total.time_ns += analysis_timings[ k].time_ns;
+            total.mem_delta += analysis_timings[ k].mem_delta;
+        }
+        total.runs = pass_timings.empty() ? 0 : pass_timings[ 0].runs;
+
+        std::ios_base::fmtflags flags = os.flags();
+        std::streamsize precision = os.precision();
+
+        os << "Pass execution report:" << endl;
+        os << "  " << std::left << std::setw( 24) << "pass" << std::right
+           << std::setw( 8) << "runs" << std::setw( 12) << "wall ms" << std::setw( 8) << "%"
+           << std::setw( 12) << "memory KB" << endl;
+        for ( UInt32 i = 0; i < pass_timings.size(); i++)
+        {
+            timingToStream( os, pass_timings[ i], total.time_ns);
+        }
+        for ( UInt32 k = 0; k < ANALYSES_NUM; k++)
+        {
+            PassTiming t = analysis_timings[ k];
+
+            t.name = string( "analysis ") + t.name;
+            timingToStream( os, t, total.time_ns);
+        }
+        timingToStream( os, total, total.time_ns);
+        os.flags( flags);
+        os.precision( precision);
+    }
+}
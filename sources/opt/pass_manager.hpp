@@ -0,0 +1,291 @@
+/**
+ * @file: opt/pass_manager.hpp
+ * Pass manager with cached analyses of the function
+ * @ingroup OPT
+ */
+ /*
+  * Copyright 2012 MIPT-COMPILER team
+  */
+#pragma once
+
+namespace Opt
+{
+    /** Analyses of the function that are kept between the passes */
+    enum AnalysisKind
+    {
+        ANALYSIS_CFG_ORDER, /**< Reachable CF nodes in reverse postorder */
+        ANALYSIS_DOM,       /**< Dominator tree of the CFG */
+        ANALYSIS_LIVENESS,  /**< Live objects of the CF nodes */
+        ANALYSIS_DEPS,      /**< Dependence edges among the operations of every CF node */
+        ANALYSES_NUM
+    };
+
+    /** Set of analyses, the bit with the number of the kind stands for the analysis */
+    typedef UInt32 AnalysisSet;
+
+    /** No analysis is preserved */
+    const AnalysisSet ANALYSES_NONE = 0;
+
+    /** Every analysis is preserved */
+    const AnalysisSet ANALYSES_ALL = ( 1 << ANALYSES_NUM) - 1;
+
+    /** Get the set of one analysis */
+    inline AnalysisSet analysisBit( AnalysisKind kind)
+    {
+        return 1 << kind;
+    }
+
+    /** Get name of the analysis */
+    const char *analysisName( AnalysisKind kind);
+
+    /**
+     * @struct PassTiming
+     * @brief Wall time and change of the function's memory spent by a pass or an analysis
+     * @ingroup OPT
+     */
+    struct PassTiming
+    {
+        PassTiming( const string &n = string()): name( n), runs( 0), time_ns( 0), mem_delta( 0){}
+
+        string name;
+        UInt32 runs;      /**< Number of the runs over functions */
+        UInt64 time_ns;   /**< Total wall time in nanoseconds */
+        Int64 mem_delta;  /**< Total change of the functions' memory in bytes */
+    };
+
+    /**
+     * @class AnalysisCache
+     * @brief Analyses of one function computed on the first request and kept until a pass invalidates them
+     *
+     * The dominator tree and the liveness hold numerations of the CFG while they are valid.
+     * The dependence edges live in the function itself, they are deleted when the analysis is invalidated
+     * so that stale edges are never seen by the passes
+     * @ingroup OPT
+     */
+    class AnalysisCache
+    {
+    public:
+        AnalysisCache( Function *f);
+        ~AnalysisCache();
+
+        /** Get the function of the analyses */
+        inline Function *function() const;
+
+        /** Get the nodes reachable from the start node in reverse postorder */
+        const vector< CFNode *> &cfgOrder();
+
+        /** Get the dominator tree of the CFG */
+        const DomTree &domTree();
+
+        /** Get the liveness of the function's objects */
+        const Liveness &liveness();
+
+        /** Make sure the dependence edges of the function are built */
+        void requireDeps();
+
+        /** Check that the analysis is computed and not invalidated since then */
+        inline bool isValid( AnalysisKind kind) const;
+
+        /** Drop all the analyses except the preserved ones */
+        void invalidate( AnalysisSet preserved);
+
+        /** Get time and memory spent on computing the analysis, runs are the number of computations */
+        inline const PassTiming &timing( AnalysisKind kind) const;
+    private:
+        AnalysisCache( const AnalysisCache &);
+        AnalysisCache &operator = ( const AnalysisCache &);
+
+        /** Account the computation of the analysis started at the given time and memory */
+        void computed( AnalysisKind kind, UInt64 start_ns, UInt64 start_mem);
+
+        Function *func;
+        AnalysisSet valid;
+        vector< CFNode *> order;
+        DomTree *dom;
+        Liveness *live;
+        PassTiming timings[ ANALYSES_NUM];
+    };
+
+    /**
+     * @class Pass
+     * @brief Transformation of one function that takes the analyses it needs from the cache
+     *
+     * The pass declares the analyses it keeps valid whenever it changes the function,
+     * the rest of them are dropped after its run
+     * @ingroup OPT
+     */
+    class Pass
+    {
+    public:
+        Pass( const char *pass_name, AnalysisSet preserved_analyses):
+            name_( pass_name), preserved_( preserved_analyses){}
+        virtual ~Pass(){}
+
+        /** Get name of the pass */
+        inline const char *name() const;
+
+        /** Get the analyses that stay valid after the pass changed the function */
+        inline AnalysisSet preserved() const;
+
+        /** Transform the function, returns false if the function is not changed and all the analyses stay valid */
+        virtual bool run( Function *f, AnalysisCache &analyses) = 0;
+    private:
+        const char *name_;
+        AnalysisSet preserved_;
+    };
+
+    /**
+     * @class SimplePass
+     * @brief Pass made of a plain function pass that computes everything it needs by itself
+     * @ingroup OPT
+     */
+    class SimplePass: public Pass
+    {
+    public:
+        SimplePass( const char *pass_name, FunctionPass p, AnalysisSet preserved_analyses = ANALYSES_NONE):
+            Pass( pass_name, preserved_analyses), pass( p){}
+
+        bool run( Function *f, AnalysisCache &analyses);
+    private:
+        FunctionPass pass;
+    };
+
+    /** SSA construction over the cached dominator tree, keeps the CFG analyses */
+    class SSAPass: public Pass
+    {
+    public:
+        SSAPass(): Pass( "ssa", analysisBit( ANALYSIS_CFG_ORDER) | analysisBit( ANALYSIS_DOM)){}
+
+        bool run( Function *f, AnalysisCache &analyses);
+    };
+
+    /** Translation out of SSA, it may split edges so no analysis is kept */
+    class OutOfSSAPass: public Pass
+    {
+    public:
+        OutOfSSAPass(): Pass( "out-of-ssa", ANALYSES_NONE){}
+
+        bool run( Function *f, AnalysisCache &analyses);
+    };
+
+    /** List scheduling over the cached dependence edges, the order respects them so they stay valid */
+    class SchedPass: public Pass
+    {
+    public:
+        SchedPass(): Pass( "sched", ANALYSES_ALL){}
+
+        bool run( Function *f, AnalysisCache &analyses);
+    };
+
+    /** Sparse conditional constant propagation, it may delete operations and nodes so no analysis is kept */
+    class SCCPPass: public Pass
+    {
+    public:
+        SCCPPass(): Pass( "sccp", ANALYSES_NONE){}
+
+        bool run( Function *f, AnalysisCache &analyses);
+    };
+
+    /** Dead code elimination, it may delete nodes so no analysis is kept */
+    class DCEPass: public Pass
+    {
+    public:
+        DCEPass(): Pass( "dce", ANALYSES_NONE){}
+
+        bool run( Function *f, AnalysisCache &analyses);
+    };
+
+    /** Value numbering over the cached dominator tree, it changes no CF node so the CFG analyses are kept */
+    class GVNPass: public Pass
+    {
+    public:
+        GVNPass(): Pass( "gvn", analysisBit( ANALYSIS_CFG_ORDER) | analysisBit( ANALYSIS_DOM)){}
+
+        bool run( Function *f, AnalysisCache &analyses);
+    };
+
+    /**
+     * @class PassManager
+     * @brief Runs the sequence of passes over functions sharing the analyses among the passes
+     *
+     * Time and memory of the passes and of the analyses are summed over all the functions
+     * the manager has run over, the time of an analysis computed on request of a pass
+     * is not counted in the pass' time
+     * @ingroup OPT
+     */
+    class PassManager
+    {
+    public:
+        PassManager();
+        /** Delete the passes */
+        ~PassManager();
+
+        /** Add pass to the end of the sequence, the manager owns it */
+        void addPass( Pass *pass);
+
+        /** Run the passes over the function */
+        void run( Function *f);
+
+        /** Run the passes over every function of the module in the module's order */
+        void run( Module *m);
+
+        /** Get time and memory spent by the pass with the given number */
+        inline const PassTiming &passTiming( UInt32 num) const;
+
+        /** Get time and memory spent on computing the analysis */
+        inline const PassTiming &analysisTiming( AnalysisKind kind) const;
+
+        /** Print time and memory report of the passes and analyses */
+        void reportToStream( ostream &os) const;
+    private:
+        PassManager( const PassManager &);
+        PassManager &operator = ( const PassManager &);
+
+        vector< Pass *> passes;
+        vector< PassTiming> pass_timings;
+        PassTiming analysis_timings[ ANALYSES_NUM];
+    };
+
+    /** Get the function of the analyses */
+    Function *AnalysisCache::function() const
+    {
+        return func;
+    }
+
+    /** Check that the analysis is computed and not invalidated since then */
+    bool AnalysisCache::isValid( AnalysisKind kind) const
+    {
+        return ( valid & analysisBit( kind)) != 0;
+    }
+
+    /** Get time and memory spent on computing the analysis */
+    const PassTiming &AnalysisCache::timing( AnalysisKind kind) const
+    {
+        return timings[ kind];
+    }
+
+    /** Get name of the pass */
+    const char *Pass::name() const
+    {
+        return name_;
+    }
+
+    /** Get the analyses that stay valid after the pass changed the function */
+    AnalysisSet Pass::preserved() const
+    {
+        return preserved_;
+    }
+
+    /** Get time and memory spent by the pass with the given number */
+    const PassTiming &PassManager::passTiming( UInt32 num) const
+    {
+        IR_ASSERTD( num < pass_timings.size());
+        return pass_timings[ num];
+    }
+
+    /** Get time and memory spent on computing the analysis */
+    const PassTiming &PassManager::analysisTiming( AnalysisKind kind) const
+    {
+        return analysis_timings[ kind];
+    }
+}
@@ -0,0 +1,589 @@
+/**
+ * @file: opt/sccp.cpp
+ * Implementation of sparse conditional constant propagation
+ * @ingroup OPT
+ */
+ /*
+  * Copyright 2012 MIPT-COMPILER team
+  */
+#include "opt_iface.hpp"
+
+namespace Opt
+{
+    typedef IR::Operation< MDes> Operation;
+    typedef IR::Operand< MDes> Operand;
+
+    /** Kinds of the values in the lattice of constant propagation */
+    enum LatticeKind
+    {
+        LATTICE_TOP,    /**< No executable definition is seen yet */
+        LATTICE_CONST,  /**< The only integer value */
+        LATTICE_BOTTOM  /**< Value is not known at compile time */
+    };
+
+    /** Value of an object or operand in the lattice of constant propagation */
+    struct LatticeVal
+    {
+        LatticeVal( LatticeKind k = LATTICE_TOP, Int64 v = 0): kind( k), val( v){}
+
+        bool operator == ( const LatticeVal &v) const
+        {
+            return kind == v.kind && ( kind != LATTICE_CONST || val == v.val);
+        }
+        bool operator != ( const LatticeVal &v) const
+        {
+            return !( *this == v);
+        }
+
+        LatticeKind kind;
+        Int64 val;
+    };
+
+    /** Get the greatest lower bound of the two values */
+    static LatticeVal meet( const LatticeVal &a, const LatticeVal &b)
+    {
+        if ( a.kind == LATTICE_TOP )
+            return b;
+        if ( b.kind == LATTICE_TOP || a == b )
+            return a;
+        return LatticeVal( LATTICE_BOTTOM);
+    }
+
+    /** Check that the operation is a branch on comparison of its arguments */
+    static bool isCondBranch( Operation *oper)
+    {
+        switch ( oper->name())
+        {
+            case Brl:
+            case Brg:
+            case Brle:
+            case Brge:
+            case Bre:
+            case Brne:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    /** Check that the conditional branch is taken for the given arguments */
+    static bool isTaken( OptOperName name, Int64 a, Int64 b)
+    {
+        switch ( name)
+        {
+            case Brl:
+                return a < b;
+            case Brg:
+                return a > b;
+            case Brle:
+                return a <= b;
+            case Brge:
+                return a >= b;
+            case Bre:
+                return a == b;
+            case Brne:
+                return a != b;
+            default:
+                IR_ASSERTXD( 0, "Not a conditional branch");
+                return false;
+        }
+    }
+
+    /** Check that the operation computes its only result from the arguments with no side effects */
+    static bool isFoldable( Operation *oper)
+    {
+        switch ( oper->name())
+        {
+            case Mov:
+            case Add:
+            case Sub:
+            case Mul:
+            case Div:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    /**
+     * @class ConstPropagator
+     * @brief State of the constant propagation over one function
+     *
+     * Executable nodes and edges are marked with one marker of the CFG. Two worklists drive the
+     * propagation: the edges that become executable and the objects whose value gets lower.
+     * A value can get lower at most twice, so every use is evaluated a bounded number of times
+     */
+    class ConstPropagator
+    {
+    public:
+        ConstPropagator( Function *f);
+        ~ConstPropagator();
+
+        /** Find the values of the objects and the executable nodes */
+        void solve();
+
+        /** Change the function according to the found values, returns true if it is changed */
+        bool rewrite();
+    private:
+        /** Get the value of the argument operand */
+        LatticeVal argValue( const Operand &op) const;
+
+        /** Get the value the foldable operation computes */
+        LatticeVal evaluate( Operation *oper) const;
+
+        /** Get the meet of the phi's arguments that come along the executable edges */
+        LatticeVal evaluatePhi( Operation *phi) const;
+
+        /** Lower the value of the object, queue its uses if the value changes */
+        void lower( Obj *obj, const LatticeVal &v);
+
+        /** Mark the edge executable and queue it */
+        void addEdge( CFEdge *edge);
+
+        /** Evaluate the operation of the executable node */
+        void visitOper( Operation *oper);
+
+        /** Evaluate all operations of the node that has just become executable */
+        void visitNode( CFNode *node);
+
+        /** Turn the conditional branch with constant arguments into a jump or delete it */
+        bool foldBranch( Operation *branch);
+
+        /** Delete the constant moves and phis left without uses, the objects must be queued */
+        void deleteDeadDefs( vector< Obj *> &dead);
+
+        Function *func;
+        Marker exec;
+        vector< LatticeVal> vals;  /**< Values of the Reg objects by id */
+        vector< bool> had_uses;    /**< Objects that had uses before the rewriting */
+        vector< CFEdge *> edges;
+        vector< Obj *> objs;
+    };
+
+    ConstPropagator::ConstPropagator( Function *f):
+        func( f), exec( f->cfg().newMarker()), vals( f->numObjects( Reg)), had_uses( f->numObjects( Reg), false)
+    {
+        /* Objects that are never defined come from outside of the function */
+        for ( UInt32 i = 0; i < vals.size(); i++)
+        {
+            Obj *obj = f->object( Reg, i);
+
+            if ( obj->numDefs() == 0 )
+            {
+                vals[ i] = LatticeVal( LATTICE_BOTTOM);
+            }
+            had_uses[ i] = obj->numUses() > 0;
+        }
+        for ( UInt16 i = 0; i < f->numArgs(); i++)
+        {
+            if ( f->arg( i)->type() == Reg )
+            {
+                vals[ f->arg( i)->id()] = LatticeVal( LATTICE_BOTTOM);
+            }
+        }
+    }
+
+    /** Release the marker of the CFG */
+    ConstPropagator::~ConstPropagator()
+    {
+        func->cfg().freeMarker( exec);
+    }
+
+    /** Get the value of the argument operand */
+    LatticeVal ConstPropagator::argValue( const Operand &op) const
+    {
+        if ( op.type() == OP_TYPE_OBJ )
+        {
+            return op.object()->type() == Reg ? vals[ op.object()->id()] : LatticeVal( LATTICE_BOTTOM);
+        }
+        if ( op.type() == OP_TYPE_IMM && op.constValue().type() == CONST_TYPE_INTEGER )
+        {
+            return LatticeVal( LATTICE_CONST, op.constValue().intVal());
+        }
+        return LatticeVal( LATTICE_BOTTOM);
+    }
+
+    /** Get the value the foldable operation computes */
+    LatticeVal ConstPropagator::evaluate( Operation *oper) const
+    {
+        LatticeVal a = argValue( oper->arg( 0));
+
+        if ( oper->name() == Mov )
+            return a;
+
+        LatticeVal b = argValue( oper->arg( 1));
+
+        if ( a.kind == LATTICE_BOTTOM || b.kind == LATTICE_BOTTOM )
+            return LatticeVal( LATTICE_BOTTOM);
+        if ( a.kind == LATTICE_TOP || b.kind == LATTICE_TOP )
+            return LatticeVal( LATTICE_TOP);
+
+        /* Integer overflow wraps around as it does on the target */
+        UInt64 x = (UInt64)a.val;
+        UInt64 y = (UInt64)b.val;
+
+        switch ( oper->name())
+        {
+            case Add:
+                return LatticeVal( LATTICE_CONST, (Int64)( x + y));
+            case Sub:
+                return LatticeVal( LATTICE_CONST, (Int64)( x - y));
+            case Mul:
+                return LatticeVal( LATTICE_CONST, (Int64)( x * y));
+            case Div:
+                if ( b.val == 0 )
+                    return LatticeVal( LATTICE_BOTTOM); /* The trap is kept for the run time */
+                if ( b.val == -1 )
+                    return LatticeVal( LATTICE_CONST, (Int64)( 0 - x));
+                return LatticeVal( LATTICE_CONST, a.val / b.val);
+            default:
+                IR_ASSERTXD( 0, "Operation is not foldable");
+                return LatticeVal( LATTICE_BOTTOM);
+        }
+    }
+
+    /** Get the meet of the phi's arguments that come along the executable edges */
+    LatticeVal ConstPropagator::evaluatePhi( Operation *phi) const
+    {
+        LatticeVal v;
+        CFEdge *e = phi->node()->firstPred();
+
+        /* The i-th argument comes along the i-th predecessor edge */
+        for ( UInt32 i = 0; i < phi->numArgsInSet() && isNotNullP( e); i++, e = e->nextPred())
+        {
+            if ( e->isMarked( exec) )
+            {
+                v = meet( v, argValue( phi->argInSet( i)));
+            }
+        }
+        return v;
+    }
+
+    /** Lower the value of the object, queue its uses if the value changes */
+    void ConstPropagator::lower( Obj *obj, const LatticeVal &v)
+    {
+        if ( obj->type() != Reg )
+            return;
+
+        LatticeVal &cur = vals[ obj->id()];
+        LatticeVal res = meet( cur, v);
+
+        if ( res != cur )
+        {
+            cur = res;
+            objs.push_back( obj);
+        }
+    }
+
+    /** Mark the edge executable and queue it */
+    void ConstPropagator::addEdge( CFEdge *edge)
+    {
+        if ( edge->mark( exec) )
+        {
+            edges.push_back( edge);
+        }
+    }
+
+    /** Evaluate the operation of the executable node */
+    void ConstPropagator::visitOper( Operation *oper)
+    {
+        if ( isPhi( oper) )
+        {
+            lower( oper->res( 0).object(), evaluatePhi( oper));
+        } else if ( isCondBranch( oper) )
+        {
+            LatticeVal a = argValue( oper->arg( 0));
+            LatticeVal b = argValue( oper->arg( 1));
+
+            if ( a.kind == LATTICE_TOP || b.kind == LATTICE_TOP )
+                return;
+
+            bool is_const = ( a.kind == LATTICE_CONST && b.kind == LATTICE_CONST);
+            bool taken = is_const && isTaken( (OptOperName)oper->name(), a.val, b.val);
+
+            /* The taken edge has the branch as the source, the other one falls through */
+            for ( CFEdge *e = oper->node()->firstSucc(); isNotNullP( e); e = e->nextSucc())
+            {
+                if ( !is_const || areEqP( e->srcOper(), oper) == taken )
+                {
+                    addEdge( e);
+                }
+            }
+        } else if ( isFoldable( oper) )
+        {
+            lower( oper->res( 0).object(), evaluate( oper));
+        } else
+        {
+            for ( UInt32 i = 0; i < oper->numRess(); i++)
+            {
+                if ( oper->res( i).type() == OP_TYPE_OBJ )
+                {
+                    lower( oper->res( i).object(), LatticeVal( LATTICE_BOTTOM));
+                }
+            }
+            for ( UInt32 i = 0; i < oper->numRessInSet(); i++)
+            {
+                lower( oper->resInSet( i).object(), LatticeVal( LATTICE_BOTTOM));
+            }
+        }
+    }
+
+    /** Evaluate all operations of the node that has just become executable */
+    void ConstPropagator::visitNode( CFNode *node)
+    {
+        for ( Operation *oper = node->firstOper(); isNotNullP( oper); oper = oper->nextInNode())
+        {
+            visitOper( oper);
+        }
+        if ( isNullP( node->lastOper()) || !isCondBranch( node->lastOper()) )
+        {
+            for ( CFEdge *e = node->firstSucc(); isNotNullP( e); e = e->nextSucc())
+            {
+                addEdge( e);
+            }
+        }
+    }
+
+    /** Find the values of the objects and the executable nodes */
+    void ConstPropagator::solve()
+    {
+        CFNode *start = func->cfg().startNode();
+
+        start->mark( exec);
+        visitNode( start);
+        while ( !edges.empty() || !objs.empty() )
+        {
+            while ( !edges.empty() )
+            {
+                CFNode *node = edges.back()->succ();
+
+                edges.pop_back();
+                if ( node->mark( exec) )
+                {
+                    visitNode( node);
+                } else
+                {
+                    /* One more executable predecessor changes only the phis */
+                    for ( Operation *phi = node->firstOper(); isPhi( phi); phi = phi->nextInNode())
+                    {
+                        visitOper( phi);
+                    }
+                }
+            }
+            while ( !objs.empty() )
+            {
+                Obj *obj = objs.back();
+
+                objs.pop_back();
+                for ( UInt32 i = 0; i < obj->uses().size(); i++)
+                {
+                    Operation *oper = obj->uses()[ i].oper;
+
+                    if ( isNotNullP( oper->node()) && oper->node()->isMarked( exec) )
+                    {
+                        visitOper( oper);
+                    }
+                }
+            }
+        }
+    }
+
+    /** Turn the conditional branch with constant arguments into a jump or delete it */
+    bool ConstPropagator::foldBranch( Operation *branch)
+    {
+        LatticeVal a = argValue( branch->arg( 0));
+        LatticeVal b = argValue( branch->arg( 1));
+
+        if ( a.kind != LATTICE_CONST || b.kind != LATTICE_CONST )
+            return false;
+
+        CFNode *node = branch->node();
+        CFEdge *jump_edge = NULL;
+        CFEdge *fall_edge = NULL;
+
+        for ( CFEdge *e = node->firstSucc(); isNotNullP( e); e = e->nextSucc())
+        {
+            if ( areEqP( e->srcOper(), branch) )
+            {
+                jump_edge = e;
+            } else
+            {
+                fall_edge = e;
+            }
+        }
+        if ( isNullP( jump_edge) || isNullP( fall_edge) )
+            return false;
+
+        if ( isTaken( (OptOperName)branch->name(), a.val, b.val) )
+        {
+            Operation *target = branch->arg( 2).target();
+
+            branch->setName( Br);
+            branch->setArgTarget( 0, target);
+            removeEdge( func, fall_edge);
+            return true;
+        }
+        if ( !isJumpTarget( branch) )
+        {
+            removeEdge( func, jump_edge);
+            removeOper( func, branch);
+            return true;
+        }
+        /* The branch is the only operation of a jump target, it becomes the jump to the fall through node */
+        if ( isNullP( fall_edge->succ()->firstOper()) )
+            return false;
+
+        removeEdge( func, jump_edge);
+        branch->setName( Br);
+        branch->setArgTarget( 0, fall_edge->succ()->firstOper());
+        fall_edge->setSrcOper( branch);
+        return true;
+    }
+
+    /** Delete the constant moves and phis left without uses, the objects must be queued */
+    void ConstPropagator::deleteDeadDefs( vector< Obj *> &dead)
+    {
+        vector< Operation *> defs;
+
+        while ( !dead.empty() )
+        {
+            Obj *obj = dead.back();
+
+            dead.pop_back();
+            defs.clear();
+            for ( UInt32 i = 0; i < obj->defs().size(); i++)
+            {
+                defs.push_back( obj->defs()[ i].oper);
+            }
+            for ( UInt32 i = 0; i < defs.size(); i++)
+            {
+                Operation *oper = defs[ i];
+
+                if ( isNullP( oper->node()) || !oper->node()->isMarked( exec)
+                     || !( isPhi( oper) || oper->name() == Mov) )
+                    continue;
+                if ( isNullP( oper->nextInNode()) && isJumpTarget( oper) )
+                    continue;
+
+                /* Deleting a phi may leave its arguments without uses */
+                vector< Obj *> args;
+
+                for ( UInt32 j = 0; j < oper->numArgsInSet(); j++)
+                {
+                    if ( oper->argInSet( j).type() == OP_TYPE_OBJ )
+                    {
+                        args.push_back( oper->argInSet( j).object());
+                    }
+                }
+                removeOper( func, oper);
+                for ( UInt32 j = 0; j < args.size(); j++)
+                {
+                    Obj *arg = args[ j];
+
+                    if ( arg->type() == Reg && arg->numUses() == 0 && had_uses[ arg->id()]
+                         && vals[ arg->id()].kind == LATTICE_CONST )
+                    {
+                        dead.push_back( arg);
+                    }
+                }
+            }
+        }
+    }
+
+    /** Change the function according to the found values, returns true if it is changed */
+    bool ConstPropagator::rewrite()
+    {
+        vector< Operation *> opers;
+        vector< Obj *> dead;
+        bool changed = false;
+
+        for ( CFNode *node = func->cfg().firstNode(); isNotNullP( node); node = node->nextNode())
+        {
+            if ( !node->isMarked( exec) )
+                continue;
+
+            for ( Operation *oper = node->firstOper(); isNotNullP( oper); oper = oper->nextInNode())
+            {
+                opers.push_back( oper);
+            }
+        }
+
+        /* Uses of the constants become immediates, phi arguments stay objects */
+        for ( UInt32 k = 0; k < opers.size(); k++)
+        {
+            Operation *oper = opers[ k];
+
+            if ( isPhi( oper) )
+                continue;
+
+            for ( UInt32 i = 0; i < oper->numArgs(); i++)
+            {
+                LatticeVal v = argValue( oper->arg( i));
+
+                if ( oper->arg( i).type() == OP_TYPE_OBJ && v.kind == LATTICE_CONST
+                     && oper->archDes()->argDes( i)->canBeImm() )
+                {
+                    oper->setArgImm( i, v.val);
+                    changed = true;
+                }
+            }
+        }
+
+        /* Computations of the constants become moves of immediates */
+        for ( UInt32 k = 0; k < opers.size(); k++)
+        {
+            Operation *oper = opers[ k];
+
+            if ( !isFoldable( oper) )
+                continue;
+
+            Obj *res = oper->res( 0).object();
+            LatticeVal v = vals[ res->id()];
+
+            if ( v.kind == LATTICE_CONST && !( oper->name() == Mov && oper->arg( 0).type() == OP_TYPE_IMM) )
+            {
+                oper->setName( Mov);
+                oper->setArgImm( 0, v.val);
+                oper->setResObj( 0, res);
+                changed = true;
+            }
+        }
+
+        /* Branches are the last operations of the nodes, folded ones drop their edges */
+        for ( CFNode *node = func->cfg().firstNode(); isNotNullP( node); node = node->nextNode())
+        {
+            if ( node->isMarked( exec) && isNotNullP( node->lastOper()) && isCondBranch( node->lastOper()) )
+            {
+                changed |= foldBranch( node->lastOper());
+            }
+        }
+        if ( removeUnreachableNodes( func) > 0 )
+        {
+            changed = true;
+        }
+
+        /* Definitions of the constants that are not used anymore */
+        for ( UInt32 i = 0; i < vals.size(); i++)
+        {
+            Obj *obj = func->object( Reg, i);
+
+            if ( vals[ i].kind == LATTICE_CONST && had_uses[ i] && obj->numUses() == 0 )
+            {
+                dead.push_back( obj);
+            }
+        }
+        deleteDeadDefs( dead);
+        return changed;
+    }
+
+    /** Propagate integer constants over the function and fold the branches they decide */
+    bool propagateConstants( Function *f)
+    {
+        IR_ASSERTXD( f->cfg().isValid(), "Constant propagation requires valid CFG");
+
+        ConstPropagator propagator( f);
+
+        propagator.solve();
+        return propagator.rewrite();
+    }
+}
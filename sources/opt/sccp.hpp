@@ -0,0 +1,27 @@
+/**
+ * @file: opt/sccp.hpp
+ * Sparse conditional constant propagation
+ * @ingroup OPT
+ */
+ /*
+  * Copyright 2012 MIPT-COMPILER team
+  */
+#pragma once
+
+namespace Opt
+{
+    /**
+     * Propagate integer constants over the function and fold the branches they decide.
+     *
+     * Values of Reg objects are found by sparse conditional constant propagation: operations
+     * are evaluated only in the nodes reachable along the edges that may execute, and the values
+     * flow from definitions to uses over the def-use lists. An object that is defined more than once
+     * gets the meet of all its executable definitions, so the function need not be in SSA form.
+     * Then the uses of constant objects become immediates where the operands allow them,
+     * Mov, Add, Sub, Mul and Div computing constants become moves of immediates, and the moves
+     * and phis left without uses are deleted. Conditional branches with constant operands turn into
+     * jumps or disappear, and the nodes that can not execute are deleted. The CFG must be valid.
+     * Returns true if the function is changed
+     */
+    bool propagateConstants( Function *f);
+}
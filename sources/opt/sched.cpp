@@ -0,0 +1,236 @@
+/**
+ * @file: opt/sched.cpp
+ * Implementation of list scheduling
+ * @ingroup OPT
+ */
+ /*
+  * Copyright 2012 MIPT-COMPILER team
+  */
+#include "opt_iface.hpp"
+
+namespace Opt
+{
+    typedef IR::Operation< MDes> Operation;
+    typedef IR::DepEdge< MDes> DepEdge;
+
+    /**
+     * Order of the ready operations: longer path to the end of the node goes first,
+     * the original order breaks ties so the schedule is deterministic
+     */
+    class SchedPriority
+    {
+    public:
+        SchedPriority( const vector< UInt32> &h): heights( h){}
+
+        bool operator () ( UInt32 a, UInt32 b) const
+        {
+            if ( heights[ a] != heights[ b])
+                return heights[ a] > heights[ b];
+            return a < b;
+        }
+    private:
+        const vector< UInt32> &heights;
+    };
+
+    /**
+     * Put the scheduled operations back into the node in the given order. They go before
+     * the node's control flow operation if there is one and after the node's phis otherwise.
+     * The given neighbours are the operations that surrounded the region in the sequence
+     */
+    static void relink( Function *f, CFNode *node, const vector< Oper *> &order, Oper *cf_oper,
+                        Operation *before, Operation *after)
+    {
+        for ( UInt32 i = 0; i < order.size(); i++)
+        {
+            node->remove( order[ i]);
+        }
+        for ( UInt32 i = 0; i < order.size(); i++)
+        {
+            if ( isNotNullP( cf_oper) )
+            {
+                node->insertBefore( order[ i], cf_oper);
+            } else if ( isNotNullP( node->lastOper()) )
+            {
+                node->append( order[ i]);
+            } else
+            {
+                /* The node is empty, link the operation with the neighbouring nodes */
+                if ( isNotNullP( before) )
+                {
+                    order[ i]->insertAfter( before);
+                } else if ( isNotNullP( after) )
+                {
+                    order[ i]->insertBefore( after);
+                }
+                node->extend( order[ i]);
+            }
+        }
+        if ( isNullP( before) )
+        {
+            f->setFirstOper( order[ 0]);
+        }
+    }
+
+    /** Reorder the operations of the node by critical path list scheduling */
+    bool scheduleNode( Function *f, CFNode *node)
+    {
+        vector< Oper *> opers;
+        Operation *first = node->firstOper();
+        Operation *last = node->lastOper();
+
+        if ( isNullP( first) )
+            return false;
+
+        /* Leading phis and the trailing control flow operation or return are not scheduled */
+        while ( isPhi( first) && !areEqP( first, last) )
+        {
+            first = first->nextInNode();
+        }
+        if ( isPhi( first) )
+            return false;
+
+        Oper *cf_oper = static_cast< Oper *>( last);
+
+        if ( !cf_oper->isCf() && cf_oper->name() != Ret )
+        {
+            cf_oper = NULL;
+        }
+        for ( Operation *oper = first; isNotNullP( oper); oper = oper->nextInNode())
+        {
+            if ( !areEqP( oper, cf_oper) )
+            {
+                opers.push_back( static_cast< Oper *>( oper));
+            }
+        }
+        UInt32 n = (UInt32)opers.size();
+
+        if ( n < 2)
+            return false;
+
+        Numeration index = f->newNum();
+
+        for ( UInt32 i = 0; i < n; i++)
+        {
+            opers[ i]->setNumber( index, i);
+        }
+
+        /* Heights: the longest latency path from the operation to the end of the region */
+        vector< UInt32> heights( n, 0);
+        vector< UInt32> preds_left( n, 0);
+
+        for ( UInt32 i = n; i-- > 0;)
+        {
+            UInt32 h = opers[ i]->archDes()->latency;
+
+            for ( DepEdge *e = opers[ i]->firstSucc(); isNotNullP( e); e = e->nextSucc())
+            {
+                if ( e->succ()->isNumbered( index) )
+                {
+                    h = max< UInt32>( h, e->latency() + heights[ e->succ()->number( index)]);
+                }
+            }
+            heights[ i] = h;
+            for ( DepEdge *e = opers[ i]->firstPred(); isNotNullP( e); e = e->nextPred())
+            {
+                if ( e->pred()->isNumbered( index) )
+                {
+                    preds_left[ i]++;
+                }
+            }
+        }
+
+        /* Cycle by cycle issue of the ready operations */
+        vector< vector< UInt32> > unit_free( MDes::num_units);
+        vector< UInt32> earliest( n, 0);
+        vector< UInt32> ready;
+        vector< Oper *> order;
+        SchedPriority priority( heights);
+
+        for ( UInt32 u = 0; u < MDes::num_units; u++)
+        {
+            unit_free[ u].resize( MDes::unitDescription( (OptUnitName)u)->num, 0);
+        }
+        for ( UInt32 i = 0; i < n; i++)
+        {
+            if ( preds_left[ i] == 0)
+            {
+                ready.push_back( i);
+            }
+        }
+        for ( UInt32 cycle = 0; order.size() < n; cycle++)
+        {
+            bool issued = true;
+
+            /* Repeat while something issues since zero latency successors may issue in the same cycle */
+            while ( issued)
+            {
+                issued = false;
+                sort( ready.begin(), ready.end(), priority);
+                for ( UInt32 k = 0; k < ready.size(); k++)
+                {
+                    UInt32 i = ready[ k];
+                    const MDes::OperDes *des = opers[ i]->archDes();
+                    UInt32 *unit = NULL;
+
+                    if ( earliest[ i] > cycle)
+                        continue;
+
+                    if ( des->usesUnit() )
+                    {
+                        vector< UInt32> &units = unit_free[ des->unit];
+
+                        for ( UInt32 j = 0; j < units.size() && isNullP( unit); j++)
+                        {
+                            if ( units[ j] <= cycle)
+                                unit = &units[ j];
+                        }
+                        if ( isNullP( unit) && !units.empty() )
+                            continue;
+                    }
+                    if ( isNotNullP( unit) )
+                    {
+                        *unit = cycle + des->busy;
+                    }
+                    order.push_back( opers[ i]);
+                    ready.erase( ready.begin() + k);
+                    k--;
+                    issued = true;
+
+                    for ( DepEdge *e = opers[ i]->firstSucc(); isNotNullP( e); e = e->nextSucc())
+                    {
+                        if ( !e->succ()->isNumbered( index) )
+                            continue;
+
+                        UInt32 s = e->succ()->number( index);
+
+                        earliest[ s] = max< UInt32>( earliest[ s], cycle + e->latency());
+                        if ( --preds_left[ s] == 0)
+                        {
+                            ready.push_back( s);
+                        }
+                    }
+                }
+            }
+        }
+        f->freeNum( index);
+
+        if ( order == opers )
+            return false;
+
+        relink( f, node, order, cf_oper, opers[ 0]->prevOper(), opers[ n - 1]->nextOper());
+        return true;
+    }
+
+    /** Build the dependence graph of the function and schedule every CF node */
+    bool schedule( Function *f)
+    {
+        bool changed = false;
+
+        buildDeps( f);
+        for ( CFNode *node = f->cfg().firstNode(); isNotNullP( node); node = node->nextNode())
+        {
+            changed |= scheduleNode( f, node);
+        }
+        return changed;
+    }
+}
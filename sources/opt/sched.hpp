@@ -0,0 +1,23 @@
+/**
+ * @file: opt/sched.hpp
+ * List scheduling of optimizer's IR
+ * @ingroup OPT
+ */
+ /*
+  * Copyright 2012 MIPT-COMPILER team
+  */
+#pragma once
+
+namespace Opt
+{
+    /**
+     * Reorder the operations of the node by critical path list scheduling. Every cycle the ready
+     * operations are issued in the order of their distance to the end of the node as long as their
+     * functional units are free. Leading phis and the trailing control flow operation or return stay in place.
+     * The dependence edges of the node must be built. Returns true if the order is changed
+     */
+    bool scheduleNode( Function *f, CFNode *node);
+
+    /** Build the dependence graph of the function and schedule every CF node, returns true if any order is changed */
+    bool schedule( Function *f);
+}
@@ -0,0 +1,523 @@
+/**
+ * @file: opt/ssa.cpp
+ * Implementation of SSA form construction and destruction
+ * @ingroup OPT
+ */
+ /*
+  * Copyright 2012 MIPT-COMPILER team
+  */
+#include "opt_iface.hpp"
+
+namespace Opt
+{
+    typedef IR::Operation< MDes> Operation;
+
+    /** Pair of destination and source objects of a copy */
+    typedef pair< Obj *, Obj *> Copy;
+
+    /** Stamp of the node that is not visited for any object */
+    const UInt32 SSA_NO_STAMP = (UInt32)-1;
+
+    /** Get the index of the edge among the predecessors of its successor node */
+    static UInt32 predIndex( CFEdge *edge)
+    {
+        UInt32 i = 0;
+
+        for ( CFEdge *e = edge->succ()->firstPred(); !areEqP( e, edge); e = e->nextPred())
+        {
+            i++;
+        }
+        return i;
+    }
+
+    /** Create operation and add it to the end of the node right after the given operation in the sequence */
+    static Oper *newOperInNode( Function *f, CFNode *node, OptOperName name, Operation *prev)
+    {
+        Oper *oper = NULL;
+
+        if ( isNullP( prev))
+        {
+            oper = f->newOper( name);
+            node->append( oper);
+        } else
+        {
+            oper = f->newOperAfter( name, static_cast< Oper *>( prev));
+            node->extend( oper);
+        }
+        return oper;
+    }
+
+    /** Place phi operation for the object in the node, the phi gets an argument for every predecessor */
+    static void placePhi( Function *f, CFNode *node, Obj *obj)
+    {
+        Oper *phi = NULL;
+
+        if ( isNotNullP( node->firstOper()) )
+        {
+            phi = f->newOperBefore( Phi, node->firstOper());
+        } else
+        {
+            phi = f->newOper( Phi);
+            node->append( phi);
+        }
+        phi->setResObj( 0, obj);
+        for ( CFEdge *e = node->firstPred(); isNotNullP( e); e = e->nextPred())
+        {
+            phi->addArgToSet( obj);
+        }
+    }
+
+    /** Get the current SSA name of the object */
+    static Obj *topName( map< Obj *, vector< Obj *> > &stacks, Obj *obj)
+    {
+        map< Obj *, vector< Obj *> >::iterator it = stacks.find( obj);
+
+        if ( it == stacks.end() || it->second.empty() )
+        {
+            return obj;
+        }
+        return it->second.back();
+    }
+
+    /** Give new names to the definitions of the node and rename the uses, fill phi arguments of the successors */
+    static void renameNode( Function *f, CFNode *node, map< Obj *, vector< Obj *> > &stacks, vector< Obj *> &log)
+    {
+        for ( Operation *oper = node->firstOper(); isNotNullP( oper); oper = oper->nextInNode())
+        {
+            /* Uses, phi arguments are renamed from the predecessors */
+            if ( !isPhi( oper) )
+            {
+                for ( UInt32 i = 0; i < oper->numArgs(); i++)
+                {
+                    if ( oper->arg( i).type() == OP_TYPE_OBJ )
+                    {
+                        oper->setArgObj( i, topName( stacks, oper->arg( i).object()));
+                    }
+                }
+                for ( UInt32 i = 0; i < oper->numArgsInSet(); i++)
+                {
+                    if ( oper->argInSet( i).type() == OP_TYPE_OBJ )
+                    {
+                        oper->setArgObjInSet( i, topName( stacks, oper->argInSet( i).object()));
+                    }
+                }
+            }
+
+            /* Definitions */
+            for ( UInt32 i = 0; i < oper->numRess(); i++)
+            {
+                if ( oper->res( i).type() == OP_TYPE_OBJ )
+                {
+                    Obj *obj = oper->res( i).object();
+                    Obj *name = f->newObject( obj->type());
+
+                    stacks[ obj].push_back( name);
+                    log.push_back( obj);
+                    oper->setResObj( i, name);
+                }
+            }
+            for ( UInt32 i = 0; i < oper->numRessInSet(); i++)
+            {
+                Obj *obj = oper->resInSet( i).object();
+                Obj *name = f->newObject( obj->type());
+
+                stacks[ obj].push_back( name);
+                log.push_back( obj);
+                oper->setResObjInSet( i, name);
+            }
+        }
+
+        /* Arguments of the successors' phis that correspond to the edges from this node */
+        for ( CFEdge *e = node->firstSucc(); isNotNullP( e); e = e->nextSucc())
+        {
+            UInt32 j = predIndex( e);
+
+            for ( Operation *phi = e->succ()->firstOper(); isPhi( phi); phi = phi->nextInNode())
+            {
+                phi->setArgObjInSet( j, topName( stacks, phi->argInSet( j).object()));
+            }
+        }
+    }
+
+    /**
+     * Translate the function into pruned SSA form.
+     *
+     * For every defined object the nodes where it is live on entry are found by walking
+     * backwards from its upward exposed uses up to its definitions, the def-use lists of the object
+     * give the starting points. Phis are placed in the iterated dominance frontier of the
+     * definitions where the object is live. So the work for an object is proportional to its
+     * definitions, uses and live range rather than to the size of the function.
+     */
+    bool buildSSA( Function *f)
+    {
+        DomTree dom( &f->cfg());
+
+        return buildSSA( f, dom);
+    }
+
+    /** Translate the function into pruned SSA form using the given dominator tree of its CFG */
+    bool buildSSA( Function *f, const DomTree &dom)
+    {
+        CFG &cfg = f->cfg();
+        UInt32 n = dom.numNodes();
+        Numeration pos = f->newNum();
+        map< Obj *, UInt32> var_index;
+        vector< Obj *> vars;
+
+        /* Number the operations within their nodes and collect the defined objects */
+        for ( UInt32 b = 0; b < n; b++)
+        {
+            GraphNum p = 0;
+
+            for ( Operation *oper = dom.node( b)->firstOper(); isNotNullP( oper); oper = oper->nextInNode())
+            {
+                oper->setNumber( pos, p++);
+                for ( UInt32 i = 0; i < oper->numRess(); i++)
+                {
+                    if ( oper->res( i).type() == OP_TYPE_OBJ && var_index.find( oper->res( i).object()) == var_index.end() )
+                    {
+                        var_index[ oper->res( i).object()] = (UInt32)vars.size();
+                        vars.push_back( oper->res( i).object());
+                    }
+                }
+                for ( UInt32 i = 0; i < oper->numRessInSet(); i++)
+                {
+                    if ( var_index.find( oper->resInSet( i).object()) == var_index.end() )
+                    {
+                        var_index[ oper->resInSet( i).object()] = (UInt32)vars.size();
+                        vars.push_back( oper->resInSet( i).object());
+                    }
+                }
+            }
+        }
+
+        /* Per node stamps are equal to the index of the object the node was last visited for */
+        vector< UInt32> def_stamp( n, SSA_NO_STAMP);
+        vector< UInt32> live_stamp( n, SSA_NO_STAMP);
+        vector< UInt32> phi_stamp( n, SSA_NO_STAMP);
+        vector< UInt32> work_stamp( n, SSA_NO_STAMP);
+        vector< GraphNum> first_def( n);
+        vector< CFNode *> worklist;
+
+        for ( UInt32 k = 0; k < vars.size(); k++)
+        {
+            Obj *obj = vars[ k];
+
+            /* Nodes with definitions and position of the first definition in them */
+            for ( UInt32 i = 0; i < obj->numDefs(); i++)
+            {
+                CFNode *node = obj->defs()[ i].oper->node();
+
+                if ( isNullP( node) || !dom.isReachable( node) )
+                    continue;
+
+                UInt32 b = dom.num( node);
+                GraphNum p = obj->defs()[ i].oper->number( pos);
+
+                if ( def_stamp[ b] != k )
+                {
+                    def_stamp[ b] = k;
+                    first_def[ b] = p;
+                } else if ( p < first_def[ b])
+                {
+                    first_def[ b] = p;
+                }
+            }
+
+            /* Live-in nodes, start from the nodes with upward exposed uses */
+            for ( UInt32 i = 0; i < obj->numUses(); i++)
+            {
+                CFNode *node = obj->uses()[ i].oper->node();
+
+                if ( isNullP( node) || !dom.isReachable( node) )
+                    continue;
+
+                UInt32 b = dom.num( node);
+
+                /* Arguments are read before results are written, so a use in the defining operation is exposed */
+                if ( ( def_stamp[ b] != k || first_def[ b] >= obj->uses()[ i].oper->number( pos))
+                     && live_stamp[ b] != k )
+                {
+                    live_stamp[ b] = k;
+                    worklist.push_back( node);
+                }
+            }
+            while ( !worklist.empty() )
+            {
+                CFNode *node = worklist.back();
+
+                worklist.pop_back();
+                for ( CFEdge *e = node->firstPred(); isNotNullP( e); e = e->nextPred())
+                {
+                    if ( !dom.isReachable( e->pred()) )
+                        continue;
+
+                    UInt32 b = dom.num( e->pred());
+
+                    if ( live_stamp[ b] != k && def_stamp[ b] != k )
+                    {
+                        live_stamp[ b] = k;
+                        worklist.push_back( e->pred());
+                    }
+                }
+            }
+
+            /* Phis in the iterated dominance frontier of the definitions */
+            for ( UInt32 b = 0; b < n; b++)
+            {
+                if ( def_stamp[ b] == k )
+                {
+                    work_stamp[ b] = k;
+                    worklist.push_back( dom.node( b));
+                }
+            }
+            while ( !worklist.empty() )
+            {
+                CFNode *node = worklist.back();
+
+                worklist.pop_back();
+                for ( UInt32 i = 0; i < dom.frontier( node).size(); i++)
+                {
+                    CFNode *y = dom.frontier( node)[ i];
+                    UInt32 b = dom.num( y);
+
+                    if ( phi_stamp[ b] == k )
+                        continue;
+
+                    phi_stamp[ b] = k;
+                    if ( live_stamp[ b] == k )
+                    {
+                        placePhi( f, y, obj);
+                    }
+                    if ( work_stamp[ b] != k )
+                    {
+                        work_stamp[ b] = k;
+                        worklist.push_back( y);
+                    }
+                }
+            }
+        }
+        f->freeNum( pos);
+
+        /* Renaming in the preorder walk of the dominator tree */
+        map< Obj *, vector< Obj *> > stacks;
+        vector< Obj *> log;
+        vector< pair< CFNode *, UInt32> > walk;
+        vector< size_t> log_sizes;
+
+        walk.push_back( make_pair( cfg.startNode(), 0U));
+        log_sizes.push_back( log.size());
+        renameNode( f, cfg.startNode(), stacks, log);
+        while ( !walk.empty() )
+        {
+            CFNode *node = walk.back().first;
+            UInt32 k = walk.back().second;
+
+            if ( k < dom.children( node).size() )
+            {
+                CFNode *kid = dom.children( node)[ k];
+
+                walk.back().second++;
+                walk.push_back( make_pair( kid, 0U));
+                log_sizes.push_back( log.size());
+                renameNode( f, kid, stacks, log);
+            } else
+            {
+                /* Names defined in the subtree go out of scope */
+                while ( log.size() > log_sizes.back() )
+                {
+                    stacks[ log.back()].pop_back();
+                    log.pop_back();
+                }
+                log_sizes.pop_back();
+                walk.pop_back();
+            }
+        }
+        /* Every definition got a new object */
+        return !vars.empty();
+    }
+
+    /**
+     * Order the parallel copy so that no source is overwritten before it is read.
+     * A copy whose destination is not a source of other copies can go first, if there is no
+     * such copy then the rest are cycles and one destination is saved to a new temporary object
+     */
+    static void sequentializeCopies( Function *f, vector< Copy> copies, vector< Copy> &seq)
+    {
+        while ( !copies.empty() )
+        {
+            bool found = false;
+
+            for ( UInt32 i = 0; i < copies.size() && !found; i++)
+            {
+                bool is_source = false;
+
+                for ( UInt32 j = 0; j < copies.size(); j++)
+                {
+                    if ( areEqP( copies[ j].second, copies[ i].first) )
+                    {
+                        is_source = true;
+                        break;
+                    }
+                }
+                if ( !is_source)
+                {
+                    seq.push_back( copies[ i]);
+                    copies.erase( copies.begin() + i);
+                    found = true;
+                }
+            }
+            if ( !found)
+            {
+                /* Break the cycle */
+                Obj *dst = copies[ 0].first;
+                Obj *tmp = f->newObject( dst->type());
+
+                seq.push_back( make_pair( tmp, dst));
+                for ( UInt32 j = 0; j < copies.size(); j++)
+                {
+                    if ( areEqP( copies[ j].second, dst) )
+                    {
+                        copies[ j].second = tmp;
+                    }
+                }
+            }
+        }
+    }
+
+    /** Emit the copies of the edge as moves, split the edge if it is critical */
+    static void emitCopies( Function *f, CFEdge *edge, const vector< Copy> &copies)
+    {
+        vector< Copy> parallel;
+        vector< Copy> seq;
+
+        for ( UInt32 i = 0; i < copies.size(); i++)
+        {
+            if ( !areEqP( copies[ i].first, copies[ i].second) )
+            {
+                parallel.push_back( copies[ i]);
+            }
+        }
+        if ( parallel.empty() )
+            return;
+
+        sequentializeCopies( f, parallel, seq);
+
+        CFNode *pred = edge->pred();
+        CFNode *succ = edge->succ();
+        CFNode *node = pred;
+        Operation *before = NULL; /* Moves go before this operation ... */
+        Operation *after = NULL;  /* ... or after this one in the sequence */
+        Operation *jump = NULL;   /* Jump of the predecessor to retarget to the new node */
+
+        if ( isNullP( pred->firstSucc()->nextSucc()) )
+        {
+            /* The only successor, moves go to the end of the predecessor before its jump */
+            Operation *last = pred->lastOper();
+
+            if ( isNotNullP( last) && static_cast< Oper *>( last)->isCf() )
+            {
+                before = last;
+            } else
+            {
+                after = last;
+            }
+        } else
+        {
+            /* Critical edge */
+            jump = edge->srcOper();
+            node = edge->insertNode();
+            if ( isNotNullP( jump))
+            {
+                /* The new node goes to the end of the sequence and jumps back to the successor */
+                after = f->firstOper();
+                while ( isNotNullP( after->nextOper()) )
+                {
+                    after = after->nextOper();
+                }
+            } else
+            {
+                /* The new node falls through to the successor */
+                after = pred->lastOper();
+            }
+        }
+
+        for ( UInt32 i = 0; i < seq.size(); i++)
+        {
+            Oper *mov = NULL;
+
+            if ( isNotNullP( before) )
+            {
+                mov = f->newOperBefore( Mov, before);
+            } else
+            {
+                mov = newOperInNode( f, node, Mov, after);
+                after = mov;
+            }
+            mov->setArgObj( 0, seq[ i].second);
+            mov->setResObj( 0, seq[ i].first);
+        }
+
+        if ( isNotNullP( jump) )
+        {
+            IR_ASSERTXD( isNotNullP( succ->firstOper()), "Jump target node has no operations");
+
+            Oper *br = newOperInNode( f, node, Br, after);
+
+            br->setArgTarget( 0, succ->firstOper());
+            node->firstSucc()->setSrcOper( br);
+            for ( UInt32 i = 0; i < jump->numArgs(); i++)
+            {
+                if ( jump->arg( i).isTarget() )
+                {
+                    jump->setArgTarget( i, node->firstOper());
+                }
+            }
+        }
+    }
+
+    /** Replace phi operations with moves in the predecessor nodes */
+    bool translateOutOfSSA( Function *f)
+    {
+        CFG &cfg = f->cfg();
+        vector< CFNode *> joins;
+
+        for ( CFNode *node = cfg.firstNode(); isNotNullP( node); node = node->nextNode())
+        {
+            if ( isPhi( node->firstOper()) )
+            {
+                joins.push_back( node);
+            }
+        }
+        for ( UInt32 k = 0; k < joins.size(); k++)
+        {
+            CFNode *node = joins[ k];
+            vector< CFEdge *> preds;
+
+            for ( CFEdge *e = node->firstPred(); isNotNullP( e); e = e->nextPred())
+            {
+                preds.push_back( e);
+            }
+
+            /* Copies of every edge form one parallel copy */
+            vector< vector< Copy> > copies( preds.size());
+
+            while ( isPhi( node->firstOper()) )
+            {
+                Operation *phi = node->firstOper();
+
+                IR_ASSERTD( phi->numArgsInSet() == preds.size());
+                for ( UInt32 j = 0; j < phi->numArgsInSet(); j++)
+                {
+                    copies[ j].push_back( make_pair( phi->res( 0).object(), phi->argInSet( j).object()));
+                }
+                f->deleteOper( phi);
+            }
+            for ( UInt32 j = 0; j < preds.size(); j++)
+            {
+                emitCopies( f, preds[ j], copies[ j]);
+            }
+        }
+        return !joins.empty();
+    }
+}
@@ -0,0 +1,37 @@
+/**
+ * @file: opt/ssa.hpp
+ * Construction and destruction of SSA form of optimizer's IR
+ * @ingroup OPT
+ */
+ /*
+  * Copyright 2012 MIPT-COMPILER team
+  */
+#pragma once
+
+namespace Opt
+{
+    /**
+     * Translate the function into pruned SSA form. Phi operations are placed in the iterated
+     * dominance frontiers of the objects' definitions where the objects are live, and then every
+     * definition gets its own object. The arguments of phi operation go in the order of the node's
+     * predecessor edges. The CFG of the function must be valid. Returns true if the function is changed,
+     * that is if it defines any object
+     */
+    bool buildSSA( Function *f);
+
+    /** Translate the function into pruned SSA form using the given dominator tree of its CFG */
+    bool buildSSA( Function *f, const DomTree &dom);
+
+    /**
+     * Replace phi operations with moves in the predecessor nodes. Moves of one edge form a
+     * parallel copy that is sequentialized with a temporary object for every cycle. Critical
+     * edges are split by new nodes. Returns true if the function had phis
+     */
+    bool translateOutOfSSA( Function *f);
+
+    /** Check that the operation is phi */
+    inline bool isPhi( IR::Operation< MDes> *oper)
+    {
+        return isNotNullP( oper) && oper->name() == Phi;
+    }
+}
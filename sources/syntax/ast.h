@@ -6,6 +6,9 @@
 
 #pragma once
 
+#if defined(_MSC_VER)
+#  include <intrin.h>
+#endif
 
 namespace Syntax
 {
@@ -64,10 +67,14 @@ namespace Syntax
             }
             return *this;
         }
-        /** Create unique id for the newly created node */
+        /** Create unique id for the newly created node, the ids stay unique when trees are built in parallel */
         UInt32 makeNewId()
         {
-            return next_id++;
+#if defined(_MSC_VER)
+            return (UInt32)_InterlockedIncrement( reinterpret_cast< volatile long *>( &next_id)) - 1;
+#else
+            return __sync_fetch_and_add( &next_id, 1);
+#endif
         }
 
         /* Tree implementation data */
@@ -76,14 +83,14 @@ namespace Syntax
 
         /* Debug info */
         UInt32 id_;
-        static UInt32 next_id;
+        static volatile UInt32 next_id;
 
         /* Saved token */
         Token token_;
     };
     
     //Definition for the next_id field
-    template <class Token> UInt32 ASTNode<Token>::next_id = 0;
+    template <class Token> volatile UInt32 ASTNode<Token>::next_id = 0;
 
     /**
      * AST Visitor base class